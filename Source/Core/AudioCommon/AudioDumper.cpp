@@ -0,0 +1,116 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AudioCommon/AudioDumper.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "AudioCommon/WaveFile.h"
+
+namespace AudioCommon
+{
+AudioDumper::AudioDumper() = default;
+
+AudioDumper::~AudioDumper()
+{
+  Stop();
+}
+
+bool AudioDumper::Start(const std::string& filename, u32 sample_rate)
+{
+  if (m_running)
+    return false;
+
+  auto writer = std::make_unique<WaveFileWriter>();
+  if (!writer->Start(filename, sample_rate))
+    return false;
+  writer->SetSkipSilence(false);
+
+  if (!m_writer_thread_started)
+  {
+    m_writer_thread.Reset([this](WriterCommand command) { HandleCommand(std::move(command)); });
+    m_writer_thread_started = true;
+  }
+
+  WriterCommand command;
+  command.writer = std::move(writer);
+  m_writer_thread.EmplaceItem(std::move(command));
+
+  m_pending_samples.reserve(CHUNK_SIZE * 2);
+  m_pending_sample_rate = sample_rate;
+  m_running = true;
+  return true;
+}
+
+void AudioDumper::Stop()
+{
+  if (!m_running)
+    return;
+
+  m_running = false;
+
+  WriterCommand command;
+  command.samples = std::move(m_pending_samples);
+  command.sample_rate = m_pending_sample_rate;
+  command.stop = true;
+  m_writer_thread.EmplaceItem(std::move(command));
+
+  m_pending_samples = {};
+}
+
+void AudioDumper::AddStereoSamplesBE(const short* samples, u32 num_samples, u32 sample_rate)
+{
+  if (!m_running)
+    return;
+
+  // All samples in a chunk have to have the same rate, since the writer starts a new file when
+  // the rate changes
+  if (sample_rate != m_pending_sample_rate)
+  {
+    Flush();
+    m_pending_sample_rate = sample_rate;
+  }
+
+  m_pending_samples.insert(m_pending_samples.end(), samples, samples + num_samples * 2);
+
+  if (m_pending_samples.size() >= CHUNK_SIZE * 2)
+    Flush();
+}
+
+void AudioDumper::Flush()
+{
+  if (m_pending_samples.empty())
+    return;
+
+  WriterCommand command;
+  command.samples = std::move(m_pending_samples);
+  command.sample_rate = m_pending_sample_rate;
+  m_writer_thread.EmplaceItem(std::move(command));
+
+  m_pending_samples = {};
+  m_pending_samples.reserve(CHUNK_SIZE * 2);
+}
+
+void AudioDumper::HandleCommand(WriterCommand command)
+{
+  if (command.writer)
+    m_writer = std::move(command.writer);
+
+  if (!m_writer)
+    return;
+
+  // WaveFileWriter converts the samples in a fixed size buffer, so don't pass it too many at once
+  const u32 num_samples = static_cast<u32>(command.samples.size() / 2);
+  for (u32 i = 0; i < num_samples; i += CHUNK_SIZE)
+  {
+    const u32 count = std::min(num_samples - i, CHUNK_SIZE);
+    m_writer->AddStereoSamplesBE(command.samples.data() + i * 2, count,
+                                 static_cast<int>(command.sample_rate));
+  }
+
+  // Destroying the writer finishes the file
+  if (command.stop)
+    m_writer.reset();
+}
+}  // namespace AudioCommon
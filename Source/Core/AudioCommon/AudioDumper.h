@@ -0,0 +1,71 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/WorkQueueThread.h"
+
+class WaveFileWriter;
+
+namespace AudioCommon
+{
+// Dumps a stream of audio to WAV files, which are written on a separate thread.
+//
+// The samples are taken from the emulated hardware as it produces them, not from what the sound
+// backend plays. A dump therefore follows emulated time: it contains every sample no matter how
+// fast emulation runs, which keeps it in sync with frame dumps, and neither audio stretching nor
+// a backend which falls behind affect it. Samples are collected into large chunks before they are
+// handed to the writer thread, so all the emulation thread has to do is copy them.
+class AudioDumper
+{
+public:
+  AudioDumper();
+  ~AudioDumper();
+
+  AudioDumper(const AudioDumper&) = delete;
+  AudioDumper& operator=(const AudioDumper&) = delete;
+  AudioDumper(AudioDumper&&) = delete;
+  AudioDumper& operator=(AudioDumper&&) = delete;
+
+  // Start and Stop must be called from the thread which adds the samples. The file is created
+  // by Start, so failures are reported right away.
+  bool Start(const std::string& filename, u32 sample_rate);
+  void Stop();
+  bool IsRunning() const { return m_running; }
+
+  // Big endian stereo samples, as sent by the emulated hardware.
+  void AddStereoSamplesBE(const short* samples, u32 num_samples, u32 sample_rate);
+
+private:
+  struct WriterCommand
+  {
+    // If set, the writer thread switches to this file before writing the samples
+    std::unique_ptr<WaveFileWriter> writer;
+    std::vector<short> samples;
+    u32 sample_rate = 0;
+    // If set, the writer thread closes the file after writing the samples
+    bool stop = false;
+  };
+
+  void Flush();
+  void HandleCommand(WriterCommand command);
+
+  // In stereo samples (about a quarter of a second)
+  static constexpr u32 CHUNK_SIZE = 8192;
+
+  bool m_running = false;
+  std::vector<short> m_pending_samples;
+  u32 m_pending_sample_rate = 0;
+
+  // Only accessed on the writer thread
+  std::unique_ptr<WaveFileWriter> m_writer;
+
+  Common::WorkQueueThread<WriterCommand> m_writer_thread;
+  bool m_writer_thread_started = false;
+};
+}  // namespace AudioCommon
@@ -10,6 +10,7 @@
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
@@ -51,30 +52,100 @@ void Mixer::DoState(PointerWrap& p)
     mixer.DoState(p);
 }
 
-// Executed from sound stream thread
-unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
-                                   bool consider_framelimit)
+namespace
 {
-  unsigned int currentSample = 0;
+constexpr size_t MAX_MIX_INPUTS = 8;
 
-  // Cache access in non-volatile variable
-  // This is the only function changing the read value, so it's safe to
-  // cache it locally although it's written here.
-  // The writing pointer will be modified outside, but it will only increase,
-  // so we will just ignore new written data while interpolating.
-  // Without this cache, the compiler wouldn't be allowed to optimize the
-  // interpolation loop.
-  u32 indexR = m_indexR.load();
-  u32 indexW = m_indexW.load();
+struct MixInput
+{
+  const short* samples;
+  // Even samples are right, odd samples are left
+  s32 rvolume;
+  s32 lvolume;
+};
 
-  // render numleft sample pairs to samples[]
-  // advance indexR with sample position
-  // remember fractional offset
+s16 Interpolate(s32 current, s32 next, u32 frac)
+{
+  return static_cast<s16>(((current << 16) + (next - current) * static_cast<s32>(frac)) >> 16);
+}
+
+#ifdef _M_X86
+// SSE2 has no 32-bit multiplication which keeps the low half of the products.
+__m128i MultiplyLow32(__m128i a, __m128i b)
+{
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Same as Interpolate for four samples at a time.
+__m128i Interpolate(__m128i current, __m128i next, __m128i frac)
+{
+  const __m128i delta = MultiplyLow32(_mm_sub_epi32(next, current), frac);
+  return _mm_srai_epi32(_mm_add_epi32(_mm_slli_epi32(current, 16), delta), 16);
+}
+#endif
+
+// Adds up the inputs, scaled by their volume, and writes the clamped result to samples.
+void MixBlock(short* samples, unsigned int num_samples, const MixInput* inputs, size_t num_inputs)
+{
+  unsigned int i = 0;
 
+#ifdef _M_X86
+  __m128i volumes[MAX_MIX_INPUTS];
+  for (size_t j = 0; j < num_inputs; ++j)
+  {
+    const s16 r = static_cast<s16>(inputs[j].rvolume);
+    const s16 l = static_cast<s16>(inputs[j].lvolume);
+    volumes[j] = _mm_setr_epi16(r, l, r, l, r, l, r, l);
+  }
+
+  const __m128i min_sample = _mm_set1_epi16(-32767);
+  for (; i + 4 <= num_samples; i += 4)
+  {
+    __m128i sum_lo = _mm_setzero_si128();
+    __m128i sum_hi = _mm_setzero_si128();
+    for (size_t j = 0; j < num_inputs; ++j)
+    {
+      const __m128i input =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(inputs[j].samples + i * 2));
+      const __m128i lo = _mm_mullo_epi16(input, volumes[j]);
+      const __m128i hi = _mm_mulhi_epi16(input, volumes[j]);
+      sum_lo = _mm_add_epi32(sum_lo, _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 8));
+      sum_hi = _mm_add_epi32(sum_hi, _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 8));
+    }
+
+    // packs saturates to -32768, but the output range is symmetric.
+    const __m128i result = _mm_max_epi16(_mm_packs_epi32(sum_lo, sum_hi), min_sample);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i * 2), result);
+  }
+#endif
+
+  for (; i < num_samples; ++i)
+  {
+    s32 sample_r = 0;
+    s32 sample_l = 0;
+    for (size_t j = 0; j < num_inputs; ++j)
+    {
+      sample_r += (inputs[j].samples[i * 2] * inputs[j].rvolume) >> 8;
+      sample_l += (inputs[j].samples[i * 2 + 1] * inputs[j].lvolume) >> 8;
+    }
+    samples[i * 2] = std::clamp(sample_r, -32767, 32767);
+    samples[i * 2 + 1] = std::clamp(sample_l, -32767, 32767);
+  }
+}
+}  // namespace
+
+// Executed from sound stream thread
+void Mixer::MixerFifo::BeginMix(bool consider_framelimit)
+{
   float emulationspeed = SConfig::GetInstance().m_EmulationSpeed;
   float aid_sample_rate = static_cast<float>(m_input_sample_rate);
   if (consider_framelimit && emulationspeed > 0.0f)
   {
+    const u32 indexR = m_indexR.load(std::memory_order_relaxed);
+    const u32 indexW = m_indexW.load(std::memory_order_acquire);
     float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
 
     u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
@@ -90,82 +161,178 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
     aid_sample_rate = (aid_sample_rate + offset) * emulationspeed;
   }
 
-  const u32 ratio = (u32)(65536.0f * aid_sample_rate / (float)m_mixer->m_sampleRate);
+  m_ratio = (u32)(65536.0f * aid_sample_rate / (float)m_mixer->m_sampleRate);
 
-  s32 lvolume = m_LVolume.load();
-  s32 rvolume = m_RVolume.load();
+  m_mix_lvolume = m_LVolume.load(std::memory_order_relaxed);
+  m_mix_rvolume = m_RVolume.load(std::memory_order_relaxed);
+}
 
-  const auto read_buffer = [this](auto index) {
-    return m_little_endian ? m_buffer[index] : Common::swap16(m_buffer[index]);
+// Executed from sound stream thread
+unsigned int Mixer::MixerFifo::Resample(short* samples, unsigned int num_samples)
+{
+  // Cache access in non-volatile variable
+  // This is the only function changing the read value, so it's safe to
+  // cache it locally although it's written here.
+  // The writing pointer will be modified outside, but it will only increase,
+  // so we will just ignore new written data while interpolating.
+  // Without this cache, the compiler wouldn't be allowed to optimize the
+  // interpolation loop.
+  const u32 indexR = m_indexR.load(std::memory_order_relaxed);
+  const u32 indexW = m_indexW.load(std::memory_order_acquire);
+
+  if (m_little_endian)
+    return Resample<true>(samples, num_samples, indexR, indexW);
+  else
+    return Resample<false>(samples, num_samples, indexR, indexW);
+}
+
+template <bool little_endian>
+unsigned int Mixer::MixerFifo::Resample(short* samples, unsigned int num_samples, u32 indexR,
+                                        u32 indexW)
+{
+  const auto read_buffer = [this](u32 index) -> s32 {
+    const s16 sample = m_buffer[index & INDEX_MASK];
+    return little_endian ? sample : static_cast<s16>(Common::swap16(sample));
   };
 
+  // render numleft sample pairs to samples[]
+  // advance indexR with sample position
+  // remember fractional offset
+  const u32 ratio = m_ratio;
+  u32 frac = m_frac;
+  unsigned int currentSample = 0;
+
   // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+#ifdef _M_X86
+  for (; currentSample + 4 <= num_samples; currentSample += 4)
+  {
+    // Positions of the next four samples, relative to indexR
+    std::array<u32, 5> offsets;
+    std::array<u32, 4> fracs;
+    u32 next_frac = frac;
+    offsets[0] = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+      fracs[i] = next_frac;
+      next_frac += ratio;
+      offsets[i + 1] = offsets[i] + 2 * (u16)(next_frac >> 16);
+      next_frac &= 0xffff;
+    }
+
+    // Leave the rest to the scalar loop if we'd run out of samples in the middle
+    if (((indexW - indexR) & INDEX_MASK) <= offsets[3] + 2)
+      break;
+
+    __m128i results[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+      const u32 index0 = indexR + offsets[i * 2];
+      const u32 index1 = indexR + offsets[i * 2 + 1];
+      const __m128i current =
+          _mm_setr_epi32(read_buffer(index0 + 1), read_buffer(index0), read_buffer(index1 + 1),
+                         read_buffer(index1));
+      const __m128i next =
+          _mm_setr_epi32(read_buffer(index0 + 3), read_buffer(index0 + 2), read_buffer(index1 + 3),
+                         read_buffer(index1 + 2));
+      const __m128i fracs_vector =
+          _mm_setr_epi32(fracs[i * 2], fracs[i * 2], fracs[i * 2 + 1], fracs[i * 2 + 1]);
+      results[i] = Interpolate(current, next, fracs_vector);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + currentSample * 2),
+                     _mm_packs_epi32(results[0], results[1]));
+
+    indexR += offsets[4];
+    frac = next_frac;
+  }
+#endif
+
+  for (; currentSample < num_samples && ((indexW - indexR) & INDEX_MASK) > 2; ++currentSample)
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = read_buffer(indexR & INDEX_MASK);   // current
-    s16 l2 = read_buffer(indexR2 & INDEX_MASK);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = std::clamp(sampleL, -32767, 32767);
-
-    s16 r1 = read_buffer((indexR + 1) & INDEX_MASK);   // current
-    s16 r2 = read_buffer((indexR2 + 1) & INDEX_MASK);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = std::clamp(sampleR, -32767, 32767);
-
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+    const s32 r1 = read_buffer(indexR + 1);  // current
+    const s32 r2 = read_buffer(indexR + 3);  // next
+    samples[currentSample * 2] = Interpolate(r1, r2, frac);
+
+    const s32 l1 = read_buffer(indexR);      // current
+    const s32 l2 = read_buffer(indexR + 2);  // next
+    samples[currentSample * 2 + 1] = Interpolate(l1, l2, frac);
+
+    frac += ratio;
+    indexR += 2 * (u16)(frac >> 16);
+    frac &= 0xffff;
   }
 
   // Actual number of samples written to the buffer without padding.
-  unsigned int actual_sample_count = currentSample / 2;
+  const unsigned int actual_sample_count = currentSample;
 
   // Padding
-  short s[2];
-  s[0] = read_buffer((indexR - 1) & INDEX_MASK);
-  s[1] = read_buffer((indexR - 2) & INDEX_MASK);
-  s[0] = (s[0] * rvolume) >> 8;
-  s[1] = (s[1] * lvolume) >> 8;
-  for (; currentSample < numSamples * 2; currentSample += 2)
+  const s16 padding_r = static_cast<s16>(read_buffer(indexR - 1));
+  const s16 padding_l = static_cast<s16>(read_buffer(indexR - 2));
+  for (; currentSample < num_samples; ++currentSample)
   {
-    int sampleR = std::clamp(s[0] + samples[currentSample + 0], -32767, 32767);
-    int sampleL = std::clamp(s[1] + samples[currentSample + 1], -32767, 32767);
-
-    samples[currentSample + 0] = sampleR;
-    samples[currentSample + 1] = sampleL;
+    samples[currentSample * 2] = padding_r;
+    samples[currentSample * 2 + 1] = padding_l;
   }
 
+  m_is_silent = (m_mix_lvolume == 0 && m_mix_rvolume == 0) ||
+                (actual_sample_count == 0 && padding_r == 0 && padding_l == 0);
+
   // Flush cached variable
-  m_indexR.store(indexR);
+  m_frac = frac;
+  m_indexR.store(indexR, std::memory_order_release);
 
   return actual_sample_count;
 }
 
+// Resamples all FIFOs and mixes them in the same pass, a block at a time so that the
+// intermediate buffers stay in the cache. FIFOs which are silent (usually the GBAs and the
+// Wii Remote speaker) are skipped.
+void Mixer::MixFifos(short* samples, unsigned int num_samples, bool consider_framelimit)
+{
+  const std::array<MixerFifo*, NUM_FIFOS> fifos{
+      &m_dma_mixer,      &m_streaming_mixer, &m_wiimote_speaker_mixer, &m_gba_mixers[0],
+      &m_gba_mixers[1], &m_gba_mixers[2],   &m_gba_mixers[3]};
+
+  static_assert(NUM_FIFOS <= MAX_MIX_INPUTS);
+  for (MixerFifo* fifo : fifos)
+    fifo->BeginMix(consider_framelimit);
+
+  bool underrun = false;
+  for (unsigned int offset = 0; offset < num_samples; offset += MIX_BLOCK_SIZE)
+  {
+    const unsigned int block_size = std::min(num_samples - offset, MIX_BLOCK_SIZE);
+
+    std::array<MixInput, NUM_FIFOS> inputs;
+    size_t num_inputs = 0;
+    for (size_t i = 0; i < NUM_FIFOS; ++i)
+    {
+      short* buffer = m_resample_buffers[i].data();
+      const unsigned int resampled = fifos[i]->Resample(buffer, block_size);
+      if (fifos[i] == &m_dma_mixer && resampled < block_size)
+        underrun = true;
+
+      if (!fifos[i]->IsSilent())
+        inputs[num_inputs++] = {buffer, fifos[i]->GetMixRVolume(), fifos[i]->GetMixLVolume()};
+    }
+
+    MixBlock(samples + offset * 2, block_size, inputs.data(), num_inputs);
+  }
+
+  if (underrun)
+    m_underrun_count.fetch_add(1, std::memory_order_relaxed);
+}
+
 unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 {
   if (!samples)
     return 0;
 
-  memset(samples, 0, num_samples * 2 * sizeof(short));
-
   if (Config::Get(Config::MAIN_AUDIO_STRETCH))
   {
     unsigned int available_samples =
         std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
+    available_samples = std::min(available_samples, MAX_SAMPLES);
 
-    m_scratch_buffer.fill(0);
-
-    m_dma_mixer.Mix(m_scratch_buffer.data(), available_samples, false);
-    m_streaming_mixer.Mix(m_scratch_buffer.data(), available_samples, false);
-    m_wiimote_speaker_mixer.Mix(m_scratch_buffer.data(), available_samples, false);
-    for (auto& mixer : m_gba_mixers)
-      mixer.Mix(m_scratch_buffer.data(), available_samples, false);
+    MixFifos(m_scratch_buffer.data(), available_samples, false);
 
     if (!m_is_stretching)
     {
@@ -177,11 +344,7 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
   }
   else
   {
-    m_dma_mixer.Mix(samples, num_samples, true);
-    m_streaming_mixer.Mix(samples, num_samples, true);
-    m_wiimote_speaker_mixer.Mix(samples, num_samples, true);
-    for (auto& mixer : m_gba_mixers)
-      mixer.Mix(samples, num_samples, true);
+    MixFifos(samples, num_samples, true);
     m_is_stretching = false;
   }
 
@@ -217,11 +380,12 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
   // Cache access in non-volatile variable
   // indexR isn't allowed to cache in the audio throttling loop as it
   // needs to get updates to not deadlock.
-  u32 indexW = m_indexW.load();
+  u32 indexW = m_indexW.load(std::memory_order_relaxed);
 
   // Check if we have enough free space
   // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+  if (num_samples * 2 + ((indexW - m_indexR.load(std::memory_order_acquire)) & INDEX_MASK) >=
+      MAX_SAMPLES * 2)
     return;
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
@@ -238,23 +402,23 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
     memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4);
   }
 
-  m_indexW.fetch_add(num_samples * 2);
+  m_indexW.store(indexW + num_samples * 2, std::memory_order_release);
 }
 
+// Executed from the emulation thread. Audio dumps are taken from here rather than from the
+// output of Mix so that they follow emulated time.
 void Mixer::PushSamples(const short* samples, unsigned int num_samples)
 {
   m_dma_mixer.PushSamples(samples, num_samples);
   int sample_rate = m_dma_mixer.GetInputSampleRate();
-  if (m_log_dsp_audio)
-    m_wave_writer_dsp.AddStereoSamplesBE(samples, num_samples, sample_rate);
+  m_dsp_dumper.AddStereoSamplesBE(samples, num_samples, sample_rate);
 }
 
 void Mixer::PushStreamingSamples(const short* samples, unsigned int num_samples)
 {
   m_streaming_mixer.PushSamples(samples, num_samples);
   int sample_rate = m_streaming_mixer.GetInputSampleRate();
-  if (m_log_dtk_audio)
-    m_wave_writer_dtk.AddStereoSamplesBE(samples, num_samples, sample_rate);
+  m_dtk_dumper.AddStereoSamplesBE(samples, num_samples, sample_rate);
 }
 
 void Mixer::PushWiimoteSpeakerSamples(const short* samples, unsigned int num_samples,
@@ -313,18 +477,14 @@ void Mixer::SetGBAVolume(int device_number, unsigned int lvolume, unsigned int r
 
 void Mixer::StartLogDTKAudio(const std::string& filename)
 {
-  if (!m_log_dtk_audio)
+  if (!m_dtk_dumper.IsRunning())
   {
-    bool success = m_wave_writer_dtk.Start(filename, m_streaming_mixer.GetInputSampleRate());
-    if (success)
+    if (m_dtk_dumper.Start(filename, m_streaming_mixer.GetInputSampleRate()))
     {
-      m_log_dtk_audio = true;
-      m_wave_writer_dtk.SetSkipSilence(false);
       NOTICE_LOG_FMT(AUDIO, "Starting DTK Audio logging");
     }
     else
     {
-      m_wave_writer_dtk.Stop();
       NOTICE_LOG_FMT(AUDIO, "Unable to start DTK Audio logging");
     }
   }
@@ -336,10 +496,9 @@ void Mixer::StartLogDTKAudio(const std::string& filename)
 
 void Mixer::StopLogDTKAudio()
 {
-  if (m_log_dtk_audio)
+  if (m_dtk_dumper.IsRunning())
   {
-    m_log_dtk_audio = false;
-    m_wave_writer_dtk.Stop();
+    m_dtk_dumper.Stop();
     NOTICE_LOG_FMT(AUDIO, "Stopping DTK Audio logging");
   }
   else
@@ -350,18 +509,14 @@ void Mixer::StopLogDTKAudio()
 
 void Mixer::StartLogDSPAudio(const std::string& filename)
 {
-  if (!m_log_dsp_audio)
+  if (!m_dsp_dumper.IsRunning())
   {
-    bool success = m_wave_writer_dsp.Start(filename, m_dma_mixer.GetInputSampleRate());
-    if (success)
+    if (m_dsp_dumper.Start(filename, m_dma_mixer.GetInputSampleRate()))
     {
-      m_log_dsp_audio = true;
-      m_wave_writer_dsp.SetSkipSilence(false);
       NOTICE_LOG_FMT(AUDIO, "Starting DSP Audio logging");
     }
     else
     {
-      m_wave_writer_dsp.Stop();
       NOTICE_LOG_FMT(AUDIO, "Unable to start DSP Audio logging");
     }
   }
@@ -373,10 +528,9 @@ void Mixer::StartLogDSPAudio(const std::string& filename)
 
 void Mixer::StopLogDSPAudio()
 {
-  if (m_log_dsp_audio)
+  if (m_dsp_dumper.IsRunning())
   {
-    m_log_dsp_audio = false;
-    m_wave_writer_dsp.Stop();
+    m_dsp_dumper.Stop();
     NOTICE_LOG_FMT(AUDIO, "Stopping DSP Audio logging");
   }
   else
@@ -410,8 +564,11 @@ void Mixer::MixerFifo::SetVolume(unsigned int lvolume, unsigned int rvolume)
 
 unsigned int Mixer::MixerFifo::AvailableSamples() const
 {
-  unsigned int samples_in_fifo = ((m_indexW.load() - m_indexR.load()) & INDEX_MASK) / 2;
+  unsigned int samples_in_fifo = ((m_indexW.load(std::memory_order_acquire) -
+                                   m_indexR.load(std::memory_order_acquire)) &
+                                  INDEX_MASK) /
+                                 2;
   if (samples_in_fifo <= 1)
-    return 0;  // Mixer::MixerFifo::Mix always keeps one sample in the buffer.
+    return 0;  // Mixer::MixerFifo::Resample always keeps one sample in the buffer.
   return (samples_in_fifo - 1) * m_mixer->m_sampleRate / m_input_sample_rate;
 }
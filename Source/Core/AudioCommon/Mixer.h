@@ -6,9 +6,9 @@
 #include <array>
 #include <atomic>
 
+#include "AudioCommon/AudioDumper.h"
 #include "AudioCommon/AudioStretcher.h"
 #include "AudioCommon/SurroundDecoder.h"
-#include "AudioCommon/WaveFile.h"
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -51,12 +51,21 @@ public:
   float GetCurrentSpeed() const { return m_speed.load(); }
   void UpdateSpeed(float val) { m_speed.store(val); }
 
+  // Can be called from any thread, so that backends can tell whether their buffer is too small.
+  // Number of times Mix ran out of DSP samples and had to pad the output.
+  u64 GetUnderrunCount() const { return m_underrun_count.load(std::memory_order_relaxed); }
+  // Number of DSP samples waiting to be mixed, converted to the output sample rate.
+  unsigned int GetBufferedSamples() const { return m_dma_mixer.AvailableSamples(); }
+
 private:
   static constexpr u32 MAX_SAMPLES = 1024 * 4;  // 128 ms
   static constexpr u32 INDEX_MASK = MAX_SAMPLES * 2 - 1;
   static constexpr int MAX_FREQ_SHIFT = 200;  // Per 32000 Hz
   static constexpr float CONTROL_FACTOR = 0.2f;
   static constexpr u32 CONTROL_AVG = 32;  // In freq_shift per FIFO size offset
+  static constexpr u32 MIX_BLOCK_SIZE = 256;  // In stereo samples
+  static constexpr size_t NUM_FIFOS = 7;
+  static constexpr size_t CACHE_LINE_SIZE = 64;
 
   const unsigned int SURROUND_CHANNELS = 6;
 
@@ -69,26 +78,47 @@ private:
     }
     void DoState(PointerWrap& p);
     void PushSamples(const short* samples, unsigned int num_samples);
-    unsigned int Mix(short* samples, unsigned int numSamples, bool consider_framelimit = true);
     void SetInputSampleRate(unsigned int rate);
     unsigned int GetInputSampleRate() const;
     void SetVolume(unsigned int lvolume, unsigned int rvolume);
     unsigned int AvailableSamples() const;
 
+    // Called from the audio thread. BeginMix picks the resampling ratio and volume for one call
+    // to Mixer::Mix, which then resamples the output in blocks of up to MIX_BLOCK_SIZE samples.
+    // Resample pads the output with the last sample if the FIFO runs out, and returns the number
+    // of samples which weren't padding.
+    void BeginMix(bool consider_framelimit);
+    unsigned int Resample(short* samples, unsigned int num_samples);
+    // Whether the output of the last Resample call can be skipped when mixing.
+    bool IsSilent() const { return m_is_silent; }
+    s32 GetMixLVolume() const { return m_mix_lvolume; }
+    s32 GetMixRVolume() const { return m_mix_rvolume; }
+
   private:
+    template <bool little_endian>
+    unsigned int Resample(short* samples, unsigned int num_samples, u32 indexR, u32 indexW);
+
     Mixer* m_mixer;
     unsigned m_input_sample_rate;
     bool m_little_endian;
     std::array<short, MAX_SAMPLES * 2> m_buffer{};
-    std::atomic<u32> m_indexW{0};
-    std::atomic<u32> m_indexR{0};
-    // Volume ranges from 0-256
-    std::atomic<s32> m_LVolume{256};
-    std::atomic<s32> m_RVolume{256};
+    // The indices are written by different threads, so keep them on separate cache lines.
+    // Everything after m_indexR is only used by the audio thread.
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_indexW{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_indexR{0};
     float m_numLeftI = 0.0f;
     u32 m_frac = 0;
+    u32 m_ratio = 0;
+    s32 m_mix_lvolume = 0;
+    s32 m_mix_rvolume = 0;
+    bool m_is_silent = true;
+    // Volume ranges from 0-256
+    alignas(CACHE_LINE_SIZE) std::atomic<s32> m_LVolume{256};
+    std::atomic<s32> m_RVolume{256};
   };
 
+  void MixFifos(short* samples, unsigned int num_samples, bool consider_framelimit);
+
   MixerFifo m_dma_mixer{this, 32000, false};
   MixerFifo m_streaming_mixer{this, 48000, false};
   MixerFifo m_wiimote_speaker_mixer{this, 3000, true};
@@ -100,12 +130,11 @@ private:
   AudioCommon::AudioStretcher m_stretcher;
   AudioCommon::SurroundDecoder m_surround_decoder;
   std::array<short, MAX_SAMPLES * 2> m_scratch_buffer{};
+  alignas(16) std::array<std::array<short, MIX_BLOCK_SIZE * 2>, NUM_FIFOS> m_resample_buffers{};
+  std::atomic<u64> m_underrun_count{0};
 
-  WaveFileWriter m_wave_writer_dtk;
-  WaveFileWriter m_wave_writer_dsp;
-
-  bool m_log_dtk_audio = false;
-  bool m_log_dsp_audio = false;
+  AudioCommon::AudioDumper m_dtk_dumper;
+  AudioCommon::AudioDumper m_dsp_dumper;
 
   // Current rate of emulation (1.0 = 100% speed)
   std::atomic<float> m_speed{0.0f};
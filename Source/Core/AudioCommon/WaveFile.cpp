@@ -120,8 +120,11 @@ void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int
   if (!file)
     ERROR_LOG_FMT(AUDIO, "WaveFileWriter - file not open.");
 
-  if (count > BUFFER_SIZE * 2)
+  if (count * 2 > BUFFER_SIZE)
+  {
     ERROR_LOG_FMT(AUDIO, "WaveFileWriter - buffer too small (count = {}).", count);
+    return;
+  }
 
   if (skip_silence)
   {
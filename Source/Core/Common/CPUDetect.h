@@ -46,6 +46,9 @@ struct CPUInfo
   bool bFMA = false;
   bool bFMA4 = false;
   bool bAES = false;
+  bool bPCLMUL = false;
+  bool bSHA1 = false;
+  bool bSHA2 = false;
   // FXSAVE/FXRSTOR
   bool bFXSR = false;
   bool bMOVBE = false;
@@ -61,8 +64,6 @@ struct CPUInfo
   bool bFP = false;
   bool bASIMD = false;
   bool bCRC32 = false;
-  bool bSHA1 = false;
-  bool bSHA2 = false;
   bool bAFP = false;  // Alternate floating-point behavior
 
   // Call Detect()
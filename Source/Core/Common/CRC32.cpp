@@ -1,19 +1,150 @@
 // Copyright 2021 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "Common/CRC32.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include <zlib.h>
 
-#include "Common/CRC32.h"
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
+
+#ifdef _M_ARM_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#endif
+#endif
 
 namespace Common
 {
+#ifdef _M_X86_64
+static __m128i Load128(const u8* data)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Multiplies both halves of x by the matching constant in k and adds the next block
+FUNCTION_TARGET_PCLMUL
+static __m128i Fold128(__m128i x, __m128i next, __m128i k)
+{
+  const __m128i low = _mm_clmulepi64_si128(x, k, 0x00);
+  const __m128i high = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(high, low), next);
+}
+
+// Folds the data 64 bytes at a time using carry-less multiplication, as described in Intel's
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction". The constants are
+// powers of x modulo the bit-reflected CRC-32 polynomial. Unlike UpdateCRC32, this takes and
+// returns the CRC without the final inversion. size must be a multiple of 16 and at least 64.
+FUNCTION_TARGET_PCLMUL
+static u32 UpdateCRC32PCLMUL(u32 crc, const u8* data, size_t size)
+{
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const __m128i low_mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  __m128i x1 = _mm_xor_si128(Load128(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+  __m128i x2 = Load128(data + 0x10);
+  __m128i x3 = Load128(data + 0x20);
+  __m128i x4 = Load128(data + 0x30);
+  data += 64;
+  size -= 64;
+
+  // Fold four independent 128-bit lanes, so that the multiplications can overlap
+  while (size >= 64)
+  {
+    x1 = Fold128(x1, Load128(data), k1k2);
+    x2 = Fold128(x2, Load128(data + 0x10), k1k2);
+    x3 = Fold128(x3, Load128(data + 0x20), k1k2);
+    x4 = Fold128(x4, Load128(data + 0x30), k1k2);
+    data += 64;
+    size -= 64;
+  }
+
+  // Fold the lanes into one, then fold in any remaining 16-byte blocks
+  x1 = Fold128(x1, x2, k3k4);
+  x1 = Fold128(x1, x3, k3k4);
+  x1 = Fold128(x1, x4, k3k4);
+  while (size >= 16)
+  {
+    x1 = Fold128(x1, Load128(data), k3k4);
+    data += 16;
+    size -= 16;
+  }
+
+  // Reduce from 128 to 64 bits
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, low_mask), k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, low_mask), poly, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, low_mask), poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<u32>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+#ifdef _M_ARM_64
+static u32 UpdateCRC32ARM(u32 crc, const u8* data, size_t size)
+{
+  crc = ~crc;
+
+  for (; size >= 8; data += 8, size -= 8)
+  {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    crc = __crc32d(crc, value);
+  }
+  for (; size > 0; ++data, --size)
+    crc = __crc32b(crc, *data);
+
+  return ~crc;
+}
+#endif
+
+static u32 UpdateCRC32Zlib(u32 crc, const u8* data, size_t size)
+{
+  // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
+  while (size > 0)
+  {
+    const uInt chunk_size = static_cast<uInt>(std::min<size_t>(size, 0x40000000));
+    crc = static_cast<u32>(crc32(crc, data, chunk_size));
+    data += chunk_size;
+    size -= chunk_size;
+  }
+  return crc;
+}
+
+u32 UpdateCRC32(u32 crc, const u8* data, size_t size)
+{
+#if defined(_M_X86_64)
+  if (cpu_info.bPCLMUL && cpu_info.bSSE4_1 && size >= 64)
+  {
+    const size_t simd_size = size & ~size_t(15);
+    crc = ~UpdateCRC32PCLMUL(~crc, data, simd_size);
+    data += simd_size;
+    size -= simd_size;
+  }
+#elif defined(_M_ARM_64)
+  if (cpu_info.bCRC32)
+    return UpdateCRC32ARM(crc, data, size);
+#endif
+
+  return UpdateCRC32Zlib(crc, data, size);
+}
+
 u32 ComputeCRC32(std::string_view data)
 {
-  const Bytef* buf = reinterpret_cast<const Bytef*>(data.data());
-  uInt len = static_cast<uInt>(data.size());
-  // Use zlibs crc32 implementation to compute the hash
-  u32 hash = crc32(0L, Z_NULL, 0);
-  hash = crc32(hash, buf, len);
-  return hash;
+  return UpdateCRC32(0, reinterpret_cast<const u8*>(data.data()), data.size());
 }
 }  // namespace Common
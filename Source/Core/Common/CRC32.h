@@ -1,11 +1,19 @@
 // Copyright 2021 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#pragma once
+
+#include <cstddef>
 #include <string_view>
 
 #include "Common/CommonTypes.h"
 
 namespace Common
 {
+// Computes the same CRC-32 as zlib's crc32. To hash data in several parts, pass the result for
+// the previous parts as crc (the initial value is 0). Uses PCLMULQDQ or the ARMv8 CRC32
+// instructions when the CPU supports them.
+u32 UpdateCRC32(u32 crc, const u8* data, size_t size);
+
 u32 ComputeCRC32(std::string_view data);
 }  // namespace Common
@@ -1,24 +1,288 @@
 // Copyright 2017 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+
 #include <mbedtls/aes.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/Crypto/AES.h"
+#include "Common/Intrinsics.h"
+
+#if defined(_M_ARM_64) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#define HAVE_ARM_AES 1
+#include <arm_neon.h>
+#endif
 
 namespace Common::AES
 {
-std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
+namespace
 {
-  mbedtls_aes_context aes_ctx;
-  std::vector<u8> buffer(size);
+constexpr size_t NUM_ROUND_KEYS = 11;
+using RoundKeys = std::array<std::array<u8, BLOCK_SIZE>, NUM_ROUND_KEYS>;
+
+class ContextGeneric final : public Context
+{
+public:
+  ContextGeneric(Mode mode, const u8* key) : m_mode(mode)
+  {
+    mbedtls_aes_init(&m_ctx);
+    if (mode == Mode::Encrypt)
+      mbedtls_aes_setkey_enc(&m_ctx, key, 128);
+    else
+      mbedtls_aes_setkey_dec(&m_ctx, key, 128);
+  }
+
+  ~ContextGeneric() override { mbedtls_aes_free(&m_ctx); }
+
+  bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t len) const override
+  {
+    std::array<u8, BLOCK_SIZE> iv_tmp;
+    std::memcpy(iv_tmp.data(), iv, BLOCK_SIZE);
+
+    // mbedtls does not modify the context when encrypting or decrypting.
+    const int mode = m_mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT;
+    if (mbedtls_aes_crypt_cbc(const_cast<mbedtls_aes_context*>(&m_ctx), mode, len, iv_tmp.data(),
+                              buf_in, buf_out) != 0)
+    {
+      return false;
+    }
+
+    if (iv_out)
+      std::memcpy(iv_out, iv_tmp.data(), BLOCK_SIZE);
+    return true;
+  }
+
+private:
+  Mode m_mode;
+  mbedtls_aes_context m_ctx;
+};
 
+#if defined(_M_X86_64) || defined(HAVE_ARM_AES)
+// mbedtls expands the key into the same round key layout that AES-NI and the ARMv8 instructions
+// use, including the equivalent inverse cipher round keys for decryption.
+RoundKeys ExpandKey(Mode mode, const u8* key)
+{
+  mbedtls_aes_context ctx;
+  mbedtls_aes_init(&ctx);
   if (mode == Mode::Encrypt)
-    mbedtls_aes_setkey_enc(&aes_ctx, key, 128);
+    mbedtls_aes_setkey_enc(&ctx, key, 128);
   else
-    mbedtls_aes_setkey_dec(&aes_ctx, key, 128);
+    mbedtls_aes_setkey_dec(&ctx, key, 128);
+
+  RoundKeys round_keys;
+  std::memcpy(round_keys.data(), ctx.rk, sizeof(round_keys));
+  mbedtls_aes_free(&ctx);
+  return round_keys;
+}
+#endif
+
+// CBC decryption has no dependency between blocks, so this many blocks are decrypted at once to
+// hide the latency of the AES instructions.
+constexpr size_t PARALLEL_BLOCKS = 8;
+
+#if defined(_M_X86_64)
+template <Mode AesMode>
+class ContextAESNI final : public Context
+{
+public:
+  explicit ContextAESNI(const u8* key)
+  {
+    const RoundKeys round_keys = ExpandKey(AesMode, key);
+    for (size_t i = 0; i < NUM_ROUND_KEYS; i++)
+      m_round_keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys[i].data()));
+  }
+
+  FUNCTION_TARGET_AES
+  bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t len) const override
+  {
+    if (len % BLOCK_SIZE != 0)
+      return false;
+
+    const __m128i* in = reinterpret_cast<const __m128i*>(buf_in);
+    __m128i* out = reinterpret_cast<__m128i*>(buf_out);
+    const size_t num_blocks = len / BLOCK_SIZE;
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+
+    // Copied so that the compiler can keep them in registers despite the stores to buf_out.
+    __m128i round_keys[NUM_ROUND_KEYS];
+    std::copy(std::begin(m_round_keys), std::end(m_round_keys), round_keys);
+
+    if constexpr (AesMode == Mode::Encrypt)
+    {
+      for (size_t i = 0; i < num_blocks; i++)
+      {
+        __m128i block = _mm_xor_si128(_mm_loadu_si128(&in[i]), chain);
+        block = _mm_xor_si128(block, round_keys[0]);
+        for (size_t r = 1; r < NUM_ROUND_KEYS - 1; r++)
+          block = _mm_aesenc_si128(block, round_keys[r]);
+        chain = _mm_aesenclast_si128(block, round_keys[NUM_ROUND_KEYS - 1]);
+        _mm_storeu_si128(&out[i], chain);
+      }
+    }
+    else
+    {
+      size_t i = 0;
+      for (; i + PARALLEL_BLOCKS <= num_blocks; i += PARALLEL_BLOCKS)
+      {
+        __m128i cipher[PARALLEL_BLOCKS];
+        __m128i block[PARALLEL_BLOCKS];
+        for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+        {
+          cipher[j] = _mm_loadu_si128(&in[i + j]);
+          block[j] = _mm_xor_si128(cipher[j], round_keys[0]);
+        }
+        for (size_t r = 1; r < NUM_ROUND_KEYS - 1; r++)
+        {
+          for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+            block[j] = _mm_aesdec_si128(block[j], round_keys[r]);
+        }
+        for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+        {
+          block[j] = _mm_aesdeclast_si128(block[j], round_keys[NUM_ROUND_KEYS - 1]);
+          _mm_storeu_si128(&out[i + j], _mm_xor_si128(block[j], chain));
+          chain = cipher[j];
+        }
+      }
+      for (; i < num_blocks; i++)
+      {
+        const __m128i cipher = _mm_loadu_si128(&in[i]);
+        __m128i block = _mm_xor_si128(cipher, round_keys[0]);
+        for (size_t r = 1; r < NUM_ROUND_KEYS - 1; r++)
+          block = _mm_aesdec_si128(block, round_keys[r]);
+        block = _mm_aesdeclast_si128(block, round_keys[NUM_ROUND_KEYS - 1]);
+        _mm_storeu_si128(&out[i], _mm_xor_si128(block, chain));
+        chain = cipher;
+      }
+    }
+
+    if (iv_out)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), chain);
+    return true;
+  }
+
+private:
+  __m128i m_round_keys[NUM_ROUND_KEYS];
+};
+#endif
+
+#if defined(HAVE_ARM_AES)
+template <Mode AesMode>
+class ContextNeon final : public Context
+{
+public:
+  explicit ContextNeon(const u8* key)
+  {
+    const RoundKeys round_keys = ExpandKey(AesMode, key);
+    for (size_t i = 0; i < NUM_ROUND_KEYS; i++)
+      m_round_keys[i] = vld1q_u8(round_keys[i].data());
+  }
+
+  bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t len) const override
+  {
+    if (len % BLOCK_SIZE != 0)
+      return false;
+
+    const size_t num_blocks = len / BLOCK_SIZE;
+    uint8x16_t chain = vld1q_u8(iv);
+
+    // Copied so that the compiler can keep them in registers despite the stores to buf_out.
+    uint8x16_t round_keys[NUM_ROUND_KEYS];
+    std::copy(std::begin(m_round_keys), std::end(m_round_keys), round_keys);
+
+    // AESE/AESD include the AddRoundKey step, which is why the last round key is applied with a
+    // plain XOR.
+    if constexpr (AesMode == Mode::Encrypt)
+    {
+      for (size_t i = 0; i < num_blocks; i++)
+      {
+        uint8x16_t block = veorq_u8(vld1q_u8(buf_in + i * BLOCK_SIZE), chain);
+        for (size_t r = 0; r < NUM_ROUND_KEYS - 2; r++)
+          block = vaesmcq_u8(vaeseq_u8(block, round_keys[r]));
+        block = vaeseq_u8(block, round_keys[NUM_ROUND_KEYS - 2]);
+        chain = veorq_u8(block, round_keys[NUM_ROUND_KEYS - 1]);
+        vst1q_u8(buf_out + i * BLOCK_SIZE, chain);
+      }
+    }
+    else
+    {
+      size_t i = 0;
+      for (; i + PARALLEL_BLOCKS <= num_blocks; i += PARALLEL_BLOCKS)
+      {
+        uint8x16_t cipher[PARALLEL_BLOCKS];
+        uint8x16_t block[PARALLEL_BLOCKS];
+        for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+          block[j] = cipher[j] = vld1q_u8(buf_in + (i + j) * BLOCK_SIZE);
+        for (size_t r = 0; r < NUM_ROUND_KEYS - 2; r++)
+        {
+          for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+            block[j] = vaesimcq_u8(vaesdq_u8(block[j], round_keys[r]));
+        }
+        for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+        {
+          block[j] = vaesdq_u8(block[j], round_keys[NUM_ROUND_KEYS - 2]);
+          block[j] = veorq_u8(block[j], round_keys[NUM_ROUND_KEYS - 1]);
+          vst1q_u8(buf_out + (i + j) * BLOCK_SIZE, veorq_u8(block[j], chain));
+          chain = cipher[j];
+        }
+      }
+      for (; i < num_blocks; i++)
+      {
+        const uint8x16_t cipher = vld1q_u8(buf_in + i * BLOCK_SIZE);
+        uint8x16_t block = cipher;
+        for (size_t r = 0; r < NUM_ROUND_KEYS - 2; r++)
+          block = vaesimcq_u8(vaesdq_u8(block, round_keys[r]));
+        block = vaesdq_u8(block, round_keys[NUM_ROUND_KEYS - 2]);
+        block = veorq_u8(block, round_keys[NUM_ROUND_KEYS - 1]);
+        vst1q_u8(buf_out + i * BLOCK_SIZE, veorq_u8(block, chain));
+        chain = cipher;
+      }
+    }
+
+    if (iv_out)
+      vst1q_u8(iv_out, chain);
+    return true;
+  }
+
+private:
+  uint8x16_t m_round_keys[NUM_ROUND_KEYS];
+};
+#endif
+
+template <Mode AesMode>
+std::unique_ptr<Context> CreateContext(const u8* key)
+{
+#if defined(_M_X86_64)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextAESNI<AesMode>>(key);
+#elif defined(HAVE_ARM_AES)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextNeon<AesMode>>(key);
+#endif
+  return std::make_unique<ContextGeneric>(AesMode, key);
+}
+}  // Anonymous namespace
+
+std::unique_ptr<Context> CreateContextEncrypt(const u8* key)
+{
+  return CreateContext<Mode::Encrypt>(key);
+}
+
+std::unique_ptr<Context> CreateContextDecrypt(const u8* key)
+{
+  return CreateContext<Mode::Decrypt>(key);
+}
+
+std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
+{
+  std::vector<u8> buffer(size);
 
-  mbedtls_aes_crypt_cbc(&aes_ctx, mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
-                        size, iv, src, buffer.data());
+  const std::unique_ptr<Context> context =
+      mode == Mode::Encrypt ? CreateContextEncrypt(key) : CreateContextDecrypt(key);
+  context->Crypt(iv, iv, src, buffer.data(), size);
 
   return buffer;
 }
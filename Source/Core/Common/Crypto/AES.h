@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -15,6 +17,37 @@ enum class Mode
   Decrypt,
   Encrypt,
 };
+
+constexpr size_t KEY_SIZE = 16;
+constexpr size_t BLOCK_SIZE = 16;
+
+// AES-128-CBC. Uses AES-NI or the ARMv8 Cryptography Extensions when the host supports them.
+// A context only holds the expanded key, so it can be used from several threads at once.
+class Context
+{
+public:
+  virtual ~Context() = default;
+
+  // len must be a multiple of BLOCK_SIZE. buf_in and buf_out may point to the same buffer.
+  // If iv_out is not null, the IV which continues the chain is written to it (iv_out may be iv).
+  virtual bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out,
+                     size_t len) const = 0;
+
+  bool Crypt(const u8* iv, const u8* buf_in, u8* buf_out, size_t len) const
+  {
+    return Crypt(iv, nullptr, buf_in, buf_out, len);
+  }
+
+  bool CryptIvZero(const u8* buf_in, u8* buf_out, size_t len) const
+  {
+    static constexpr std::array<u8, BLOCK_SIZE> iv_zero{};
+    return Crypt(iv_zero.data(), buf_in, buf_out, len);
+  }
+};
+
+std::unique_ptr<Context> CreateContextEncrypt(const u8* key);
+std::unique_ptr<Context> CreateContextDecrypt(const u8* key);
+
 std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode);
 
 // Convenience functions
@@ -0,0 +1,281 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/Crypto/SHA1.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+#include <mbedtls/sha1.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
+#include "Common/Swap.h"
+
+#if defined(_M_ARM_64) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define HAVE_ARM_SHA1 1
+#include <arm_neon.h>
+#endif
+
+namespace Common::SHA1
+{
+namespace
+{
+class ContextGeneric final : public Context
+{
+public:
+  ContextGeneric()
+  {
+    mbedtls_sha1_init(&m_ctx);
+    mbedtls_sha1_starts_ret(&m_ctx);
+  }
+
+  ~ContextGeneric() override { mbedtls_sha1_free(&m_ctx); }
+
+  void Update(const u8* msg, size_t len) override { mbedtls_sha1_update_ret(&m_ctx, msg, len); }
+
+  Digest Finish() override
+  {
+    Digest digest;
+    mbedtls_sha1_finish_ret(&m_ctx, digest.data());
+    return digest;
+  }
+
+private:
+  mbedtls_sha1_context m_ctx;
+};
+
+// Handles buffering and padding for implementations which process whole 64-byte blocks.
+class BlockContext : public Context
+{
+public:
+  void Update(const u8* msg, size_t len) override
+  {
+    m_msg_len += len;
+
+    if (m_buffer_len != 0)
+    {
+      const size_t to_copy = std::min(len, BLOCK_LEN - m_buffer_len);
+      std::memcpy(m_buffer.data() + m_buffer_len, msg, to_copy);
+      m_buffer_len += to_copy;
+      msg += to_copy;
+      len -= to_copy;
+      if (m_buffer_len < BLOCK_LEN)
+        return;
+
+      ProcessBlocks(m_buffer.data(), 1);
+      m_buffer_len = 0;
+    }
+
+    const size_t num_blocks = len / BLOCK_LEN;
+    if (num_blocks != 0)
+      ProcessBlocks(msg, num_blocks);
+
+    m_buffer_len = len % BLOCK_LEN;
+    std::memcpy(m_buffer.data(), msg + num_blocks * BLOCK_LEN, m_buffer_len);
+  }
+
+  Digest Finish() override
+  {
+    const u64 bit_len = Common::swap64(m_msg_len * 8);
+
+    // Pad with 0x80 followed by zeroes, so that the length fills the end of the last block.
+    static constexpr std::array<u8, BLOCK_LEN> padding{0x80};
+    const size_t padding_len =
+        (m_buffer_len < BLOCK_LEN - sizeof(bit_len) ? BLOCK_LEN : 2 * BLOCK_LEN) - m_buffer_len -
+        sizeof(bit_len);
+    Update(padding.data(), padding_len);
+    Update(reinterpret_cast<const u8*>(&bit_len), sizeof(bit_len));
+
+    Digest digest;
+    for (size_t i = 0; i < m_state.size(); i++)
+    {
+      const u32 word = Common::swap32(m_state[i]);
+      std::memcpy(digest.data() + i * sizeof(word), &word, sizeof(word));
+    }
+    return digest;
+  }
+
+protected:
+  static constexpr size_t BLOCK_LEN = 64;
+
+  virtual void ProcessBlocks(const u8* msg, size_t num_blocks) = 0;
+
+  std::array<u32, 5> m_state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+private:
+  std::array<u8, BLOCK_LEN> m_buffer{};
+  size_t m_buffer_len = 0;
+  u64 m_msg_len = 0;
+};
+
+#if defined(_M_X86_64)
+// The message schedule and the round groups are unrolled with templates, because the round
+// function selector of SHA1RNDS4 has to be an immediate.
+class ContextSHANI final : public BlockContext
+{
+private:
+  // Computes the next four message words, w[G % 4], from the previous sixteen.
+  template <size_t G>
+  FUNCTION_TARGET_SHA static inline void Schedule(__m128i* w)
+  {
+    if constexpr (G >= 4)
+    {
+      w[G % 4] = _mm_sha1msg2_epu32(
+          _mm_xor_si128(_mm_sha1msg1_epu32(w[G % 4], w[(G + 1) % 4]), w[(G + 2) % 4]),
+          w[(G + 3) % 4]);
+    }
+  }
+
+  // Performs rounds 4 * G to 4 * G + 3. prev_abcd holds the state from before the previous group,
+  // from which SHA1NEXTE derives E.
+  template <size_t G>
+  FUNCTION_TARGET_SHA static inline void Rounds(__m128i* w, __m128i* abcd, __m128i* prev_abcd)
+  {
+    Schedule<G>(w);
+    const __m128i e = _mm_sha1nexte_epu32(*prev_abcd, w[G % 4]);
+    *prev_abcd = *abcd;
+    *abcd = _mm_sha1rnds4_epu32(*abcd, e, G / 5);
+  }
+
+  template <size_t... Gs>
+  FUNCTION_TARGET_SHA static inline void Rounds(__m128i* w, __m128i* abcd, __m128i* prev_abcd,
+                                                std::index_sequence<Gs...>)
+  {
+    (Rounds<Gs + 1>(w, abcd, prev_abcd), ...);
+  }
+
+  FUNCTION_TARGET_SHA
+  void ProcessBlocks(const u8* msg, size_t num_blocks) override
+  {
+    // Reverses the bytes of the whole vector, which both byte swaps the words and puts the first
+    // word into the highest lane like the SHA instructions expect.
+    const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_state.data())), 0x1b);
+    __m128i e0 = _mm_set_epi32(m_state[4], 0, 0, 0);
+
+    for (size_t block = 0; block < num_blocks; block++, msg += BLOCK_LEN)
+    {
+      const __m128i abcd_save = abcd;
+      const __m128i e0_save = e0;
+
+      __m128i w[4];
+      for (size_t i = 0; i < 4; i++)
+      {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(msg + i * 16)),
+                                byte_swap);
+      }
+
+      // The first group takes E directly from the state instead of through SHA1NEXTE.
+      __m128i prev_abcd = abcd;
+      abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e0, w[0]), 0);
+      Rounds(w, &abcd, &prev_abcd, std::make_index_sequence<19>());
+
+      e0 = _mm_sha1nexte_epu32(prev_abcd, e0_save);
+      abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_state.data()), _mm_shuffle_epi32(abcd, 0x1b));
+    m_state[4] = static_cast<u32>(_mm_extract_epi32(e0, 3));
+  }
+};
+#endif
+
+#if defined(HAVE_ARM_SHA1)
+class ContextNeon final : public BlockContext
+{
+private:
+  static constexpr std::array<u32, 4> ROUND_CONSTANTS{0x5a827999, 0x6ed9eba1, 0x8f1bbcdc,
+                                                      0xca62c1d6};
+
+  template <size_t G>
+  static inline void Rounds(uint32x4_t* w, uint32x4_t* abcd, u32* e)
+  {
+    if constexpr (G >= 4)
+    {
+      w[G % 4] =
+          vsha1su1q_u32(vsha1su0q_u32(w[G % 4], w[(G + 1) % 4], w[(G + 2) % 4]), w[(G + 3) % 4]);
+    }
+
+    const uint32x4_t wk = vaddq_u32(w[G % 4], vdupq_n_u32(ROUND_CONSTANTS[G / 5]));
+    const u32 next_e = vsha1h_u32(vgetq_lane_u32(*abcd, 0));
+    if constexpr (G / 5 == 0)
+      *abcd = vsha1cq_u32(*abcd, *e, wk);
+    else if constexpr (G / 5 == 2)
+      *abcd = vsha1mq_u32(*abcd, *e, wk);
+    else
+      *abcd = vsha1pq_u32(*abcd, *e, wk);
+    *e = next_e;
+  }
+
+  template <size_t... Gs>
+  static inline void Rounds(uint32x4_t* w, uint32x4_t* abcd, u32* e, std::index_sequence<Gs...>)
+  {
+    (Rounds<Gs>(w, abcd, e), ...);
+  }
+
+  void ProcessBlocks(const u8* msg, size_t num_blocks) override
+  {
+    uint32x4_t abcd = vld1q_u32(m_state.data());
+    u32 e = m_state[4];
+
+    for (size_t block = 0; block < num_blocks; block++, msg += BLOCK_LEN)
+    {
+      const uint32x4_t abcd_save = abcd;
+      const u32 e_save = e;
+
+      uint32x4_t w[4];
+      for (size_t i = 0; i < 4; i++)
+        w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(msg + i * 16)));
+
+      Rounds(w, &abcd, &e, std::make_index_sequence<20>());
+
+      abcd = vaddq_u32(abcd, abcd_save);
+      e += e_save;
+    }
+
+    vst1q_u32(m_state.data(), abcd);
+    m_state[4] = e;
+  }
+};
+#endif
+
+// Digests are often calculated for many small messages in a row (such as the 0x400 byte H0 hashes
+// of Wii discs), so CalculateDigest uses a context on the stack rather than a heap-allocated one.
+template <typename T>
+Digest CalculateDigestWith(const u8* msg, size_t len)
+{
+  T context;
+  context.Update(msg, len);
+  return context.Finish();
+}
+}  // Anonymous namespace
+
+std::unique_ptr<Context> CreateContext()
+{
+#if defined(_M_X86_64)
+  if (cpu_info.bSHA1 && cpu_info.bSSE4_1)
+    return std::make_unique<ContextSHANI>();
+#elif defined(HAVE_ARM_SHA1)
+  if (cpu_info.bSHA1)
+    return std::make_unique<ContextNeon>();
+#endif
+  return std::make_unique<ContextGeneric>();
+}
+
+Digest CalculateDigest(const u8* msg, size_t len)
+{
+#if defined(_M_X86_64)
+  if (cpu_info.bSHA1 && cpu_info.bSSE4_1)
+    return CalculateDigestWith<ContextSHANI>(msg, len);
+#elif defined(HAVE_ARM_SHA1)
+  if (cpu_info.bSHA1)
+    return CalculateDigestWith<ContextNeon>(msg, len);
+#endif
+  return CalculateDigestWith<ContextGeneric>(msg, len);
+}
+}  // namespace Common::SHA1
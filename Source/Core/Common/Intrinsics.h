@@ -39,6 +39,15 @@
 #ifndef __SSE3__
 #define FUNCTION_TARGET_SSE3 [[gnu::target("sse3")]]
 #endif
+#ifndef __AES__
+#define FUNCTION_TARGET_AES [[gnu::target("aes")]]
+#endif
+#if !defined(__SHA__) || !defined(__SSE4_1__)
+#define FUNCTION_TARGET_SHA [[gnu::target("sha,sse4.1")]]
+#endif
+#if !defined(__PCLMUL__) || !defined(__SSE4_1__)
+#define FUNCTION_TARGET_PCLMUL [[gnu::target("pclmul,sse4.1")]]
+#endif
 
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
 
@@ -69,3 +78,12 @@
 #ifndef FUNCTION_TARGET_SSE3
 #define FUNCTION_TARGET_SSE3
 #endif
+#ifndef FUNCTION_TARGET_AES
+#define FUNCTION_TARGET_AES
+#endif
+#ifndef FUNCTION_TARGET_SHA
+#define FUNCTION_TARGET_SHA
+#endif
+#ifndef FUNCTION_TARGET_PCLMUL
+#define FUNCTION_TARGET_PCLMUL
+#endif
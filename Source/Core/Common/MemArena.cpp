@@ -132,6 +132,17 @@ void MemArena::ReleaseView(void* view, size_t size)
 #endif
 }
 
+size_t MemArena::GetViewAlignment()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwAllocationGranularity;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
 u8* MemArena::FindMemoryBase()
 {
 #if _ARCH_32
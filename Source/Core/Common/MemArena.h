@@ -25,6 +25,9 @@ public:
   void* CreateView(s64 offset, size_t size, void* base = nullptr);
   void ReleaseView(void* view, size_t size);
 
+  // Views have to be aligned to this, both in the address space and in the segment.
+  static size_t GetViewAlignment();
+
   // This finds 1 GB in 32-bit, 16 GB in 64-bit.
   static u8* FindMemoryBase();
 
@@ -129,6 +129,8 @@ void CPUInfo::Detect()
       bSSE2 = true;
     if ((cpu_id[2]) & 1)
       bSSE3 = true;
+    if ((cpu_id[2] >> 1) & 1)
+      bPCLMUL = true;
     if ((cpu_id[2] >> 9) & 1)
       bSSSE3 = true;
     if ((cpu_id[2] >> 19) & 1)
@@ -170,6 +172,11 @@ void CPUInfo::Detect()
         bBMI1 = true;
       if ((cpu_id[1] >> 8) & 1)
         bBMI2 = true;
+      if ((cpu_id[1] >> 29) & 1)
+      {
+        bSHA1 = true;
+        bSHA2 = true;
+      }
     }
   }
 
@@ -269,6 +276,10 @@ std::string CPUInfo::Summarize()
     sum += ", FMA";
   if (bAES)
     sum += ", AES";
+  if (bPCLMUL)
+    sum += ", PCLMUL";
+  if (bSHA1)
+    sum += ", SHA";
   if (bMOVBE)
     sum += ", MOVBE";
   if (bLongMode)
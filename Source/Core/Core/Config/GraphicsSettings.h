@@ -80,6 +80,8 @@ extern const Info<bool> GFX_SW_DUMP_TEV_TEX_FETCHES;
 extern const Info<int> GFX_SW_DRAW_START;
 extern const Info<int> GFX_SW_DRAW_END;
 
+extern const Info<bool> GFX_NULL_FAST_FORWARD;
+
 extern const Info<bool> GFX_PREFER_GLES;
 
 // Graphics.Enhancements
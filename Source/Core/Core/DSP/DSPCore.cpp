@@ -416,6 +416,7 @@ bool DSPCore::Initialize(const DSPInitOptions& opts)
     return false;
 
   m_init_hax = false;
+  m_dsp_interpreter->ClearDecodeCache();
 
   // Initialize JIT, if necessary
   if (opts.core_type == DSPInitOptions::CoreType::JIT64)
@@ -488,10 +489,13 @@ void DSPCore::Reset()
 {
   m_dsp.Reset();
   m_dsp.GetAnalyzer().Analyze(m_dsp);
+  m_dsp_interpreter->ClearDecodeCache();
 }
 
 void DSPCore::ClearIRAM()
 {
+  m_dsp_interpreter->ClearDecodeCache();
+
   if (!m_dsp_jit)
     return;
 
@@ -27,18 +27,54 @@ Interpreter::Interpreter(DSPCore& dsp) : m_dsp_core{dsp}
 
 Interpreter::~Interpreter() = default;
 
-void Interpreter::ExecuteInstruction(const UDSPInstruction inst)
+Interpreter::DecodedInstruction Interpreter::DecodeInstruction(UDSPInstruction inst)
 {
-  const DSPOPCTemplate* opcode_template = GetOpTemplate(inst);
+  DecodedInstruction decoded;
+  decoded.op = GetOp(inst);
+  if (GetOpTemplate(inst)->extended)
+    decoded.ext_op = GetExtOp(inst);
+  decoded.inst = inst;
+  return decoded;
+}
 
-  if (opcode_template->extended)
+const Interpreter::DecodedInstruction* Interpreter::GetDecodedInstruction(u16 address)
+{
+  // Anything outside of IRAM and IROM isn't cached, so that it goes through ReadIMEM and gets
+  // logged.
+  size_t index;
+  switch (address >> 12)
   {
-    (this->*GetExtOp(inst))(inst);
+  case 0:
+    index = address & DSP_IRAM_MASK;
+    break;
+  case 8:
+    index = DSP_IRAM_SIZE + (address & DSP_IROM_MASK);
+    break;
+  default:
+    return nullptr;
   }
 
-  (this->*GetOp(inst))(inst);
+  DecodedInstruction& decoded = m_decode_cache[index];
+  if (decoded.op == nullptr)
+    decoded = DecodeInstruction(m_dsp_core.DSPState().ReadIMEM(address));
+  return &decoded;
+}
 
-  if (opcode_template->extended)
+void Interpreter::ClearDecodeCache()
+{
+  m_decode_cache.fill({});
+}
+
+void Interpreter::ExecuteInstruction(const DecodedInstruction& decoded)
+{
+  if (decoded.ext_op != nullptr)
+  {
+    (this->*decoded.ext_op)(decoded.inst);
+  }
+
+  (this->*decoded.op)(decoded.inst);
+
+  if (decoded.ext_op != nullptr)
   {
     ApplyWriteBackLog();
   }
@@ -48,11 +84,18 @@ void Interpreter::Step()
 {
   auto& state = m_dsp_core.DSPState();
 
-  m_dsp_core.CheckExceptions();
+  state.CheckExceptions();
   state.AdvanceStepCounter();
 
-  const u16 opc = state.FetchInstruction();
-  ExecuteInstruction(UDSPInstruction{opc});
+  if (const DecodedInstruction* decoded = GetDecodedInstruction(state.pc))
+  {
+    state.pc++;
+    ExecuteInstruction(*decoded);
+  }
+  else
+  {
+    ExecuteInstruction(DecodeInstruction(state.FetchInstruction()));
+  }
 
   const auto pc = state.pc;
   if (state.GetAnalyzer().IsLoopEnd(static_cast<u16>(pc - 1)))
@@ -8,6 +8,7 @@
 
 #include "Core/DSP/DSPCommon.h"
 #include "Core/DSP/DSPCore.h"
+#include "Core/DSP/Interpreter/DSPIntTables.h"
 
 namespace DSP::Interpreter
 {
@@ -25,6 +26,9 @@ public:
 
   void Step();
 
+  // Drops all predecoded instructions. Has to be called whenever IRAM or IROM change.
+  void ClearDecodeCache();
+
   // If these simply return the same number of cycles as was passed into them,
   // chances are that the DSP is halted.
   // The difference between them is that the debug one obeys breakpoints.
@@ -190,7 +194,17 @@ public:
   void nop_ext(UDSPInstruction opc);
 
 private:
-  void ExecuteInstruction(UDSPInstruction inst);
+  struct DecodedInstruction
+  {
+    InterpreterFunction op = nullptr;
+    // Only set for extended opcodes
+    InterpreterFunction ext_op = nullptr;
+    UDSPInstruction inst = 0;
+  };
+
+  static DecodedInstruction DecodeInstruction(UDSPInstruction inst);
+  const DecodedInstruction* GetDecodedInstruction(u16 address);
+  void ExecuteInstruction(const DecodedInstruction& decoded);
 
   bool CheckCondition(u8 condition) const;
 
@@ -246,6 +260,10 @@ private:
 
   DSPCore& m_dsp_core;
 
+  // Instructions in IRAM and IROM, indexed by address, decoded the first time they run.
+  // IRAM comes first, followed by IROM.
+  std::array<DecodedInstruction, DSP_IRAM_SIZE + DSP_IROM_SIZE> m_decode_cache{};
+
   static constexpr size_t WRITEBACK_LOG_SIZE = 5;
   std::array<u16, WRITEBACK_LOG_SIZE> m_write_back_log{};
   std::array<int, WRITEBACK_LOG_SIZE> m_write_back_log_idx{-1, -1, -1, -1, -1};
@@ -281,15 +281,9 @@ void DSPEmitter::Compile(u16 start_addr)
       // end of each block and in this order
       DSPJitRegCache c(m_gpr);
       HandleLoop();
+      WriteLoopLink();
       m_gpr.SaveRegs();
-      if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
-      {
-        MOV(16, R(EAX), Imm16(DSP_IDLE_SKIP_CYCLES));
-      }
-      else
-      {
-        MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
-      }
+      MOV(16, R(EAX), Imm16(GetBlockExitCycles()));
       JMP(m_return_dispatcher, true);
       m_gpr.LoadRegs(false);
       m_gpr.FlushRegs(c, false);
@@ -318,14 +312,7 @@ void DSPEmitter::Compile(u16 start_addr)
         DSPJitRegCache c(m_gpr);
         // don't update g_dsp.pc -- the branch insn already did
         m_gpr.SaveRegs();
-        if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
-        {
-          MOV(16, R(EAX), Imm16(DSP_IDLE_SKIP_CYCLES));
-        }
-        else
-        {
-          MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
-        }
+        MOV(16, R(EAX), Imm16(GetBlockExitCycles()));
         JMP(m_return_dispatcher, true);
         m_gpr.LoadRegs(false);
         m_gpr.FlushRegs(c, false);
@@ -381,17 +368,21 @@ void DSPEmitter::Compile(u16 start_addr)
   }
 
   m_gpr.SaveRegs();
-  if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
-  {
-    MOV(16, R(EAX), Imm16(DSP_IDLE_SKIP_CYCLES));
-  }
-  else
-  {
-    MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
-  }
+  MOV(16, R(EAX), Imm16(GetBlockExitCycles()));
   JMP(m_return_dispatcher, true);
 }
 
+// Idle loops (waiting for mail from the CPU, for instance) report many more cycles than they
+// actually took, so that the time spent spinning in them is skipped. This is disabled when the
+// DSP runs on its own thread, since it doesn't need to keep up with the CPU thread there.
+u16 DSPEmitter::GetBlockExitCycles() const
+{
+  if (!Host::OnThread() && m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
+    return DSP_IDLE_SKIP_CYCLES;
+
+  return m_block_size[m_start_address];
+}
+
 void DSPEmitter::CompileCurrent(DSPEmitter& emitter)
 {
   emitter.Compile(emitter.m_dsp_core.DSPState().pc);
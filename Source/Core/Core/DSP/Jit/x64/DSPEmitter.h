@@ -211,8 +211,11 @@ private:
 
   void FallBackToInterpreter(UDSPInstruction inst);
 
+  u16 GetBlockExitCycles() const;
   void WriteBranchExit();
   void WriteBlockLink(u16 dest);
+  void WriteLinkJump(Block dest, u16 cycles_executed, u16 cycles_needed);
+  void WriteLoopLink();
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
   void r_jcc(UDSPInstruction opc);
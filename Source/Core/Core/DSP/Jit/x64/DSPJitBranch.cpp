@@ -100,37 +100,51 @@ void DSPEmitter::WriteBranchExit()
 {
   DSPJitRegCache c(m_gpr);
   m_gpr.SaveRegs();
-  if (m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
-  {
-    MOV(16, R(EAX), Imm16(0x1000));
-  }
-  else
-  {
-    MOV(16, R(EAX), Imm16(m_block_size[m_start_address]));
-  }
+  MOV(16, R(EAX), Imm16(GetBlockExitCycles()));
   JMP(m_return_dispatcher, true);
   m_gpr.LoadRegs(false);
   m_gpr.FlushRegs(c, false);
 }
 
+// Jumps to dest without going through the dispatcher if there are enough cycles left to run
+// cycles_needed more cycles. The registers must have been flushed.
+void DSPEmitter::WriteLinkJump(Block dest, u16 cycles_executed, u16 cycles_needed)
+{
+  MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+  MOV(16, R(ECX), MatR(RAX));
+  CMP(16, R(ECX), Imm16(cycles_executed + cycles_needed));
+  FixupBranch notEnoughCycles = J_CC(CC_BE);
+
+  SUB(16, R(ECX), Imm16(cycles_executed));
+  MOV(16, MatR(RAX), R(ECX));
+  JMP(dest, true);
+  SetJumpTarget(notEnoughCycles);
+}
+
 void DSPEmitter::WriteBlockLink(u16 dest)
 {
+  // A jump back to the start of the block being compiled (a loop made of a single block) can be
+  // linked as well, unless it's an idle loop: those have to go through the dispatcher so that
+  // their cycles can be skipped.
+  if (dest == m_start_address)
+  {
+    if (!m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
+    {
+      // The jump itself hasn't been counted in the block size yet.
+      const u16 cycles_executed = m_block_size[m_start_address] + 1;
+      m_gpr.FlushRegs();
+      WriteLinkJump(m_block_link_entry, cycles_executed, cycles_executed);
+    }
+    return;
+  }
+
   // Jump directly to the called block if it has already been compiled.
   if (!(dest >= m_start_address && dest <= m_compile_pc))
   {
     if (m_block_links[dest] != nullptr)
     {
       m_gpr.FlushRegs();
-      // Check if we have enough cycles to execute the next block
-      MOV(64, R(RAX), ImmPtr(&m_cycles_left));
-      MOV(16, R(ECX), MatR(RAX));
-      CMP(16, R(ECX), Imm16(m_block_size[m_start_address] + m_block_size[dest]));
-      FixupBranch notEnoughCycles = J_CC(CC_BE);
-
-      SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
-      MOV(16, MatR(RAX), R(ECX));
-      JMP(m_block_links[dest], true);
-      SetJumpTarget(notEnoughCycles);
+      WriteLinkJump(m_block_links[dest], m_block_size[m_start_address], m_block_size[dest]);
     }
     else
     {
@@ -345,6 +359,23 @@ void DSPEmitter::HandleLoop()
   SetJumpTarget(rLoopCntG);
 }
 
+// Called after HandleLoop at the end of a loop body. After the first iteration of a BLOOP/LOOP,
+// the dispatcher enters the loop body at its start, so the remaining iterations run in a block
+// of their own. Jump straight back to the start of it rather than going through the dispatcher
+// once per iteration.
+void DSPEmitter::WriteLoopLink()
+{
+  if (m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
+    return;
+
+  const u16 cycles_executed = m_block_size[m_start_address];
+  m_gpr.FlushRegs();
+  CMP(16, M_SDSP_pc(), Imm16(m_start_address));
+  FixupBranch notLoopStart = J_CC(CC_NE);
+  WriteLinkJump(m_block_link_entry, cycles_executed, cycles_executed);
+  SetJumpTarget(notLoopStart);
+}
+
 // LOOP $R
 // 0000 0000 010r rrrr
 // Repeatedly execute following opcode until counter specified by value
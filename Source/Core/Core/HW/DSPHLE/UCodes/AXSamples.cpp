@@ -0,0 +1,182 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/HW/DSPHLE/UCodes/AXSamples.h"
+
+#include <algorithm>
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/MathUtil.h"
+#include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+
+namespace DSP::HLE::AX
+{
+// Maximum number of input samples decoded at once by ResampleAudio
+constexpr u32 MAX_BATCH_INPUT_COUNT = 256;
+
+u32 ResampleWindow(const s16* window, s16* output, u32 count, s16* last_samples, u32 curr_pos,
+                   u32 ratio, int srctype, const s16* coeffs)
+{
+  // Index in window of the oldest of the four most recent samples
+  u32 pos = 0;
+
+  // If DSP DROM coefficients are available, support polyphase resampling.
+  if (coeffs && srctype == SRCTYPE_POLYPHASE)
+  {
+    for (u32 i = 0; i < count; ++i)
+    {
+      curr_pos += ratio;
+      pos += curr_pos >> 16;
+      curr_pos &= 0xFFFF;
+
+      const s16* c = &coeffs[(curr_pos >> 9) << 2];
+      const s16* t = &window[pos];
+
+      s64 samp = (s64{t[0]} * c[0] + s64{t[1]} * c[1] + s64{t[2]} * c[2] + s64{t[3]} * c[3]) >> 15;
+
+      output[i] = MathUtil::SaturatingCast<s16>(samp);
+    }
+  }
+  else if (srctype == SRCTYPE_LINEAR || srctype == SRCTYPE_POLYPHASE)
+  {
+    for (u32 i = 0; i < count; ++i)
+    {
+      curr_pos += ratio;
+      pos += curr_pos >> 16;
+      curr_pos &= 0xFFFF;
+
+      // Get our current fractional position, used to know how much of
+      // curr0 and how much of curr1 the output sample should be.
+      u16 curr_frac = curr_pos;
+      u16 inv_curr_frac = -curr_frac;
+
+      // Interpolate! If curr_frac is 0, we can simply take the last
+      // sample without any multiplying.
+      const s16* t = &window[pos];
+      if (curr_frac)
+        output[i] = ((s32{t[0]} * inv_curr_frac) + (s32{t[1]} * curr_frac)) >> 16;
+      else
+        output[i] = t[0];
+    }
+  }
+  else  // SRCTYPE_NEAREST
+  {
+    // No sample rate conversion here: simply copy the input samples to the
+    // output buffer.
+    pos = count;
+    std::copy_n(window + 4, count, output);
+  }
+
+  // Update the four last_samples values.
+  std::copy_n(window + pos, 4, last_samples);
+
+  return curr_pos;
+}
+
+u32 ResampleAudio(const GetSamplesFunction& get_samples, s16* output, u32 count, s16* last_samples,
+                  u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
+{
+  const bool uses_ratio = srctype == SRCTYPE_LINEAR || srctype == SRCTYPE_POLYPHASE;
+  std::array<s16, 4 + MAX_BATCH_INPUT_COUNT> window;
+
+  u32 done = 0;
+  while (done < count)
+  {
+    // Take as many output samples as the input samples they need fit in the window
+    u32 batch_count = 0;
+    u32 input_count = 0;
+    u32 batch_ratio = ratio;
+    if (uses_ratio)
+    {
+      u32 pos = curr_pos;
+      while (done + batch_count < count)
+      {
+        pos += ratio;
+        const u32 sample_input_count = pos >> 16;
+        if (input_count + sample_input_count > MAX_BATCH_INPUT_COUNT)
+          break;
+        input_count += sample_input_count;
+        pos &= 0xFFFF;
+        ++batch_count;
+      }
+
+      if (batch_count == 0)
+      {
+        // A single output sample needs more input samples than the window holds. Only the last
+        // four of them are used, so the ones before are decoded (to keep the decoder state right)
+        // and dropped, and the resampler is told to skip them.
+        const u32 dropped_count = ((curr_pos + ratio) >> 16) - MAX_BATCH_INPUT_COUNT;
+        for (u32 dropped = 0; dropped < dropped_count;)
+        {
+          const u32 n = std::min(dropped_count - dropped, MAX_BATCH_INPUT_COUNT);
+          std::copy_n(last_samples, 4, window.begin());
+          get_samples(window.data() + 4, n);
+          std::copy_n(window.begin() + n, 4, last_samples);
+          dropped += n;
+        }
+
+        batch_count = 1;
+        input_count = MAX_BATCH_INPUT_COUNT;
+        batch_ratio = ratio - (dropped_count << 16);
+      }
+    }
+    else
+    {
+      batch_count = input_count = std::min(count - done, MAX_BATCH_INPUT_COUNT);
+    }
+
+    std::copy_n(last_samples, 4, window.begin());
+    get_samples(window.data() + 4, input_count);
+    curr_pos = ResampleWindow(window.data(), output + done, batch_count, last_samples, curr_pos,
+                              batch_ratio, srctype, coeffs);
+    done += batch_count;
+  }
+
+  return curr_pos;
+}
+
+u16 ApplyVolumeRamp(const s16* input, s16* output, u32 count, u16 volume, u16 volume_delta)
+{
+  u32 i = 0;
+
+#ifdef _M_X86
+  // 8 samples at a time. The products of a signed 16-bit sample and an unsigned
+  // 16-bit volume always fit in 32 bits, so this matches the scalar code exactly.
+  const __m128i lane_offsets = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+  __m128i volumes = _mm_add_epi16(_mm_set1_epi16(static_cast<s16>(volume)),
+                                  _mm_mullo_epi16(_mm_set1_epi16(static_cast<s16>(volume_delta)),
+                                                  lane_offsets));
+  const __m128i volumes_step = _mm_set1_epi16(static_cast<s16>(volume_delta * 8));
+  const __m128i min_sample = _mm_set1_epi16(-32767);
+
+  const u32 simd_count = count & ~u32(7);
+  for (; i < simd_count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+    // mulhi_epi16 treats the volume as signed, so correct the high half for
+    // volumes with the top bit set.
+    const __m128i lo = _mm_mullo_epi16(samples, volumes);
+    const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(samples, volumes),
+                                     _mm_and_si128(samples, _mm_srai_epi16(volumes, 15)));
+    const __m128i products_lo = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+    const __m128i products_hi = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+    const __m128i result = _mm_max_epi16(_mm_packs_epi32(products_lo, products_hi), min_sample);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), result);
+    volumes = _mm_add_epi16(volumes, volumes_step);
+  }
+  volume += static_cast<u16>(volume_delta * i);
+#endif
+
+  for (; i < count; ++i)
+  {
+    output[i] = std::clamp((s32{input[i]} * volume) >> 15, -32767, 32767);  // -32768 ?
+    volume += volume_delta;
+  }
+
+  return volume;
+}
+}  // namespace DSP::HLE::AX
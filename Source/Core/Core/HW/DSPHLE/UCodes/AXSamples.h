@@ -0,0 +1,56 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <functional>
+
+#include "Common/CommonTypes.h"
+
+// Sample processing functions shared by the GC and Wii AX ucodes. They don't depend on the state
+// of the voice being processed, which also lets them be tested on their own.
+namespace DSP::HLE::AX
+{
+// Writes the next <count> input samples of a voice to <samples>.
+using GetSamplesFunction = std::function<void(s16* samples, u32 count)>;
+
+// Resamples input samples to <count> samples at the wanted sample rate
+// (computed from the ratio, see below).
+//
+// <window> contains the four values from <last_samples> followed by the
+// input samples, of which there must be as many as the resampler consumes.
+// Having the history and the input in one array means that the four most
+// recent samples at any point are contiguous, and the filters can read them
+// directly instead of going through a circular buffer.
+//
+// If srctype is SRCTYPE_POLYPHASE, coefficients need to be provided as well
+// (or the srctype will automatically be changed to LINEAR).
+//
+// Returns the current position after resampling (including fractional part).
+//
+// The input to output ratio is set in <ratio>, which is a floating point num
+// stored as a 32b integer:
+//  * Upper 16 bits of the ratio are the integer part
+//  * Lower 16 bits are the decimal part
+//
+// <curr_pos> is a 32b integer structured in the same way as the ratio: the
+// upper 16 bits are the integer part of the current position in the input
+// stream, and the lower 16 bits are the decimal part.
+//
+// We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
+// avoids discontinuities in the audio stream, especially with very low ratios
+// which interpolate a lot of values between two "real" samples.
+u32 ResampleWindow(const s16* window, s16* output, u32 count, s16* last_samples, u32 curr_pos,
+                   u32 ratio, int srctype, const s16* coeffs);
+
+// Same as ResampleWindow, but reads the input samples with <get_samples>.
+// They are decoded in batches into a fixed size window on the stack, so that
+// decoding and filtering don't have to switch back and forth for every sample.
+u32 ResampleAudio(const GetSamplesFunction& get_samples, s16* output, u32 count, s16* last_samples,
+                  u32 curr_pos, u32 ratio, int srctype, const s16* coeffs);
+
+// Multiplies samples by a volume (1.15 fixed point) which is increased by
+// <volume_delta> after each sample, clamping the results to [-32767, 32767].
+// <input> and <output> may be the same buffer. Returns the final volume.
+u16 ApplyVolumeRamp(const s16* input, s16* output, u32 count, u16 volume, u16 volume_delta);
+}  // namespace DSP::HLE::AX
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <array>
 #include <map>
+#include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -16,6 +17,7 @@
 #include "Core/HW/DSPHLE/MailHandler.h"
 #include "Core/HW/DSPHLE/UCodes/GBA.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
+#include "Core/HW/DSPHLE/UCodes/ZeldaSamples.h"
 
 namespace DSP::HLE
 {
@@ -629,21 +631,25 @@ void ZeldaUCode::RenderAudio()
     if (m_rendering_curr_voice == 0)
       m_renderer.PrepareFrame();
 
-    while (m_rendering_curr_voice < m_rendering_voices_per_frame)
+    // Collect the voices which can be rendered now, so that they are rendered as one batch.
+    std::vector<u16> voice_ids;
+    while (m_rendering_curr_voice < m_rendering_voices_per_frame &&
+           m_rendering_curr_voice < m_sync_max_voice_id)
     {
-      // If we are not meant to render this voice yet, go back to message
-      // processing.
-      if (m_rendering_curr_voice >= m_sync_max_voice_id)
-        return;
-
       // Test the sync flag for this voice, skip it if not set.
       u16 flags = m_sync_voice_skip_flags[m_rendering_curr_voice >> 4];
       u8 bit = 0xF - (m_rendering_curr_voice & 0xF);
       if (flags & (1 << bit))
-        m_renderer.AddVoice(m_rendering_curr_voice);
+        voice_ids.push_back(m_rendering_curr_voice);
 
       m_rendering_curr_voice++;
     }
+    m_renderer.AddVoices(voice_ids);
+
+    // If we are not meant to render the remaining voices yet, go back to
+    // message processing.
+    if (m_rendering_curr_voice < m_rendering_voices_per_frame)
+      return;
 
     if (!(m_flags & LIGHT_PROTOCOL))
       SendCommandAck(CommandAck::STANDARD, 0xFF00 | m_rendering_curr_frame);
@@ -984,13 +990,14 @@ void ZeldaAudioRenderer::PrepareFrame()
 
   // Add reverb data from previous frame.
   ApplyReverb(false);
-  AddBuffersWithVolume(m_buf_front_left_reverb.data(), m_buf_back_left_reverb.data(), 0x50, 0x7FFF);
-  AddBuffersWithVolume(m_buf_front_right_reverb.data(), m_buf_back_left_reverb.data(), 0x50,
-                       0xB820);
-  AddBuffersWithVolume(m_buf_front_left_reverb.data(), m_buf_back_right_reverb.data() + 0x28, 0x28,
-                       0xB820);
-  AddBuffersWithVolume(m_buf_front_right_reverb.data(), m_buf_back_left_reverb.data() + 0x28, 0x28,
-                       0x7FFF);
+  Zelda::AddBuffersWithVolume(m_buf_front_left_reverb.data(), m_buf_back_left_reverb.data(), 0x50,
+                              0x7FFF);
+  Zelda::AddBuffersWithVolume(m_buf_front_right_reverb.data(), m_buf_back_left_reverb.data(), 0x50,
+                              0xB820);
+  Zelda::AddBuffersWithVolume(m_buf_front_left_reverb.data(), m_buf_back_right_reverb.data() + 0x28,
+                              0x28, 0xB820);
+  Zelda::AddBuffersWithVolume(m_buf_front_right_reverb.data(), m_buf_back_left_reverb.data() + 0x28,
+                              0x28, 0x7FFF);
   m_buf_back_left_reverb.fill(0);
   m_buf_back_right_reverb.fill(0);
 
@@ -1105,7 +1112,7 @@ void ZeldaAudioRenderer::ApplyReverb(bool post_rendering)
 #endif
           continue;
         }
-        AddBuffersWithVolume(dest_buffer->data(), buffer.data(), 0x50, dest.volume);
+        Zelda::AddBuffersWithVolume(dest_buffer->data(), buffer.data(), 0x50, dest.volume);
       }
 
       // LSB not set, bit 1 set -> post-filtering.
@@ -1164,14 +1171,32 @@ ZeldaAudioRenderer::MixingBuffer* ZeldaAudioRenderer::BufferForID(u16 buffer_id)
   }
 }
 
-void ZeldaAudioRenderer::AddVoice(u16 voice_id)
+void ZeldaAudioRenderer::AddVoices(const std::vector<u16>& voice_ids)
 {
-  VPB vpb;
-  FetchVPB(voice_id, &vpb);
+  // Most voices are usually inactive, so check that before fetching the whole VPB.
+  std::vector<u16> active_voice_ids;
+  active_voice_ids.reserve(voice_ids.size());
+  for (u16 voice_id : voice_ids)
+  {
+    if (IsVoiceActive(voice_id))
+      active_voice_ids.push_back(voice_id);
+  }
 
-  if (!vpb.enabled || vpb.done)
-    return;
+  // None of the voices accesses the VPB of another one, so all of them are fetched, rendered and
+  // stored in separate passes instead of going back and forth between RAM and the mixing code.
+  std::vector<VPB> vpbs(active_voice_ids.size());
+  for (size_t i = 0; i < vpbs.size(); ++i)
+    FetchVPB(active_voice_ids[i], &vpbs[i]);
+
+  for (VPB& vpb : vpbs)
+    RenderVoice(vpb);
 
+  for (size_t i = 0; i < vpbs.size(); ++i)
+    StoreVPB(active_voice_ids[i], &vpbs[i]);
+}
+
+void ZeldaAudioRenderer::RenderVoice(VPB& vpb)
+{
   MixingBuffer input_samples;
   LoadInputSamples(&input_samples, &vpb);
 
@@ -1306,8 +1331,6 @@ void ZeldaAudioRenderer::AddVoice(u16 voice_id)
   // silence mode.
   if (!vpb.use_constant_sample)
     vpb.reset_vpb = false;
-
-  StoreVPB(voice_id, &vpb);
 }
 
 void ZeldaAudioRenderer::FinalizeFrame()
@@ -1334,6 +1357,16 @@ void ZeldaAudioRenderer::FinalizeFrame()
   m_prepared = false;
 }
 
+bool ZeldaAudioRenderer::IsVoiceActive(u16 voice_id) const
+{
+  const u16* ram_vpbs = (u16*)HLEMemory_Get_Pointer(m_vpb_base_addr);
+  size_t vpb_size = (m_flags & TINY_VPB) ? 0x80 : 0xC0;
+
+  // VPB::enabled and VPB::done are the first two words in both VPB layouts.
+  size_t base_idx = voice_id * vpb_size;
+  return ram_vpbs[base_idx] != 0 && ram_vpbs[base_idx + 1] == 0;
+}
+
 void ZeldaAudioRenderer::FetchVPB(u16 voice_id, VPB* vpb)
 {
   u16* vpb_words = (u16*)vpb;
@@ -1509,25 +1542,8 @@ void ZeldaAudioRenderer::Resample(VPB* vpb, const s16* src, MixingBuffer* dst)
   }
   else
   {
-    for (auto& dst_sample : *dst)
-    {
-      // We have 0x40 * 4 coeffs that need to be selected based on the
-      // most significant bits of the fractional part of the position. 12
-      // bits >> 6 = 6 bits = 0x40. Multiply by 4 since there are 4
-      // consecutive coeffs.
-      u32 coeffs_idx = ((pos & 0xFFF) >> 6) * 4;
-      const s16* coeffs = &m_resampling_coeffs[coeffs_idx];
-      const s16* input = &src[pos >> 12];
-
-      s64 dst_sample_unclamped = 0;
-      for (size_t i = 0; i < 4; ++i)
-        dst_sample_unclamped += (s64)2 * coeffs[i] * input[i];
-      dst_sample_unclamped >>= 16;
-
-      dst_sample = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
-
-      pos += ratio;
-    }
+    pos = Zelda::ResampleInterpolated(dst->data(), dst->size(), src, pos, ratio,
+                                      m_resampling_coeffs);
   }
 
   for (u32 i = 0; i < 4; ++i)
@@ -1713,62 +1729,16 @@ void ZeldaAudioRenderer::DownloadAFCSamplesFromARAM(s16* dst, VPB* vpb, u16 requ
 void ZeldaAudioRenderer::DecodeAFC(VPB* vpb, s16* dst, size_t block_count)
 {
   u32 addr = vpb->GetCurrentARAMAddr();
-  u8* src = (u8*)GetARAMPtr() + addr;
+  const u8* src = (u8*)GetARAMPtr() + addr;
   vpb->SetCurrentARAMAddr(addr + (u32)block_count * vpb->samples_source_type);
 
+  // The source type is also the size of a block.
+  const bool hq = vpb->samples_source_type == VPB::SRC_AFC_HQ_FROM_ARAM;
   for (size_t b = 0; b < block_count; ++b)
   {
-    s16 nibbles[16];
-    s16 delta = 1 << ((*src >> 4) & 0xF);
-    s16 idx = (*src & 0xF);
-    src++;
-
-    if (vpb->samples_source_type == VPB::SRC_AFC_HQ_FROM_ARAM)
-    {
-      for (size_t i = 0; i < 16; i += 2)
-      {
-        nibbles[i + 0] = *src >> 4;
-        nibbles[i + 1] = *src & 0xF;
-        src++;
-      }
-      for (auto& nibble : nibbles)
-      {
-        if (nibble >= 8)
-          nibble -= 16;
-        nibble <<= 11;
-      }
-    }
-    else
-    {
-      for (size_t i = 0; i < 16; i += 4)
-      {
-        nibbles[i + 0] = (*src >> 6) & 3;
-        nibbles[i + 1] = (*src >> 4) & 3;
-        nibbles[i + 2] = (*src >> 2) & 3;
-        nibbles[i + 3] = (*src >> 0) & 3;
-        src++;
-      }
-      for (auto& nibble : nibbles)
-      {
-        if (nibble >= 2)
-          nibble -= 4;
-        nibble <<= 13;
-      }
-    }
-
-    s32 yn1 = *vpb->AFCYN1(), yn2 = *vpb->AFCYN2();
-    for (s16 nibble : nibbles)
-    {
-      s32 sample = delta * nibble + yn1 * m_afc_coeffs[idx * 2] + yn2 * m_afc_coeffs[idx * 2 + 1];
-      sample >>= 11;
-      sample = std::clamp(sample, -0x8000, 0x7fff);
-      *dst++ = (s16)sample;
-      yn2 = yn1;
-      yn1 = sample;
-    }
-
-    *vpb->AFCYN2() = yn2;
-    *vpb->AFCYN1() = yn1;
+    Zelda::DecodeAFCBlock(dst, src, hq, m_afc_coeffs, vpb->AFCYN1(), vpb->AFCYN2());
+    src += vpb->samples_source_type;
+    dst += 16;
   }
 }
 
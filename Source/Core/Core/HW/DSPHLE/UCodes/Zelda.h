@@ -3,11 +3,12 @@
 
 #pragma once
 
-#include <algorithm>
 #include <array>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
+#include "Core/HW/DSPHLE/UCodes/ZeldaSamples.h"
 
 namespace DSP::HLE
 {
@@ -17,7 +18,7 @@ class ZeldaAudioRenderer
 {
 public:
   void PrepareFrame();
-  void AddVoice(u16 voice_id);
+  void AddVoices(const std::vector<u16>& voice_ids);
   void FinalizeFrame();
 
   void SetFlags(u32 flags) { m_flags = flags; }
@@ -39,20 +40,11 @@ private:
   // See Zelda.cpp for the list of possible flags.
   u32 m_flags;
 
-  // Utility functions for audio operations.
-
-  // Apply volume to a buffer. The volume is a fixed point integer, usually
-  // 1.15 or 4.12 in the DAC UCode.
+  // Utility functions for audio operations. See ZeldaSamples.h.
   template <size_t N, size_t B>
   void ApplyVolumeInPlace(std::array<s16, N>* buf, u16 vol)
   {
-    for (size_t i = 0; i < N; ++i)
-    {
-      s32 tmp = (u32)(*buf)[i] * (u32)vol;
-      tmp >>= 16 - B;
-
-      (*buf)[i] = (s16)std::clamp(tmp, -0x8000, 0x7FFF);
-    }
+    Zelda::ApplyVolumeInPlace(buf->data(), N, vol, 16 - B);
   }
   template <size_t N>
   void ApplyVolumeInPlace_1_15(std::array<s16, N>* buf, u16 vol)
@@ -65,36 +57,11 @@ private:
     ApplyVolumeInPlace<N, 4>(buf, vol);
   }
 
-  // Mixes two buffers together while applying a volume to one of them. The
-  // volume ramps up/down in N steps using the provided step delta value.
-  //
-  // Note: On a real GC, the stepping happens in 32 steps instead. But hey,
-  // we can do better here with very low risk. Why not? :)
   template <size_t N>
   s32 AddBuffersWithVolumeRamp(std::array<s16, N>* dst, const std::array<s16, N>& src, s32 vol,
                                s32 step)
   {
-    if (!vol && !step)
-      return vol;
-
-    for (size_t i = 0; i < N; ++i)
-    {
-      (*dst)[i] += ((vol >> 16) * src[i]) >> 16;
-      vol += step;
-    }
-
-    return vol;
-  }
-
-  // Does not use std::array because it needs to be able to process partial
-  // buffers. Volume is in 1.15 format.
-  void AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
-  {
-    while (count--)
-    {
-      s32 vol_src = ((s32)*src++ * (s32)vol) >> 15;
-      *dst++ += std::clamp(vol_src, -0x8000, 0x7FFF);
-    }
+    return Zelda::AddBuffersWithVolumeRamp(dst->data(), src.data(), N, vol, step);
   }
 
   // Whether the frame needs to be prepared or not.
@@ -129,9 +96,13 @@ private:
 
   // Base address where VPBs are stored linearly in RAM.
   u32 m_vpb_base_addr;
+  bool IsVoiceActive(u16 voice_id) const;
   void FetchVPB(u16 voice_id, VPB* vpb);
   void StoreVPB(u16 voice_id, VPB* vpb);
 
+  // Loads the input samples of a voice and mixes them into the mixing buffers.
+  void RenderVoice(VPB& vpb);
+
   // Sine table transferred from MRAM. Contains sin(x) values for x in
   // [0.0;pi/4] (sin(x) in [1.0;0.0]), in 1.15 fixed format.
   std::array<s16, 0x80> m_sine_table{};
@@ -0,0 +1,303 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/HW/DSPHLE/UCodes/ZeldaSamples.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+
+namespace DSP::HLE::Zelda
+{
+void ApplyVolumeInPlace(s16* buf, size_t count, u16 vol, int shift)
+{
+  size_t i = 0;
+
+#ifdef _M_X86
+  // The product of a signed sample and an unsigned volume always fits in 32 bits. mulhi_epi16
+  // treats the volume as signed, so the high half needs to be corrected for volumes with the top
+  // bit set.
+  const __m128i volumes = _mm_set1_epi16(static_cast<s16>(vol));
+  const __m128i volume_sign = _mm_srai_epi16(volumes, 15);
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+  const size_t simd_count = count & ~size_t(7);
+  for (; i < simd_count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+    const __m128i lo = _mm_mullo_epi16(samples, volumes);
+    const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(samples, volumes),
+                                     _mm_and_si128(samples, volume_sign));
+    const __m128i products_lo = _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), shift_count);
+    const __m128i products_hi = _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), shift_count);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i),
+                     _mm_packs_epi32(products_lo, products_hi));
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    s32 tmp = (u32)buf[i] * (u32)vol;
+    tmp >>= shift;
+
+    buf[i] = (s16)std::clamp(tmp, -0x8000, 0x7FFF);
+  }
+}
+
+s32 AddBuffersWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol, s32 step)
+{
+  if (!vol && !step)
+    return vol;
+
+  size_t i = 0;
+
+#ifdef _M_X86
+  // Only the integer part of the volume is used, and multiplying two 16-bit values and keeping
+  // the top half is exactly what mulhi_epi16 does.
+  __m128i volumes_lo = _mm_setr_epi32(vol, vol + step, vol + step * 2, vol + step * 3);
+  __m128i volumes_hi = _mm_add_epi32(volumes_lo, _mm_set1_epi32(step * 4));
+  const __m128i volumes_step = _mm_set1_epi32(step * 8);
+  const size_t simd_count = count & ~size_t(7);
+  for (; i < simd_count; i += 8)
+  {
+    const __m128i volumes = _mm_packs_epi32(_mm_srai_epi32(volumes_lo, 16),
+                                            _mm_srai_epi32(volumes_hi, 16));
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i mixed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_add_epi16(mixed, _mm_mulhi_epi16(volumes, samples)));
+
+    volumes_lo = _mm_add_epi32(volumes_lo, volumes_step);
+    volumes_hi = _mm_add_epi32(volumes_hi, volumes_step);
+  }
+  vol = _mm_cvtsi128_si32(volumes_lo);
+#endif
+
+  for (; i < count; ++i)
+  {
+    dst[i] += ((vol >> 16) * src[i]) >> 16;
+    vol += step;
+  }
+
+  return vol;
+}
+
+void AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  size_t i = 0;
+
+#ifdef _M_X86
+  // Same as ApplyVolumeInPlace, with the results added to dst.
+  const __m128i volumes = _mm_set1_epi16(static_cast<s16>(vol));
+  const __m128i volume_sign = _mm_srai_epi16(volumes, 15);
+  const size_t simd_count = count & ~size_t(7);
+  for (; i < simd_count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i lo = _mm_mullo_epi16(samples, volumes);
+    const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(samples, volumes),
+                                     _mm_and_si128(samples, volume_sign));
+    const __m128i products = _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15),
+                                             _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15));
+    const __m128i mixed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi16(mixed, products));
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    s32 vol_src = ((s32)src[i] * (s32)vol) >> 15;
+    dst[i] += std::clamp(vol_src, -0x8000, 0x7FFF);
+  }
+}
+
+u32 ResampleInterpolated(s16* dst, size_t count, const s16* src, u32 pos, u32 ratio,
+                         const std::array<s16, 0x100>& coeffs)
+{
+  size_t i = 0;
+
+#ifdef _M_X86
+  // 4 samples at a time, each of them a 4-tap dot product. The sums don't fit in 32 bits, so
+  // madd_epi16 computes two partial sums per sample which are combined after shifting them.
+  const __m128i int_min = _mm_set1_epi32(INT32_MIN);
+  const __m128i int_min_fixup = _mm_set1_epi32(0x20000);
+  const __m128i low_bits = _mm_set1_epi32(0x7FFF);
+  const size_t simd_count = count & ~size_t(3);
+  for (; i < simd_count; i += 4)
+  {
+    __m128i partial_sums[2];
+    for (__m128i& sums : partial_sums)
+    {
+      __m128i sample_coeffs[2], inputs[2];
+      for (size_t j = 0; j < 2; ++j)
+      {
+        const s16* coeffs_ptr = &coeffs[((pos & 0xFFF) >> 6) * 4];
+        sample_coeffs[j] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(coeffs_ptr));
+        inputs[j] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&src[pos >> 12]));
+        pos += ratio;
+      }
+      sums = _mm_madd_epi16(_mm_unpacklo_epi64(sample_coeffs[0], sample_coeffs[1]),
+                            _mm_unpacklo_epi64(inputs[0], inputs[1]));
+    }
+
+    // Taps 0-1 and 2-3 of each sample.
+    const __m128 sums_0 = _mm_castsi128_ps(partial_sums[0]);
+    const __m128 sums_1 = _mm_castsi128_ps(partial_sums[1]);
+    __m128i sums_a = _mm_castps_si128(_mm_shuffle_ps(sums_0, sums_1, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i sums_b = _mm_castps_si128(_mm_shuffle_ps(sums_0, sums_1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+    // (2 * (a + b)) >> 16 is (a >> 15) + (b >> 15) plus the carry out of their low 15 bits.
+    // madd_epi16 only overflows when all four inputs are -0x8000, which gives INT32_MIN
+    // instead of 2^31.
+    const __m128i carry = _mm_srai_epi32(
+        _mm_add_epi32(_mm_and_si128(sums_a, low_bits), _mm_and_si128(sums_b, low_bits)), 15);
+    const __m128i fixup =
+        _mm_add_epi32(_mm_and_si128(_mm_cmpeq_epi32(sums_a, int_min), int_min_fixup),
+                      _mm_and_si128(_mm_cmpeq_epi32(sums_b, int_min), int_min_fixup));
+    sums_a = _mm_srai_epi32(sums_a, 15);
+    sums_b = _mm_srai_epi32(sums_b, 15);
+    const __m128i results =
+        _mm_add_epi32(_mm_add_epi32(sums_a, sums_b), _mm_add_epi32(carry, fixup));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&dst[i]), _mm_packs_epi32(results, results));
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    // We have 0x40 * 4 coeffs that need to be selected based on the
+    // most significant bits of the fractional part of the position. 12
+    // bits >> 6 = 6 bits = 0x40. Multiply by 4 since there are 4
+    // consecutive coeffs.
+    u32 coeffs_idx = ((pos & 0xFFF) >> 6) * 4;
+    const s16* sample_coeffs = &coeffs[coeffs_idx];
+    const s16* input = &src[pos >> 12];
+
+    s64 dst_sample_unclamped = 0;
+    for (size_t j = 0; j < 4; ++j)
+      dst_sample_unclamped += (s64)2 * sample_coeffs[j] * input[j];
+    dst_sample_unclamped >>= 16;
+
+    dst[i] = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
+
+    pos += ratio;
+  }
+
+  return pos;
+}
+
+void DecodeAFCBlock(s16* dst, const u8* src, bool hq, const std::array<s16, 0x20>& coeffs,
+                    s16* yn1_ptr, s16* yn2_ptr)
+{
+  s16 delta = 1 << ((*src >> 4) & 0xF);
+  s16 idx = (*src & 0xF);
+  src++;
+
+  // The scaled nibbles don't depend on the previous samples, unlike the filter below, so all
+  // of them are computed first.
+  alignas(16) s32 scaled_nibbles[16];
+#ifdef _M_X86
+  // Put each byte in the top half of a 16-bit lane, so that arithmetic shifts sign extend the
+  // nibbles. LQ blocks only have 4 bytes of nibbles, don't read past them.
+  __m128i bytes;
+  if (hq)
+  {
+    bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+  }
+  else
+  {
+    u32 lq_bytes;
+    std::memcpy(&lq_bytes, src, sizeof(lq_bytes));
+    bytes = _mm_cvtsi32_si128(lq_bytes);
+  }
+  bytes = _mm_unpacklo_epi8(_mm_setzero_si128(), bytes);
+
+  __m128i nibbles[2];
+  if (hq)
+  {
+    const __m128i high = _mm_slli_epi16(_mm_srai_epi16(bytes, 12), 11);
+    const __m128i low = _mm_slli_epi16(_mm_srai_epi16(_mm_slli_epi16(bytes, 4), 12), 11);
+    nibbles[0] = _mm_unpacklo_epi16(high, low);
+    nibbles[1] = _mm_unpackhi_epi16(high, low);
+  }
+  else
+  {
+    const __m128i bits_7_6 = _mm_slli_epi16(_mm_srai_epi16(bytes, 14), 13);
+    const __m128i bits_5_4 = _mm_slli_epi16(_mm_srai_epi16(_mm_slli_epi16(bytes, 2), 14), 13);
+    const __m128i bits_3_2 = _mm_slli_epi16(_mm_srai_epi16(_mm_slli_epi16(bytes, 4), 14), 13);
+    const __m128i bits_1_0 = _mm_slli_epi16(_mm_srai_epi16(_mm_slli_epi16(bytes, 6), 14), 13);
+    const __m128i first_half = _mm_unpacklo_epi16(bits_7_6, bits_5_4);
+    const __m128i second_half = _mm_unpacklo_epi16(bits_3_2, bits_1_0);
+    nibbles[0] = _mm_unpacklo_epi32(first_half, second_half);
+    nibbles[1] = _mm_unpackhi_epi32(first_half, second_half);
+  }
+
+  const __m128i deltas = _mm_set1_epi16(delta);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const __m128i lo = _mm_mullo_epi16(nibbles[i], deltas);
+    const __m128i hi = _mm_mulhi_epi16(nibbles[i], deltas);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&scaled_nibbles[i * 8]),
+                    _mm_unpacklo_epi16(lo, hi));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&scaled_nibbles[i * 8 + 4]),
+                    _mm_unpackhi_epi16(lo, hi));
+  }
+#else
+  s16 nibbles[16];
+  if (hq)
+  {
+    for (size_t i = 0; i < 16; i += 2)
+    {
+      nibbles[i + 0] = *src >> 4;
+      nibbles[i + 1] = *src & 0xF;
+      src++;
+    }
+    for (auto& nibble : nibbles)
+    {
+      if (nibble >= 8)
+        nibble -= 16;
+      nibble <<= 11;
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < 16; i += 4)
+    {
+      nibbles[i + 0] = (*src >> 6) & 3;
+      nibbles[i + 1] = (*src >> 4) & 3;
+      nibbles[i + 2] = (*src >> 2) & 3;
+      nibbles[i + 3] = (*src >> 0) & 3;
+      src++;
+    }
+    for (auto& nibble : nibbles)
+    {
+      if (nibble >= 2)
+        nibble -= 4;
+      nibble <<= 13;
+    }
+  }
+
+  for (size_t i = 0; i < 16; ++i)
+    scaled_nibbles[i] = delta * nibbles[i];
+#endif
+
+  const s32 coef1 = coeffs[idx * 2];
+  const s32 coef2 = coeffs[idx * 2 + 1];
+  s32 yn1 = *yn1_ptr, yn2 = *yn2_ptr;
+  for (s32 scaled_nibble : scaled_nibbles)
+  {
+    s32 sample = scaled_nibble + yn1 * coef1 + yn2 * coef2;
+    sample >>= 11;
+    sample = std::clamp(sample, -0x8000, 0x7fff);
+    *dst++ = (s16)sample;
+    yn2 = yn1;
+    yn1 = sample;
+  }
+
+  *yn2_ptr = yn2;
+  *yn1_ptr = yn1;
+}
+}  // namespace DSP::HLE::Zelda
@@ -0,0 +1,40 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+// Sample processing functions of the Zelda ucode audio renderer. They don't depend on the state of
+// the renderer, which also lets them be tested on their own.
+namespace DSP::HLE::Zelda
+{
+// Apply volume to a buffer. The volume is a fixed point integer, usually
+// 1.15 or 4.12 in the DAC UCode.
+void ApplyVolumeInPlace(s16* buf, size_t count, u16 vol, int shift);
+
+// Mixes two buffers together while applying a volume to one of them. The
+// volume ramps up/down in N steps using the provided step delta value.
+//
+// Note: On a real GC, the stepping happens in 32 steps instead. But hey,
+// we can do better here with very low risk. Why not? :)
+s32 AddBuffersWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol, s32 step);
+
+// Does not use std::array because it needs to be able to process partial
+// buffers. Volume is in 1.15 format.
+void AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol);
+
+// Resamples count samples with 4-tap interpolation, starting at position pos
+// (20.12 format) of src and advancing by ratio for each output sample.
+// Returns the position after the last output sample.
+u32 ResampleInterpolated(s16* dst, size_t count, const s16* src, u32 pos, u32 ratio,
+                         const std::array<s16, 0x100>& coeffs);
+
+// Decodes one AFC block (9 bytes in HQ mode, 5 in LQ mode) to 16 samples.
+// yn1 and yn2 are the two previously decoded samples, and are updated.
+void DecodeAFCBlock(s16* dst, const u8* src, bool hq, const std::array<s16, 0x20>& coeffs,
+                    s16* yn1, s16* yn2);
+}  // namespace DSP::HLE::Zelda
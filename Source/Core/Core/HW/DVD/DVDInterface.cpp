@@ -145,6 +145,8 @@ static u32 s_DIIMMBUF;
 static UDICFG s_DICFG;
 
 static StreamADPCM::ADPCMDecoder s_adpcm_decoder;
+// Reused between DTK callbacks to avoid allocating every few milliseconds
+static std::vector<s16> s_dtk_pcm;
 
 // DTK
 static bool s_stream = false;
@@ -238,19 +240,15 @@ void DoState(PointerWrap& p)
 
 static size_t ProcessDTKSamples(std::vector<s16>* temp_pcm, const std::vector<u8>& audio_data)
 {
-  size_t samples_processed = 0;
-  size_t bytes_processed = 0;
-  while (samples_processed < temp_pcm->size() / 2 && bytes_processed < audio_data.size())
+  const size_t num_blocks = std::min(temp_pcm->size() / 2 / StreamADPCM::SAMPLES_PER_BLOCK,
+                                     audio_data.size() / StreamADPCM::ONE_BLOCK_SIZE);
+  s_adpcm_decoder.DecodeBlocks(temp_pcm->data(), audio_data.data(), num_blocks);
+
+  const size_t samples_processed = num_blocks * StreamADPCM::SAMPLES_PER_BLOCK;
+  for (size_t i = 0; i < samples_processed * 2; ++i)
   {
-    s_adpcm_decoder.DecodeBlock(&(*temp_pcm)[samples_processed * 2], &audio_data[bytes_processed]);
-    for (size_t i = 0; i < StreamADPCM::SAMPLES_PER_BLOCK * 2; ++i)
-    {
-      // TODO: Fix the mixer so it can accept non-byte-swapped samples.
-      s16* sample = &(*temp_pcm)[samples_processed * 2 + i];
-      *sample = Common::swap16(*sample);
-    }
-    samples_processed += StreamADPCM::SAMPLES_PER_BLOCK;
-    bytes_processed += StreamADPCM::ONE_BLOCK_SIZE;
+    // TODO: Fix the mixer so it can accept non-byte-swapped samples.
+    (*temp_pcm)[i] = Common::swap16((*temp_pcm)[i]);
   }
   return samples_processed;
 }
@@ -306,9 +304,9 @@ static void DTKStreamingCallback(DIInterruptType interrupt_type, const std::vect
   if (interrupt_type == DIInterruptType::TCINT)
   {
     // Send audio to the mixer.
-    std::vector<s16> temp_pcm(s_pending_samples * 2, 0);
-    ProcessDTKSamples(&temp_pcm, audio_data);
-    g_sound_stream->GetMixer()->PushStreamingSamples(temp_pcm.data(), s_pending_samples);
+    s_dtk_pcm.assign(s_pending_samples * 2, 0);
+    ProcessDTKSamples(&s_dtk_pcm, audio_data);
+    g_sound_stream->GetMixer()->PushStreamingSamples(s_dtk_pcm.data(), s_pending_samples);
 
     if (s_stream && AudioInterface::IsPlaying())
     {
@@ -1297,14 +1295,16 @@ void SetDriveError(DriveError error)
 }
 
 void FinishExecutingCommand(ReplyType reply_type, DIInterruptType interrupt_type, s64 cycles_late,
-                            const std::vector<u8>& data)
+                            u32 read_length, const std::vector<u8>& data)
 {
-  // The data parameter contains the requested data iff this was called from DVDThread, and is
-  // empty otherwise. DVDThread is the only source of ReplyType::NoReply and ReplyType::DTK.
+  // read_length is the amount of data that was read iff this was called from DVDThread, and is
+  // zero otherwise. The data parameter only contains the requested data for ReplyType::DTK, since
+  // other reads may have been copied to emulated RAM without a buffer. DVDThread is the only
+  // source of ReplyType::NoReply and ReplyType::DTK.
 
   u32 transfer_size = 0;
   if (reply_type == ReplyType::NoReply)
-    transfer_size = static_cast<u32>(data.size());
+    transfer_size = read_length;
   else if (reply_type == ReplyType::Interrupt || reply_type == ReplyType::IOS)
     transfer_size = s_DILENGTH;
 
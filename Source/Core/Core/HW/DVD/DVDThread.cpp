@@ -59,13 +59,21 @@ struct ReadRequest
   u64 realtime_done_us = 0;
 };
 
-using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
+struct ReadResult
+{
+  ReadRequest request;
+  std::vector<u8> buffer;
+
+  // If the data could be accessed without copying, this points into s_disc and buffer is empty.
+  const u8* mapped_data = nullptr;
+};
 
 static void StartDVDThread();
 static void StopDVDThread();
 
 static void DVDThread();
 static void WaitUntilIdle();
+static void DetachResultsFromDisc();
 
 static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offset, u32 length,
                               const DiscIO::Partition& partition,
@@ -95,6 +103,7 @@ void Start()
   s_result_queue_expanded.Reset();
   s_request_queue.Clear();
   s_result_queue.Clear();
+  s_result_map.clear();
 
   // This is reset on every launch for determinism, but it doesn't matter
   // much, because this will never get exposed to the emulated game.
@@ -139,12 +148,23 @@ void DoState(PointerWrap& p)
   // Move all results from s_result_queue to s_result_map because
   // PointerWrap::Do supports std::map but not Common::SPSCQueue.
   // This won't affect the behavior of FinishRead.
-  ReadResult result;
-  while (s_result_queue.Pop(result))
-    s_result_map.emplace(result.first.id, std::move(result));
+  DetachResultsFromDisc();
 
   // Both queues are now empty, so we don't need to savestate them.
-  p.Do(s_result_map);
+  // The results are stored as pairs of request and data to keep the savestate format simple.
+  std::map<u64, std::pair<ReadRequest, std::vector<u8>>> results;
+  if (p.GetMode() != PointerWrap::MODE_READ)
+  {
+    for (const auto& [id, result] : s_result_map)
+      results.emplace(id, std::make_pair(result.request, result.buffer));
+  }
+  p.Do(results);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    s_result_map.clear();
+    for (auto& [id, result] : results)
+      s_result_map.emplace(id, ReadResult{result.first, std::move(result.second)});
+  }
   p.Do(s_next_id);
 
   // s_disc isn't savestated (because it points to files on the
@@ -176,9 +196,29 @@ void DoState(PointerWrap& p)
 void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
+  DetachResultsFromDisc();
   s_disc = std::move(disc);
 }
 
+// Moves all results from s_result_queue to s_result_map, and copies the data of results that
+// point into s_disc into their buffers. Must be called while the DVD thread is idle.
+static void DetachResultsFromDisc()
+{
+  ReadResult result;
+  while (s_result_queue.Pop(result))
+    s_result_map.emplace(result.request.id, std::move(result));
+
+  for (auto& [id, pending_result] : s_result_map)
+  {
+    if (!pending_result.mapped_data)
+      continue;
+
+    pending_result.buffer.assign(pending_result.mapped_data,
+                                 pending_result.mapped_data + pending_result.request.length);
+    pending_result.mapped_data = nullptr;
+  }
+}
+
 bool HasDisc()
 {
   return s_disc != nullptr;
@@ -320,16 +360,17 @@ static void FinishRead(u64 id, s64 cycles_late)
       while (!s_result_queue.Pop(result))
         s_result_queue_expanded.Wait();
 
-      if (result.first.id == id)
+      if (result.request.id == id)
         break;
       else
-        s_result_map.emplace(result.first.id, std::move(result));
+        s_result_map.emplace(result.request.id, std::move(result));
     }
   }
   // We have now obtained the right ReadResult.
 
-  const ReadRequest& request = result.first;
-  const std::vector<u8>& buffer = result.second;
+  const ReadRequest& request = result.request;
+  const u8* data = result.mapped_data ? result.mapped_data : result.buffer.data();
+  const bool read_succeeded = result.mapped_data || result.buffer.size() == request.length;
 
   DEBUG_LOG_FMT(DVDINTERFACE,
                 "Disc has been read. Real time: {} us. "
@@ -341,7 +382,7 @@ static void FinishRead(u64 id, s64 cycles_late)
                     (SystemTimers::GetTicksPerSecond() / 1000000));
 
   DVDInterface::DIInterruptType interrupt;
-  if (buffer.size() != request.length)
+  if (!read_succeeded)
   {
     PanicAlertFmtT("The disc could not be read (at {0:#x} - {1:#x}).", request.dvd_offset,
                    request.dvd_offset + request.length);
@@ -352,13 +393,14 @@ static void FinishRead(u64 id, s64 cycles_late)
   else
   {
     if (request.copy_to_ram)
-      Memory::CopyToEmu(request.output_address, buffer.data(), request.length);
+      Memory::CopyToEmu(request.output_address, data, request.length);
 
     interrupt = DVDInterface::DIInterruptType::TCINT;
   }
 
   // Notify the emulated software that the command has been executed
-  DVDInterface::FinishExecutingCommand(request.reply_type, interrupt, cycles_late, buffer);
+  DVDInterface::FinishExecutingCommand(request.reply_type, interrupt, cycles_late,
+                                       read_succeeded ? request.length : 0, result.buffer);
 }
 
 static void DVDThread()
@@ -377,13 +419,30 @@ static void DVDThread()
     {
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
-      std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      ReadResult result;
+
+      // Data that only gets copied to emulated RAM can be copied straight from a memory-mapped
+      // disc image once the read finishes, without going through a buffer
+      if (request.copy_to_ram)
+      {
+        result.mapped_data =
+            s_disc->GetMappedData(request.dvd_offset, request.length, request.partition);
+      }
+
+      if (!result.mapped_data)
+      {
+        result.buffer.resize(request.length);
+        if (!s_disc->Read(request.dvd_offset, request.length, result.buffer.data(),
+                          request.partition))
+        {
+          result.buffer.resize(0);
+        }
+      }
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
+      result.request = std::move(request);
 
-      s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
+      s_result_queue.Push(std::move(result));
       s_result_queue_expanded.Set();
 
       if (s_dvd_thread_exiting.IsSet())
@@ -11,12 +11,14 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <map>
 #include <memory>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
@@ -208,7 +210,8 @@ struct LogicalMemoryView
 //
 // The 4GB starting at logical_base represents access from the CPU
 // with address translation turned on.  This mapping is computed based
-// on the BAT registers.
+// on the BAT registers. Pages which are translated through the page table
+// are added one at a time when a fastmem access to them faults.
 //
 // Each of these 4GB regions is followed by 4GB of empty space so overflows
 // in address computation in the JIT don't access the wrong memory.
@@ -227,6 +230,11 @@ static std::array<PhysicalMemoryRegion, 4> s_physical_regions;
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+// Logical addresses of the pages which are mapped through the page table, and whether they're
+// writeable
+static std::map<u32, bool> s_page_table_mappings;
+static bool s_page_table_mappings_supported = false;
+
 void Init()
 {
   const auto get_mem1_size = [] {
@@ -343,15 +351,28 @@ bool InitFastmemArena()
   logical_base = physical_base + 0x200000000;
 #endif
 
+  // Windows can only map views at 64 KiB boundaries, and some hosts have pages larger than the
+  // emulated ones.
+  s_page_table_mappings_supported =
+      logical_base && Common::MemArena::GetViewAlignment() <= PowerPC::HW_PAGE_SIZE;
+
   is_fastmem_arena_initialized = true;
   return true;
 }
 
+static void ReleasePageTableMappings()
+{
+  for (const auto& [logical_address, writeable] : s_page_table_mappings)
+    g_arena.ReleaseView(logical_base + logical_address, PowerPC::HW_PAGE_SIZE);
+  s_page_table_mappings.clear();
+}
+
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
   if (!is_fastmem_arena_initialized)
     return;
 
+  ReleasePageTableMappings();
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -396,6 +417,62 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   }
 }
 
+bool AddPageTableMapping(u32 logical_address, u32 translated_address, bool writeable,
+                         bool* new_mapping)
+{
+  *new_mapping = false;
+  if (!is_fastmem_arena_initialized || !s_page_table_mappings_supported)
+    return false;
+
+  u8* base = logical_base + logical_address;
+  const auto it = s_page_table_mappings.find(logical_address);
+  if (it != s_page_table_mappings.end())
+  {
+    if (writeable && !it->second)
+    {
+      Common::UnWriteProtectMemory(base, PowerPC::HW_PAGE_SIZE);
+      it->second = true;
+    }
+    return true;
+  }
+
+  for (const PhysicalMemoryRegion& region : s_physical_regions)
+  {
+    if (!region.active || translated_address < region.physical_address ||
+        translated_address - region.physical_address >= region.size)
+    {
+      continue;
+    }
+
+    const u32 position = region.shm_position + translated_address - region.physical_address;
+    void* view = g_arena.CreateView(position, PowerPC::HW_PAGE_SIZE, base);
+    if (view != base)
+    {
+      if (view)
+        g_arena.ReleaseView(view, PowerPC::HW_PAGE_SIZE);
+      return false;
+    }
+
+    if (!writeable)
+      Common::WriteProtectMemory(base, PowerPC::HW_PAGE_SIZE);
+    s_page_table_mappings.emplace(logical_address, writeable);
+    *new_mapping = true;
+    return true;
+  }
+
+  return false;
+}
+
+void RemovePageTableMapping(u32 logical_address)
+{
+  const auto it = s_page_table_mappings.find(logical_address);
+  if (it == s_page_table_mappings.end())
+    return;
+
+  g_arena.ReleaseView(logical_base + logical_address, PowerPC::HW_PAGE_SIZE);
+  s_page_table_mappings.erase(it);
+}
+
 void DoState(PointerWrap& p)
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -447,6 +524,7 @@ void ShutdownFastmemArena()
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  ReleasePageTableMappings();
 
   physical_base = nullptr;
   logical_base = nullptr;
@@ -68,6 +68,15 @@ void DoState(PointerWrap& p);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+// Maps a page which is translated through the page table into the logical fastmem region. A page
+// which isn't writeable is write protected until it's added again as writeable, and a page has
+// to be removed before it's added with another translation. Returns false if it can't be mapped,
+// and sets new_mapping to whether the page wasn't already mapped.
+// UpdateLogicalMemory removes all of these pages.
+bool AddPageTableMapping(u32 logical_address, u32 translated_address, bool writeable,
+                         bool* new_mapping);
+void RemovePageTableMapping(u32 logical_address);
+
 void Clear();
 
 // Routines to access physically addressed memory, designed for use by
@@ -4,6 +4,7 @@
 // Adapted from in_cube by hcs & destop
 
 #include <algorithm>
+#include <array>
 
 #include "Core/HW/StreamADPCM.h"
 
@@ -12,35 +13,32 @@
 
 namespace StreamADPCM
 {
-static s16 ADPDecodeSample(s32 bits, s32 q, s32& hist1, s32& hist2)
-{
-  s32 hist = 0;
-  switch (q >> 4)
-  {
-  case 0:
-    hist = 0;
-    break;
-  case 1:
-    hist = (hist1 * 0x3c);
-    break;
-  case 2:
-    hist = (hist1 * 0x73) - (hist2 * 0x34);
-    break;
-  case 3:
-    hist = (hist1 * 0x62) - (hist2 * 0x37);
-    break;
-  }
-  hist = std::clamp((hist + 0x20) >> 6, -0x200000, 0x1fffff);
+// Indexed by the upper nibble of the block header bytes. Filters 4-15 aren't used.
+constexpr std::array<std::array<s32, 2>, 16> FILTER_COEFS{{
+    {0, 0},
+    {0x3c, 0},
+    {0x73, -0x34},
+    {0x62, -0x37},
+}};
 
-  s32 cur = (((s16)(bits << 12) >> (q & 0xf)) << 6) + hist;
+// The residuals don't depend on the previous samples, so all of them are expanded before running
+// the filter. This keeps the loop which can't be vectorized as short as possible.
+static void DecodeChannel(s16* pcm, const std::array<s32, SAMPLES_PER_BLOCK>& residuals,
+                          u8 header, s32& hist1, s32& hist2)
+{
+  const s32 coef1 = FILTER_COEFS[header >> 4][0];
+  const s32 coef2 = FILTER_COEFS[header >> 4][1];
 
-  hist2 = hist1;
-  hist1 = cur;
+  for (size_t i = 0; i < SAMPLES_PER_BLOCK; i++)
+  {
+    const s32 hist = std::clamp((hist1 * coef1 + hist2 * coef2 + 0x20) >> 6, -0x200000, 0x1fffff);
+    const s32 cur = residuals[i] + hist;
 
-  cur >>= 6;
-  cur = std::clamp(cur, -0x8000, 0x7fff);
+    hist2 = hist1;
+    hist1 = cur;
 
-  return (s16)cur;
+    pcm[i * 2] = static_cast<s16>(std::clamp(cur >> 6, -0x8000, 0x7fff));
+  }
 }
 
 void ADPCMDecoder::ResetFilter()
@@ -61,12 +59,25 @@ void ADPCMDecoder::DoState(PointerWrap& p)
 
 void ADPCMDecoder::DecodeBlock(s16* pcm, const u8* adpcm)
 {
-  for (int i = 0; i < SAMPLES_PER_BLOCK; i++)
+  const u8* data = adpcm + (ONE_BLOCK_SIZE - SAMPLES_PER_BLOCK);
+  const int shift_l = adpcm[0] & 0xf;
+  const int shift_r = adpcm[1] & 0xf;
+
+  std::array<s32, SAMPLES_PER_BLOCK> residuals_l;
+  std::array<s32, SAMPLES_PER_BLOCK> residuals_r;
+  for (size_t i = 0; i < SAMPLES_PER_BLOCK; i++)
   {
-    pcm[i * 2] = ADPDecodeSample(adpcm[i + (ONE_BLOCK_SIZE - SAMPLES_PER_BLOCK)] & 0xf, adpcm[0],
-                                 m_histl1, m_histl2);
-    pcm[i * 2 + 1] = ADPDecodeSample(adpcm[i + (ONE_BLOCK_SIZE - SAMPLES_PER_BLOCK)] >> 4, adpcm[1],
-                                     m_histr1, m_histr2);
+    residuals_l[i] = (static_cast<s16>(data[i] << 12) >> shift_l) << 6;
+    residuals_r[i] = (static_cast<s16>((data[i] >> 4) << 12) >> shift_r) << 6;
   }
+
+  DecodeChannel(pcm, residuals_l, adpcm[0], m_histl1, m_histl2);
+  DecodeChannel(pcm + 1, residuals_r, adpcm[1], m_histr1, m_histr2);
+}
+
+void ADPCMDecoder::DecodeBlocks(s16* pcm, const u8* adpcm, size_t num_blocks)
+{
+  for (size_t i = 0; i < num_blocks; i++)
+    DecodeBlock(pcm + i * SAMPLES_PER_BLOCK * 2, adpcm + i * ONE_BLOCK_SIZE);
 }
 }  // namespace StreamADPCM
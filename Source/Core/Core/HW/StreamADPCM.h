@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -22,7 +24,9 @@ class ADPCMDecoder
 public:
   void ResetFilter();
   void DoState(PointerWrap& p);
+  // Decodes ONE_BLOCK_SIZE bytes of ADPCM into SAMPLES_PER_BLOCK stereo samples.
   void DecodeBlock(s16* pcm, const u8* adpcm);
+  void DecodeBlocks(s16* pcm, const u8* adpcm, size_t num_blocks);
 
 private:
   s32 m_histl1 = 0;
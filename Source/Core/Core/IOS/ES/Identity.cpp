@@ -5,8 +5,7 @@
 
 #include <vector>
 
-#include <mbedtls/sha1.h>
-
+#include "Common/Crypto/SHA1.h"
 #include "Common/Crypto/ec.h"
 #include "Common/Logging/Log.h"
 #include "Common/ScopeGuard.h"
@@ -171,8 +170,7 @@ ReturnCode ESDevice::VerifySign(const std::vector<u8>& hash, const std::vector<u
     return ret;
   }
 
-  std::array<u8, 20> sha1;
-  mbedtls_sha1_ret(hash.data(), hash.size(), sha1.data());
+  const auto sha1 = Common::SHA1::CalculateDigest(hash);
   ret = iosc.VerifyPublicKeySign(sha1, ap_cert, ecc_signature, PID_ES);
   if (ret != IPC_SUCCESS)
   {
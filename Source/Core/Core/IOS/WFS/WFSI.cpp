@@ -3,7 +3,6 @@
 
 #include "Core/IOS/WFS/WFSI.h"
 
-#include <mbedtls/aes.h>
 #include <stack>
 #include <string>
 #include <utility>
@@ -12,6 +11,7 @@
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
@@ -168,7 +168,7 @@ std::optional<IPCReply> WFSIDevice::IOCtl(const IOCtlRequest& request)
     }
 
     memcpy(m_aes_key, ticket.GetTitleKey(m_ios.GetIOSC()).data(), sizeof(m_aes_key));
-    mbedtls_aes_setkey_dec(&m_aes_ctx, m_aes_key, 128);
+    m_aes_ctx = Common::AES::CreateContextDecrypt(m_aes_key);
 
     SetImportTitleIdAndGroupId(m_tmd.GetTitleId(), m_tmd.GetGroupId());
 
@@ -223,9 +223,17 @@ std::optional<IPCReply> WFSIDevice::IOCtl(const IOCtlRequest& request)
     INFO_LOG_FMT(IOS_WFS, "{}: {:08x} bytes of data at {:08x} from content id {}", ioctl_name,
                  input_size, input_ptr, content_id);
 
+    if (!m_aes_ctx)
+    {
+      ERROR_LOG_FMT(IOS_WFS, "{}: No title key set up by IOCTL_WFSI_IMPORT_TITLE_INIT",
+                    ioctl_name);
+      return_error_code = IPC_EINVAL;
+      break;
+    }
+
     std::vector<u8> decrypted(input_size);
-    mbedtls_aes_crypt_cbc(&m_aes_ctx, MBEDTLS_AES_DECRYPT, input_size, m_aes_iv,
-                          Memory::GetPointer(input_ptr), decrypted.data());
+    m_aes_ctx->Crypt(m_aes_iv, m_aes_iv, Memory::GetPointer(input_ptr), decrypted.data(),
+                     input_size);
 
     m_arc_unpacker.AddBytes(decrypted);
     break;
@@ -233,7 +233,20 @@ bool Jit64::HandleFault(uintptr_t access_address, SContext* ctx)
 
   const auto logical_base_ptr = reinterpret_cast<uintptr_t>(Memory::logical_base);
   if (access_address >= logical_base_ptr && access_address < logical_base_ptr + 0x100010000)
-    return BackPatch(static_cast<u32>(access_address - logical_base_ptr), ctx);
+  {
+    const u32 em_address = static_cast<u32>(access_address - logical_base_ptr);
+
+    // Pages that are translated through the page table get mapped the first time they're
+    // accessed, after which the access can just be retried.
+    const auto it = m_back_patch_info.find(reinterpret_cast<u8*>(ctx->CTX_PC));
+    if (access_address < logical_base_ptr + 0x100000000 && it != m_back_patch_info.end() &&
+        PowerPC::MapFastmemPage(em_address, !it->second.read))
+    {
+      return true;
+    }
+
+    return BackPatch(em_address, ctx);
+  }
 
   return false;
 }
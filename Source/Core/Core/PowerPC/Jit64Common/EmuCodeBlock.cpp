@@ -3,6 +3,7 @@
 
 #include "Core/PowerPC/Jit64Common/EmuCodeBlock.h"
 
+#include <cstddef>
 #include <functional>
 #include <limits>
 
@@ -35,6 +36,35 @@ OpArg SwapImmediate(int access_size, const OpArg& reg_value)
   return Imm8(reg_value.Imm8());
 }
 
+static_assert(sizeof(PowerPC::HostTLBEntry) == 16, "HostTLBLookup relies on the entry size");
+
+// Picks a register for a host TLB lookup. The scratch registers are only saved if they're in use,
+// while any other register always has to be.
+X64Reg PickHostTLBRegister(BitSet32 registers_in_use, BitSet32 excluded, bool* save)
+{
+  for (X64Reg reg : {RSCRATCH, RSCRATCH2, RSCRATCH_EXTRA})
+  {
+    if (!excluded[reg] && !registers_in_use[reg])
+    {
+      *save = false;
+      return reg;
+    }
+  }
+
+  // There are at most three excluded registers.
+  for (X64Reg reg : {RSCRATCH, RSCRATCH2, RSCRATCH_EXTRA, RSI})
+  {
+    if (!excluded[reg])
+    {
+      *save = true;
+      return reg;
+    }
+  }
+
+  ASSERT(false);
+  return INVALID_REG;
+}
+
 OpArg FixImmediate(int access_size, OpArg arg)
 {
   if (arg.IsImm())
@@ -130,6 +160,114 @@ FixupBranch EmuCodeBlock::CheckIfSafeAddress(const OpArg& reg_value, X64Reg reg_
   return J_CC(CC_Z, m_far_code.Enabled());
 }
 
+FixupBranch EmuCodeBlock::HostTLBLookup(X64Reg reg_addr, X64Reg host_offset, X64Reg tmp,
+                                        int access_size, bool write)
+{
+  // Aligned accesses can't cross a page boundary. For the others, the low bits of the address are
+  // rotated into the tag so that it can't match.
+  MOV(32, R(tmp), R(reg_addr));
+  if (access_size == 8)
+  {
+    SHR(32, R(tmp), Imm8(PowerPC::HW_PAGE_INDEX_SHIFT));
+  }
+  else
+  {
+    ROR(32, R(tmp), Imm8(PowerPC::HW_PAGE_INDEX_SHIFT));
+    AND(32, R(tmp), Imm32(0xFFFFF | ((access_size / 8 - 1) << 20)));
+  }
+
+  // The offset of the entry within the table
+  MOV(32, R(host_offset), R(reg_addr));
+  SHR(32, R(host_offset), Imm8(PowerPC::HW_PAGE_INDEX_SHIFT - 4));
+  AND(32, R(host_offset), Imm32(PowerPC::HW_PAGE_INDEX_MASK << 4));
+
+  const int table = PPCSTATE_OFF(host_tlb[0][0]);
+  const int tag = write ? offsetof(PowerPC::HostTLBEntry, write_tag) :
+                          offsetof(PowerPC::HostTLBEntry, tag);
+  CMP(32, R(tmp), MComplex(RPPCSTATE, host_offset, SCALE_1, table + tag));
+  FixupBranch miss = J_CC(CC_NE);
+
+  MOV(64, R(host_offset),
+      MComplex(RPPCSTATE, host_offset, SCALE_1,
+               table + static_cast<int>(offsetof(PowerPC::HostTLBEntry, offset))));
+  return miss;
+}
+
+FixupBranch EmuCodeBlock::HostTLBLoad(X64Reg reg_value, X64Reg reg_addr, int access_size,
+                                      bool sign_extend, BitSet32 registers_in_use)
+{
+  BitSet32 excluded;
+  excluded[reg_addr] = true;
+
+  // reg_value gets overwritten anyway, unless it's also the address.
+  X64Reg host_offset = reg_value;
+  bool save_host_offset = false;
+  if (reg_value == reg_addr)
+    host_offset = PickHostTLBRegister(registers_in_use, excluded, &save_host_offset);
+  excluded[host_offset] = true;
+  bool save_tmp;
+  const X64Reg tmp = PickHostTLBRegister(registers_in_use, excluded, &save_tmp);
+
+  const auto save = [&] {
+    if (save_host_offset)
+      PUSH(host_offset);
+    if (save_tmp)
+      PUSH(tmp);
+  };
+  const auto restore = [&] {
+    if (save_tmp)
+      POP(tmp);
+    if (save_host_offset)
+      POP(host_offset);
+  };
+
+  save();
+  FixupBranch miss = HostTLBLookup(reg_addr, host_offset, tmp, access_size, false);
+  LoadAndSwap(access_size, reg_value, MComplex(host_offset, reg_addr, SCALE_1, 0), sign_extend);
+  restore();
+  FixupBranch hit = J(true);
+  SetJumpTarget(miss);
+  restore();
+  return hit;
+}
+
+FixupBranch EmuCodeBlock::HostTLBStore(const OpArg& reg_value, X64Reg reg_addr, int access_size,
+                                       bool swap, BitSet32 registers_in_use)
+{
+  BitSet32 excluded;
+  excluded[reg_addr] = true;
+  if (reg_value.IsSimpleReg())
+    excluded[reg_value.GetSimpleReg()] = true;
+
+  bool save_host_offset;
+  const X64Reg host_offset = PickHostTLBRegister(registers_in_use, excluded, &save_host_offset);
+  excluded[host_offset] = true;
+  bool save_tmp;
+  const X64Reg tmp = PickHostTLBRegister(registers_in_use, excluded, &save_tmp);
+
+  const auto save = [&] {
+    if (save_host_offset)
+      PUSH(host_offset);
+    if (save_tmp)
+      PUSH(tmp);
+  };
+  const auto restore = [&] {
+    if (save_tmp)
+      POP(tmp);
+    if (save_host_offset)
+      POP(host_offset);
+  };
+
+  save();
+  FixupBranch miss = HostTLBLookup(reg_addr, host_offset, tmp, access_size, true);
+  WriteRegToMemOperand(reg_value, MComplex(host_offset, reg_addr, SCALE_1, 0), access_size, swap);
+  restore();
+  FixupBranch hit = J(true);
+  SetJumpTarget(miss);
+  restore();
+  return hit;
+}
+
 void EmuCodeBlock::UnsafeLoadRegToReg(X64Reg reg_addr, X64Reg reg_value, int accessSize, s32 offset,
                                       bool signExtend)
 {
@@ -155,7 +293,13 @@ void EmuCodeBlock::UnsafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acc
     info->nonAtomicSwapStore = false;
   }
 
-  OpArg dest = MComplex(RMEM, reg_addr, SCALE_1, offset);
+  WriteRegToMemOperand(reg_value, MComplex(RMEM, reg_addr, SCALE_1, offset), accessSize, swap,
+                       info);
+}
+
+void EmuCodeBlock::WriteRegToMemOperand(OpArg reg_value, const OpArg& dest, int accessSize,
+                                        bool swap, MovInfo* info)
+{
   if (reg_value.IsImm())
   {
     if (swap)
@@ -395,6 +539,12 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     SetJumpTarget(slow);
   }
 
+  // Addresses that are translated through the page table don't have to leave JIT code either,
+  // as long as the host TLB has them.
+  FixupBranch tlb_hit;
+  if (dr_set)
+    tlb_hit = HostTLBLoad(reg_value, reg_addr, accessSize, signExtend, registersInUse);
+
   // Helps external systems know which instruction triggered the read.
   // Invalid for calls from Jit64AsmCommon routines
   if (!(flags & SAFE_LOADSTORE_NO_UPDATE_PC))
@@ -441,6 +591,8 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     }
     SetJumpTarget(exit);
   }
+  if (dr_set)
+    SetJumpTarget(tlb_hit);
 }
 
 void EmuCodeBlock::SafeLoadToRegImmediate(X64Reg reg_value, u32 address, int accessSize,
@@ -563,6 +715,10 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     SetJumpTarget(slow);
   }
 
+  FixupBranch tlb_hit;
+  if (dr_set)
+    tlb_hit = HostTLBStore(reg_value, reg_addr, accessSize, swap, registersInUse);
+
   // PC is used by memory watchpoints (if enabled) or to print accurate PC locations in debug logs
   // Invalid for calls from Jit64AsmCommon routines
   if (!(flags & SAFE_LOADSTORE_NO_UPDATE_PC))
@@ -613,6 +769,8 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     }
     SetJumpTarget(exit);
   }
+  if (dr_set)
+    SetJumpTarget(tlb_hit);
 }
 
 void EmuCodeBlock::SafeWriteRegToReg(Gen::X64Reg reg_value, Gen::X64Reg reg_addr, int accessSize,
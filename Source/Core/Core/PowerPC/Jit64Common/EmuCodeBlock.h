@@ -55,6 +55,19 @@ public:
 
   Gen::FixupBranch CheckIfSafeAddress(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
                                       BitSet32 registers_in_use);
+
+  // Looks up the page of reg_addr in the data side of the host TLB. On a hit, falls through with
+  // host_offset holding what has to be added to reg_addr to get a host pointer. Jumps to the
+  // returned FixupBranch on a miss, which includes accesses that aren't aligned.
+  Gen::FixupBranch HostTLBLookup(Gen::X64Reg reg_addr, Gen::X64Reg host_offset, Gen::X64Reg tmp,
+                                 int access_size, bool write);
+  // Do the whole access if HostTLBLookup hits, and jump to the returned FixupBranch afterwards.
+  // On a miss, they fall through with all registers intact.
+  Gen::FixupBranch HostTLBLoad(Gen::X64Reg reg_value, Gen::X64Reg reg_addr, int access_size,
+                               bool sign_extend, BitSet32 registers_in_use);
+  Gen::FixupBranch HostTLBStore(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
+                                int access_size, bool swap, BitSet32 registers_in_use);
+
   void UnsafeLoadRegToReg(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
                           s32 offset = 0, bool signExtend = false);
   void UnsafeLoadRegToRegNoSwap(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
@@ -67,6 +80,8 @@ public:
 
   bool UnsafeLoadToReg(Gen::X64Reg reg_value, Gen::OpArg opAddress, int accessSize, s32 offset,
                        bool signExtend, Gen::MovInfo* info = nullptr);
+  void WriteRegToMemOperand(Gen::OpArg reg_value, const Gen::OpArg& dest, int accessSize,
+                            bool swap, Gen::MovInfo* info = nullptr);
 
   // Generate a load/write from the MMIO handler for a given address. Only
   // call for known addresses in MMIO range (MMIO::IsMMIOAddress).
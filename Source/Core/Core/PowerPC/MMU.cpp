@@ -114,6 +114,25 @@ struct TranslateAddressResult
 template <const XCheckTLBFlag flag>
 static TranslateAddressResult TranslateAddress(u32 address);
 
+// Returns a host pointer for a data access if its page is in the host TLB. Accesses that cross
+// a page boundary always miss.
+template <const XCheckTLBFlag flag>
+static u8* LookupHostTLB(u32 address, u32 size)
+{
+  static_assert(flag == XCheckTLBFlag::Read || flag == XCheckTLBFlag::Write);
+
+  if ((address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - size)
+    return nullptr;
+
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const HostTLBEntry& entry = ppcState.host_tlb[0][tag & HW_PAGE_INDEX_MASK];
+  if ((flag == XCheckTLBFlag::Write ? entry.write_tag : entry.tag) != tag)
+    return nullptr;
+
+  ppcState.tlb_stats.host_hits++;
+  return reinterpret_cast<u8*>(entry.offset + address);
+}
+
 // Nasty but necessary. Super Mario Galaxy pointer relies on this stuff.
 static u32 EFB_Read(const u32 addr)
 {
@@ -174,6 +193,16 @@ static T ReadFromHardware(u32 em_address)
 {
   if (!never_translate && MSR.DR)
   {
+    if constexpr (flag == XCheckTLBFlag::Read)
+    {
+      if (const u8* host_ptr = LookupHostTLB<flag>(em_address, sizeof(T)))
+      {
+        T value;
+        std::memcpy(&value, host_ptr, sizeof(T));
+        return bswap(value);
+      }
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -282,6 +311,16 @@ static void WriteToHardware(u32 em_address, const u32 data, const u32 size)
 
   if (!never_translate && MSR.DR)
   {
+    if constexpr (flag == XCheckTLBFlag::Write)
+    {
+      if (u8* host_ptr = LookupHostTLB<flag>(em_address, size))
+      {
+        const u32 swapped_data = Common::swap32(Common::RotateRight(data, size * 8));
+        std::memcpy(host_ptr, &swapped_data, size);
+        return;
+      }
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -1203,6 +1242,94 @@ enum class TLBLookupResult
   UpdateC
 };
 
+// Returns the host TLB entry for the most recently used way of a TLB set, which is invalid if the
+// way can't be used there.
+static HostTLBEntry MakeHostTLBEntry(bool opcode, u32 set)
+{
+  const TLBEntry& tlbe = ppcState.tlb[opcode][set];
+  HostTLBEntry entry;
+
+  const u32 tag = tlbe.tag[tlbe.recent];
+  if (tag == TLBEntry::INVALID_TAG)
+    return entry;
+
+  // The BATs take priority over the page table.
+  const u32 effective_address = tag << HW_PAGE_INDEX_SHIFT;
+  const BatTable& bat_table = opcode ? ibat_table : dbat_table;
+  if ((bat_table[effective_address >> BAT_INDEX_SHIFT] & BAT_MAPPED_BIT) != 0)
+    return entry;
+
+  const u32 physical_address = tlbe.paddr[tlbe.recent];
+  if (opcode)
+  {
+    entry.offset = static_cast<u32>(physical_address - effective_address);
+    entry.tag = tag;
+    return entry;
+  }
+
+  // Like with fastmem, uncached memory and memchecks are left to the slow path.
+  const UPTE_Hi pte2(tlbe.pte[tlbe.recent]);
+  if ((pte2.WIMG & 0b1100) != 0 || memchecks.OverlapsMemcheck(effective_address, HW_PAGE_SIZE))
+    return entry;
+
+  u8* host_page;
+  if (Memory::m_pRAM && physical_address < Memory::GetRamSizeReal())
+  {
+    host_page = &Memory::m_pRAM[physical_address];
+  }
+  else if (Memory::m_pEXRAM && (physical_address >> 28) == 0x1 &&
+           (physical_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+  {
+    host_page = &Memory::m_pEXRAM[physical_address & 0x0FFFFFFF];
+  }
+  else
+  {
+    return entry;
+  }
+
+  entry.offset = reinterpret_cast<uintptr_t>(host_page) - effective_address;
+  entry.tag = tag;
+  if (pte2.C != 0)
+    entry.write_tag = tag;
+  return entry;
+}
+
+// Pages in the logical fastmem region which are translated through the page table are only
+// mapped while they're in the host TLB, so that accessing them has the same effect on the TLB.
+static void RemoveFastmemPage(const HostTLBEntry& entry)
+{
+  if (entry.tag != TLBEntry::INVALID_TAG)
+    Memory::RemovePageTableMapping(entry.tag << HW_PAGE_INDEX_SHIFT);
+}
+
+// Copies the most recently used way of a TLB set to the host TLB, if it can be used there.
+static void UpdateHostTLBEntry(bool opcode, u32 set)
+{
+  HostTLBEntry& entry = ppcState.host_tlb[opcode][set];
+  const HostTLBEntry new_entry = MakeHostTLBEntry(opcode, set);
+  if (!opcode && (new_entry.tag != entry.tag || new_entry.offset != entry.offset))
+    RemoveFastmemPage(entry);
+  entry = new_entry;
+}
+
+static void InvalidateHostTLB(bool opcode)
+{
+  for (HostTLBEntry& entry : ppcState.host_tlb[opcode])
+    entry.Invalidate();
+}
+
+// Called when a lookup hits a TLB way.
+static void SetRecentTLBWay(bool opcode, u32 tag, u32 way)
+{
+  const u32 set = tag & HW_PAGE_INDEX_MASK;
+  ppcState.tlb[opcode][set].recent = way;
+  ppcState.tlb_stats.tlb_hits++;
+
+  // Either the other way was the most recent one, or the host TLB entry was dropped.
+  if (ppcState.host_tlb[opcode][set].tag != tag)
+    UpdateHostTLBEntry(opcode, set);
+}
+
 static TLBLookupResult LookupTLBPageAddress(const XCheckTLBFlag flag, const u32 vpa, u32* paddr,
                                             bool* wi)
 {
@@ -1220,12 +1347,13 @@ static TLBLookupResult LookupTLBPageAddress(const XCheckTLBFlag flag, const u32
       {
         pte2.C = 1;
         tlbe.pte[0] = pte2.Hex;
+        UpdateHostTLBEntry(false, tag & HW_PAGE_INDEX_MASK);
         return TLBLookupResult::UpdateC;
       }
     }
 
     if (!IsNoExceptionFlag(flag))
-      tlbe.recent = 0;
+      SetRecentTLBWay(IsOpcodeFlag(flag), tag, 0);
 
     *paddr = tlbe.paddr[0] | (vpa & 0xfff);
     *wi = (pte2.WIMG & 0b1100) != 0;
@@ -1243,12 +1371,13 @@ static TLBLookupResult LookupTLBPageAddress(const XCheckTLBFlag flag, const u32
       {
         pte2.C = 1;
         tlbe.pte[1] = pte2.Hex;
+        UpdateHostTLBEntry(false, tag & HW_PAGE_INDEX_MASK);
         return TLBLookupResult::UpdateC;
       }
     }
 
     if (!IsNoExceptionFlag(flag))
-      tlbe.recent = 1;
+      SetRecentTLBWay(IsOpcodeFlag(flag), tag, 1);
 
     *paddr = tlbe.paddr[1] | (vpa & 0xfff);
     *wi = (pte2.WIMG & 0b1100) != 0;
@@ -1270,6 +1399,7 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE_Hi pte2, const u32 add
   tlbe.paddr[index] = pte2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = pte2.Hex;
   tlbe.tag[index] = tag;
+  UpdateHostTLBEntry(IsOpcodeFlag(flag), tag & HW_PAGE_INDEX_MASK);
 }
 
 void InvalidateTLBEntry(u32 address)
@@ -1278,6 +1408,9 @@ void InvalidateTLBEntry(u32 address)
 
   ppcState.tlb[0][entry_index].Invalidate();
   ppcState.tlb[1][entry_index].Invalidate();
+  RemoveFastmemPage(ppcState.host_tlb[0][entry_index]);
+  ppcState.host_tlb[0][entry_index].Invalidate();
+  ppcState.host_tlb[1][entry_index].Invalidate();
 }
 
 union EffectiveAddress
@@ -1321,6 +1454,9 @@ static TranslateAddressResult TranslatePageAddress(const EffectiveAddress addres
     return TranslateAddressResult{TranslateAddressResultEnum::PAGE_FAULT, 0};
   }
 
+  if (!IsNoExceptionFlag(flag))
+    ppcState.tlb_stats.table_walks++;
+
   const u32 offset = address.offset;          // 12 bit
   const u32 page_index = address.page_index;  // 16 bit
   const u32 VSID = sr.VSID;                   // 24 bit
@@ -1514,6 +1650,9 @@ void DBATUpdated()
     UpdateFakeMMUBat(dbat_table, 0x70000000);
   }
 
+  // The host TLB depends on the BATs and on memchecks, which also end up here.
+  InvalidateHostTLB(false);
+
 #ifndef _ARCH_32
   Memory::UpdateLogicalMemory(dbat_table);
 #endif
@@ -1535,6 +1674,7 @@ void IBATUpdated()
     UpdateFakeMMUBat(ibat_table, 0x40000000);
     UpdateFakeMMUBat(ibat_table, 0x70000000);
   }
+  InvalidateHostTLB(true);
   JitInterface::ClearSafe();
 }
 
@@ -1547,12 +1687,54 @@ static TranslateAddressResult TranslateAddress(u32 address)
 {
   bool wi = false;
 
+  if (flag == XCheckTLBFlag::Opcode)
+  {
+    const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+    const HostTLBEntry& entry = ppcState.host_tlb[1][tag & HW_PAGE_INDEX_MASK];
+    if (entry.tag == tag)
+    {
+      ppcState.tlb_stats.host_hits++;
+      return TranslateAddressResult{TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED,
+                                    static_cast<u32>(entry.offset + address)};
+    }
+  }
+
   if (TranslateBatAddess(IsOpcodeFlag(flag) ? ibat_table : dbat_table, &address, &wi))
     return TranslateAddressResult{TranslateAddressResultEnum::BAT_TRANSLATED, address, wi};
 
   return TranslatePageAddress(EffectiveAddress{address}, flag, &wi);
 }
 
+bool MapFastmemPage(u32 address, bool write)
+{
+  // The access which faulted does this same translation whether or not the page gets mapped, so
+  // doing it here doesn't change what the TLB and the page table end up looking like.
+  const TranslateAddressResult result = write ? TranslateAddress<XCheckTLBFlag::Write>(address) :
+                                                TranslateAddress<XCheckTLBFlag::Read>(address);
+  if (result.result != TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED)
+    return false;
+
+  // Pages that have never been written to are mapped read-only, so that the first write to them
+  // faults and sets the C bit.
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const HostTLBEntry& entry = ppcState.host_tlb[0][tag & HW_PAGE_INDEX_MASK];
+  const bool writeable = entry.write_tag == tag;
+  if (entry.tag != tag || (write && !writeable))
+    return false;
+
+  bool new_mapping;
+  if (!Memory::AddPageTableMapping(tag << HW_PAGE_INDEX_SHIFT, result.address & ~0xfffU, writeable,
+                                   &new_mapping))
+  {
+    return false;
+  }
+
+  // Making a read-only page writeable doesn't map another page
+  if (new_mapping)
+    ppcState.tlb_stats.fastmem_pages++;
+  return true;
+}
+
 std::optional<u32> GetTranslatedAddress(u32 address)
 {
   auto result = TranslateAddress<XCheckTLBFlag::NoException>(address);
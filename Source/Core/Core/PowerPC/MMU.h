@@ -219,4 +219,8 @@ constexpr u32 HW_PAGE_INDEX_SHIFT = 12;
 constexpr u32 HW_PAGE_INDEX_MASK = 0x3f;
 
 std::optional<u32> GetTranslatedAddress(u32 address);
+
+// Called by the JIT when a fastmem access to the logical memory region faults. If the address is
+// translated through the page table, its page is mapped there so that the access can be retried.
+bool MapFastmemPage(u32 address, bool write);
 }  // namespace PowerPC
@@ -273,6 +273,8 @@ void Reset()
   ppcState.pagetable_base = 0;
   ppcState.pagetable_hashmask = 0;
   ppcState.tlb = {};
+  ppcState.host_tlb = {};
+  ppcState.tlb_stats = {};
 
   ResetRegisters();
   ppcState.iCache.Reset();
@@ -293,6 +295,18 @@ void ScheduleInvalidateCacheThreadSafe(u32 address)
 
 void Shutdown()
 {
+  const TLBStats& stats = ppcState.tlb_stats;
+  const u64 translations = stats.host_hits + stats.tlb_hits + stats.table_walks;
+  if (translations != 0)
+  {
+    INFO_LOG_FMT(POWERPC,
+                 "Page table translations for {}: {} ({:.2f}% host TLB hits outside of JIT code, "
+                 "{:.2f}% TLB hits, {:.2f}% page table walks), {} pages mapped into fastmem",
+                 SConfig::GetInstance().GetGameID(), translations,
+                 100.0 * stats.host_hits / translations, 100.0 * stats.tlb_hits / translations,
+                 100.0 * stats.table_walks / translations, stats.fastmem_pages);
+  }
+
   InjectExternalCPUCore(nullptr);
   JitInterface::Shutdown();
   s_interpreter->Shutdown();
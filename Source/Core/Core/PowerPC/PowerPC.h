@@ -62,6 +62,41 @@ struct TLBEntry
   void Invalidate() { tag.fill(INVALID_TAG); }
 };
 
+// A copy of the most recently used way of a TLB set, in a form that can be checked without
+// going through the BATs and the TLB. Hitting it leaves the TLB exactly as a TLB hit would, so
+// it doesn't change which translations the TLB keeps. Data TLB entries are only filled in for
+// pages that can be accessed directly in host memory.
+struct HostTLBEntry
+{
+  // Effective page number
+  u32 tag = TLBEntry::INVALID_TAG;
+  // Same as tag, but only set if writes don't have to set the C bit of the PTE first
+  u32 write_tag = TLBEntry::INVALID_TAG;
+  // Added to an effective address to get a host pointer (data TLB) or a physical address
+  // (instruction TLB)
+  uintptr_t offset = 0;
+
+  void Invalidate()
+  {
+    tag = TLBEntry::INVALID_TAG;
+    write_tag = TLBEntry::INVALID_TAG;
+  }
+};
+
+// Page table translation counters, reported when emulation stops.
+struct TLBStats
+{
+  // Accesses that hit the host TLB. Only lookups done in C++ are counted, not the ones that JIT
+  // code does inline, so that the fast path doesn't have to update memory on every access.
+  u64 host_hits = 0;
+  // Other accesses that hit the TLB
+  u64 tlb_hits = 0;
+  // Accesses that had to search the page table
+  u64 table_walks = 0;
+  // Pages mapped into fastmem after an access to them faulted
+  u64 fastmem_pages = 0;
+};
+
 struct PairedSingle
 {
   u64 PS0AsU64() const { return ps0; }
@@ -166,6 +201,8 @@ struct PowerPCState
   u8* stored_stack_pointer = nullptr;
 
   std::array<std::array<TLBEntry, TLB_SIZE / TLB_WAYS>, NUM_TLBS> tlb;
+  std::array<std::array<HostTLBEntry, TLB_SIZE / TLB_WAYS>, NUM_TLBS> host_tlb;
+  TLBStats tlb_stats;
 
   u32 pagetable_base = 0;
   u32 pagetable_hashmask = 0;
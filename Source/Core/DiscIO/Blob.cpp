@@ -5,17 +5,20 @@
 #include <cstddef>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
 #include "Common/CDUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/CISOBlob.h"
 #include "DiscIO/CompressedBlob.h"
+#include "DiscIO/DCSBlob.h"
 #include "DiscIO/DirectoryBlob.h"
 #include "DiscIO/DriveBlob.h"
 #include "DiscIO/FileBlob.h"
@@ -49,6 +52,8 @@ std::string GetName(BlobType blob_type, bool translate)
     return "WIA";
   case BlobType::RVZ:
     return "RVZ";
+  case BlobType::DCS:
+    return "DCS";
   default:
     return "";
   }
@@ -56,23 +61,61 @@ std::string GetName(BlobType blob_type, bool translate)
 
 void SectorReader::SetSectorSize(int blocksize)
 {
+  std::lock_guard read_lock(m_read_mutex);
+  std::lock_guard cache_lock(m_cache_mutex);
   m_block_size = std::max(blocksize, 0);
-  for (auto& cache_entry : m_cache)
-  {
-    cache_entry.Reset();
-    cache_entry.data.resize(m_chunk_blocks * m_block_size);
-  }
+  ResetCache();
 }
 
 void SectorReader::SetChunkSize(int block_cnt)
 {
+  std::lock_guard read_lock(m_read_mutex);
+  std::lock_guard cache_lock(m_cache_mutex);
   m_chunk_blocks = std::max(block_cnt, 1);
-  // Clear cache and resize the data arrays
-  SetSectorSize(m_block_size);
+  ResetCache();
+}
+
+void SectorReader::SetCacheSize(u64 bytes)
+{
+  std::lock_guard read_lock(m_read_mutex);
+  std::lock_guard cache_lock(m_cache_mutex);
+  m_cache_size = bytes;
+  ResetCache();
+}
+
+void SectorReader::SetPrefetchSize(u64 bytes)
+{
+  m_prefetch_size = bytes;
+}
+
+SectorReader::CacheStats SectorReader::GetCacheStats() const
+{
+  return {m_cache_hits, m_cache_misses, m_prefetched_chunks, m_bytes_read_from_storage};
 }
 
 SectorReader::~SectorReader()
 {
+  StopPrefetching();
+
+  INFO_LOG_FMT(DISCIO, "Sector cache: {} hits, {} misses, {} chunks prefetched, {} bytes read",
+               m_cache_hits.load(), m_cache_misses.load(), m_prefetched_chunks.load(),
+               m_bytes_read_from_storage.load());
+}
+
+void SectorReader::StopPrefetching()
+{
+  m_prefetch_thread.Cancel();
+}
+
+void SectorReader::ResetCache()
+{
+  const u64 chunk_bytes = std::max<u64>(1, static_cast<u64>(m_chunk_blocks) * m_block_size);
+  m_cache.clear();
+  m_cache.resize(std::max<u64>(2, m_cache_size / chunk_bytes));
+  m_read_buffer.clear();
+  m_prefetch_buffer.clear();
+  m_last_chunk = std::numeric_limits<u64>::max();
+  m_prefetch_end = 0;
 }
 
 const SectorReader::Cache* SectorReader::FindCacheLine(u64 block_num)
@@ -82,40 +125,54 @@ const SectorReader::Cache* SectorReader::FindCacheLine(u64 block_num)
   if (itr == m_cache.end())
     return nullptr;
 
-  itr->MarkUsed();
+  itr->last_use = ++m_cache_use_counter;
   return &*itr;
 }
 
 SectorReader::Cache* SectorReader::GetEmptyCacheLine()
 {
-  Cache* oldest = &m_cache[0];
   // Find the Least Recently Used cache line to replace.
-  std::for_each(m_cache.begin() + 1, m_cache.end(), [&](Cache& line) {
-    if (line.IsLessRecentlyUsedThan(*oldest))
-    {
-      oldest->ShiftLRU();
-      oldest = &line;
-      return;
-    }
-    line.ShiftLRU();
-  });
+  Cache* oldest = &*std::min_element(
+      m_cache.begin(), m_cache.end(),
+      [](const Cache& a, const Cache& b) { return a.last_use < b.last_use; });
   oldest->Reset();
   return oldest;
 }
 
-const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num)
+const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num,
+                                                      std::unique_lock<std::mutex>& cache_lock)
 {
   if (auto entry = FindCacheLine(block_num))
+  {
+    ++m_cache_hits;
+    return entry;
+  }
+
+  cache_lock.unlock();
+  std::lock_guard read_lock(m_read_mutex);
+  cache_lock.lock();
+
+  // The prefetch thread may have loaded the block while we were waiting.
+  if (auto entry = FindCacheLine(block_num))
+  {
+    ++m_cache_hits;
     return entry;
+  }
 
   // Cache miss. Fault in the missing entry.
-  Cache* cache = GetEmptyCacheLine();
+  ++m_cache_misses;
+  cache_lock.unlock();
   // We only read aligned chunks, this avoids duplicate overlapping entries.
-  u64 chunk_idx = block_num / m_chunk_blocks;
-  u32 blocks_read = ReadChunk(cache->data.data(), chunk_idx);
+  const u64 chunk_idx = block_num / m_chunk_blocks;
+  m_read_buffer.resize(m_chunk_blocks * m_block_size);
+  const u32 blocks_read = ReadChunk(m_read_buffer.data(), chunk_idx);
+  cache_lock.lock();
   if (!blocks_read)
     return nullptr;
-  cache->Fill(chunk_idx * m_chunk_blocks, blocks_read);
+
+  Cache* cache = GetEmptyCacheLine();
+  std::swap(cache->data, m_read_buffer);
+  cache->Fill(chunk_idx * m_chunk_blocks, blocks_read, ++m_cache_use_counter);
 
   // Secondary check for out-of-bounds read.
   // If we got less than m_chunk_blocks, we may still have missed.
@@ -124,6 +181,66 @@ const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num)
   return cache->Contains(block_num) ? cache : nullptr;
 }
 
+void SectorReader::Prefetch(u64 chunk_num)
+{
+  if (chunk_num == m_last_chunk)
+    return;
+
+  const bool sequential = chunk_num == m_last_chunk + 1;
+  m_last_chunk = chunk_num;
+  if (!sequential)
+  {
+    // Whatever is still queued is unlikely to be needed any more
+    if (m_prefetch_end != 0)
+      m_prefetch_thread.Clear();
+    m_prefetch_end = 0;
+    return;
+  }
+
+  const u64 chunk_bytes = static_cast<u64>(m_chunk_blocks) * m_block_size;
+  const u64 end_block = (GetDataSize() + m_block_size - 1) / m_block_size;
+  if (m_prefetch_size == 0 || chunk_bytes == 0 || end_block == 0)
+    return;
+
+  // Never prefetch so much that prefetched chunks would push each other out of the cache
+  const u64 chunks_to_prefetch = std::clamp<u64>(m_prefetch_size / chunk_bytes, 1,
+                                                 std::max<size_t>(1, m_cache.size() / 2));
+  const u64 end_chunk = std::min(chunk_num + 1 + chunks_to_prefetch,
+                                 (end_block + m_chunk_blocks - 1) / m_chunk_blocks);
+
+  if (!m_prefetch_thread_started)
+  {
+    m_prefetch_thread.Reset([this](u64 chunk) { PrefetchChunk(chunk); });
+    m_prefetch_thread_started = true;
+  }
+
+  m_prefetch_end = std::max(m_prefetch_end, chunk_num + 1);
+
+  for (; m_prefetch_end < end_chunk; ++m_prefetch_end)
+    m_prefetch_thread.EmplaceItem(m_prefetch_end);
+}
+
+void SectorReader::PrefetchChunk(u64 chunk_num)
+{
+  std::lock_guard read_lock(m_read_mutex);
+  {
+    std::lock_guard cache_lock(m_cache_mutex);
+    if (FindCacheLine(chunk_num * m_chunk_blocks))
+      return;
+  }
+
+  m_prefetch_buffer.resize(m_chunk_blocks * m_block_size);
+  const u32 blocks_read = ReadChunk(m_prefetch_buffer.data(), chunk_num);
+  if (!blocks_read)
+    return;
+
+  std::lock_guard cache_lock(m_cache_mutex);
+  Cache* cache = GetEmptyCacheLine();
+  std::swap(cache->data, m_prefetch_buffer);
+  cache->Fill(chunk_num * m_chunk_blocks, blocks_read, ++m_cache_use_counter);
+  ++m_prefetched_chunks;
+}
+
 bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
 {
   if (offset + size > GetDataSize())
@@ -133,11 +250,12 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
   u64 block = 0;
   u32 position_in_block = static_cast<u32>(offset % m_block_size);
 
+  std::unique_lock cache_lock(m_cache_mutex);
   while (remain > 0)
   {
     block = offset / m_block_size;
 
-    const Cache* cache = GetCacheLine(block);
+    const Cache* cache = GetCacheLine(block, cache_lock);
     if (!cache)
       return false;
 
@@ -149,6 +267,8 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
     std::copy(cache->data.begin() + read_offset, cache->data.begin() + read_offset + was_read,
               out_ptr);
 
+    Prefetch(cache->block_idx / m_chunk_blocks);
+
     offset += was_read;
     out_ptr += was_read;
     remain -= was_read;
@@ -239,6 +359,8 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
     return WIAFileReader::Create(std::move(file), filename);
   case RVZ_MAGIC:
     return RVZFileReader::Create(std::move(file), filename);
+  case DCS_MAGIC:
+    return DCSFileReader::Create(std::move(file), filename);
   default:
     if (auto directory_blob = DirectoryBlobReader::Create(filename))
       return std::move(directory_blob);
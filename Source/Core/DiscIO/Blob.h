@@ -14,14 +14,18 @@
 // automatically do the right thing.
 
 #include <array>
+#include <atomic>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
+#include "Common/WorkQueueThread.h"
 
 namespace DiscIO
 {
@@ -39,6 +43,7 @@ enum class BlobType
   TGC,
   WIA,
   RVZ,
+  DCS,
 };
 
 std::string GetName(BlobType blob_type, bool translate);
@@ -70,6 +75,10 @@ public:
     return Common::FromBigEndian(temp);
   }
 
+  // Returns a pointer to the data if the blob is memory-mapped, or nullptr otherwise.
+  // The pointer stays valid for as long as the BlobReader exists. NOT thread-safe.
+  virtual const u8* GetMappedData(u64 offset, u64 size) { return nullptr; }
+
   virtual bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const
   {
     return false;
@@ -90,10 +99,32 @@ protected:
 class SectorReader : public BlobReader
 {
 public:
+  struct CacheStats
+  {
+    u64 hits;
+    u64 misses;
+    u64 prefetched_chunks;
+    u64 bytes_read_from_storage;
+  };
+
   virtual ~SectorReader() = 0;
 
   bool Read(u64 offset, u64 size, u8* out_ptr) override;
 
+  // The cache holds at least two chunks. Memory is only allocated for chunks that get used.
+  void SetCacheSize(u64 bytes);
+  u64 GetCacheSize() const { return m_cache_size; }
+
+  // When chunks are read sequentially, this much data is read ahead on a background thread.
+  // Set to 0 to disable prefetching.
+  void SetPrefetchSize(u64 bytes);
+  u64 GetPrefetchSize() const { return m_prefetch_size; }
+
+  CacheStats GetCacheStats() const;
+
+  static constexpr u64 DEFAULT_CACHE_SIZE = 8 * 1024 * 1024;
+  static constexpr u64 DEFAULT_PREFETCH_SIZE = 2 * 1024 * 1024;
+
 protected:
   void SetSectorSize(int blocksize);
   int GetSectorSize() const { return m_block_size; }
@@ -112,42 +143,40 @@ protected:
   // overridden in derived classes where possible.
   virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr);
 
+  // GetBlock and ReadMultipleAlignedBlocks may get called from the prefetch thread (never at the
+  // same time as from the reading thread), so derived classes must call this in their destructor.
+  void StopPrefetching();
+
+  // Lets derived classes report how much data they actually read from the underlying storage.
+  void AddBytesReadFromStorage(u64 bytes) { m_bytes_read_from_storage += bytes; }
+
 private:
   struct Cache
   {
     std::vector<u8> data;
     u64 block_idx = 0;
     u32 num_blocks = 0;
-
-    // [Pseudo-] Least Recently Used Shift Register
-    // When an empty cache line is needed, the line with the lowest value
-    // is taken and reset; the LRU register is then shifted down 1 place
-    // on all lines (low bit discarded). When a line is used, the high bit
-    // is set marking it as most recently used.
-    u32 lru_sreg = 0;
+    u64 last_use = 0;
 
     void Reset()
     {
       block_idx = 0;
       num_blocks = 0;
-      lru_sreg = 0;
+      last_use = 0;
     }
-    void Fill(u64 block, u32 count)
+    void Fill(u64 block, u32 count, u64 use)
     {
       block_idx = block;
       num_blocks = count;
-      // NOTE: Setting only the high bit means the newest line will
-      //   be selected for eviction if every line in the cache was
-      //   touched. This gives MRU behavior which is probably
-      //   desirable in that case.
-      MarkUsed();
+      last_use = use;
     }
     bool Contains(u64 block) const { return block >= block_idx && block - block_idx < num_blocks; }
-    void MarkUsed() { lru_sreg |= 0x80000000; }
-    void ShiftLRU() { lru_sreg >>= 1; }
-    bool IsLessRecentlyUsedThan(const Cache& other) const { return lru_sreg < other.lru_sreg; }
   };
 
+  // Clears the cache and recalculates how many lines fit in it.
+  // The caller must hold both m_read_mutex and m_cache_mutex.
+  void ResetCache();
+
   // Gets the cache line that contains the given block, or nullptr.
   // NOTE: The cache record only lasts until it expires (next GetEmptyCacheLine)
   const Cache* FindCacheLine(u64 block_num);
@@ -158,7 +187,8 @@ private:
   // Combines FindCacheLine with GetEmptyCacheLine and ReadChunk.
   // Always returns a valid cache line (loading the data if needed).
   // May return nullptr only if the cache missed and the read failed.
-  const Cache* GetCacheLine(u64 block_num);
+  // cache_lock must hold m_cache_mutex. It is temporarily released while reading.
+  const Cache* GetCacheLine(u64 block_num, std::unique_lock<std::mutex>& cache_lock);
 
   // Read all bytes from a chunk of blocks into a buffer.
   // Returns the number of blocks read (may be less than m_chunk_blocks
@@ -166,10 +196,34 @@ private:
   // evenly divisible into chunks). Returns zero if it fails.
   u32 ReadChunk(u8* buffer, u64 chunk_num);
 
-  static constexpr int CACHE_LINES = 32;
+  // Queues the chunks after chunk_num if chunk_num continues a sequential access pattern.
+  void Prefetch(u64 chunk_num);
+  void PrefetchChunk(u64 chunk_num);
+
   u32 m_block_size = 0;    // Bytes in a sector/block
   u32 m_chunk_blocks = 1;  // Number of sectors/blocks in a chunk
-  std::array<Cache, CACHE_LINES> m_cache;
+  u64 m_cache_size = DEFAULT_CACHE_SIZE;
+  u64 m_prefetch_size = DEFAULT_PREFETCH_SIZE;
+
+  // Lock order: m_read_mutex before m_cache_mutex.
+  // m_read_mutex serializes calls to GetBlock/ReadMultipleAlignedBlocks and guards the buffers.
+  std::mutex m_read_mutex;
+  std::mutex m_cache_mutex;
+  std::vector<Cache> m_cache;
+  u64 m_cache_use_counter = 0;
+  std::vector<u8> m_read_buffer;
+  std::vector<u8> m_prefetch_buffer;
+
+  // Only used by the reading thread
+  u64 m_last_chunk = std::numeric_limits<u64>::max();
+  u64 m_prefetch_end = 0;
+  bool m_prefetch_thread_started = false;
+  Common::WorkQueueThread<u64> m_prefetch_thread;
+
+  std::atomic<u64> m_cache_hits = 0;
+  std::atomic<u64> m_cache_misses = 0;
+  std::atomic<u64> m_prefetched_chunks = 0;
+  std::atomic<u64> m_bytes_read_from_storage = 0;
 };
 
 // Factory function - examines the path to choose the right type of BlobReader, and returns one.
@@ -177,14 +231,20 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename);
 
 using CompressCB = std::function<bool(const std::string& text, float percent)>;
 
+// num_threads is the number of compression threads to use. 0 means one per CPU thread.
 bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
                   const std::string& outfile_path, u32 sub_type, int sector_size,
-                  CompressCB callback);
+                  CompressCB callback, int num_threads = 0);
 bool ConvertToPlain(BlobReader* infile, const std::string& infile_path,
                     const std::string& outfile_path, CompressCB callback);
 bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
                        const std::string& outfile_path, bool rvz,
                        WIARVZCompressionType compression_type, int compression_level,
-                       int chunk_size, CompressCB callback);
+                       int chunk_size, CompressCB callback, int num_threads = 0);
+// Chunks which are already in the store at store_path are shared instead of being stored again.
+// The store is created if it doesn't exist.
+bool ConvertToDCS(BlobReader* infile, const std::string& infile_path,
+                  const std::string& outfile_path, const std::string& store_path, int chunk_size,
+                  int compression_level, CompressCB callback, int num_threads = 0);
 
 }  // namespace DiscIO
@@ -7,6 +7,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <memory>
@@ -23,6 +24,7 @@
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/Timer.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/CompressedBlob.h"
 #include "DiscIO/DiscScrubber.h"
@@ -57,6 +59,8 @@ CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string&
   // I still add some safety margin.
   const u32 zlib_buffer_size = m_header.block_size + 64;
   m_zlib_buffer.resize(zlib_buffer_size);
+
+  m_inflate_stream_ok = inflateInit(&m_inflate_stream) == Z_OK;
 }
 
 std::unique_ptr<CompressedBlobReader> CompressedBlobReader::Create(File::IOFile file,
@@ -71,6 +75,10 @@ std::unique_ptr<CompressedBlobReader> CompressedBlobReader::Create(File::IOFile
 
 CompressedBlobReader::~CompressedBlobReader()
 {
+  StopPrefetching();
+
+  if (m_inflate_stream_ok)
+    inflateEnd(&m_inflate_stream);
 }
 
 // IMPORTANT: Calling this function invalidates all earlier pointers gotten from this function.
@@ -100,9 +108,6 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     offset &= ~(1ULL << 63);
   }
 
-  // clear unused part of zlib buffer. maybe this can be deleted when it works fully.
-  memset(&m_zlib_buffer[comp_block_size], 0, m_zlib_buffer.size() - comp_block_size);
-
   m_file.Seek(offset, SEEK_SET);
   if (!m_file.ReadBytes(m_zlib_buffer.data(), comp_block_size))
   {
@@ -111,6 +116,7 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     m_file.Clear();
     return false;
   }
+  AddBytesReadFromStorage(comp_block_size);
 
   // First, check hash.
   const u32 block_hash = Common::HashAdler32(m_zlib_buffer.data(), comp_block_size);
@@ -128,7 +134,13 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
   }
   else
   {
-    z_stream z = {};
+    z_stream& z = m_inflate_stream;
+    if (!m_inflate_stream_ok || inflateReset(&z) != Z_OK)
+    {
+      ERROR_LOG_FMT(DISCIO, "Failed to initialize zlib");
+      return false;
+    }
+
     z.next_in = m_zlib_buffer.data();
     z.avail_in = comp_block_size;
     if (z.avail_in > m_header.block_size)
@@ -137,8 +149,10 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     }
     z.next_out = out_ptr;
     z.avail_out = m_header.block_size;
-    inflateInit(&z);
-    int status = inflate(&z, Z_FULL_FLUSH);
+
+    // The whole block fits in the output buffer, so Z_FINISH lets zlib decompress it in one go
+    // instead of going through its sliding window.
+    int status = inflate(&z, Z_FINISH);
     u32 uncomp_size = m_header.block_size - z.avail_out;
     if (status != Z_STREAM_END)
     {
@@ -146,7 +160,6 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
       // to be sure, don't use compressed isos :P
       ERROR_LOG_FMT(DISCIO, "Failure reading block {} - out of data and not at end.", block_num);
     }
-    inflateEnd(&z);
     if (uncomp_size != m_header.block_size)
     {
       ERROR_LOG_FMT(DISCIO, "Wrong block size");
@@ -192,15 +205,15 @@ static ConversionResultCode SetUpCompressThreadState(CompressThreadState* state)
                                              ConversionResultCode::InternalError;
 }
 
-static ConversionResult<OutputParameters> Compress(CompressThreadState* state,
-                                                   CompressParameters parameters, int block_size,
-                                                   std::vector<u32>* hashes, int* num_stored,
-                                                   int* num_compressed)
+// Stores the block uncompressed if it doesn't compress well enough. block_number and inpos of
+// the returned OutputParameters are left for the caller to fill in.
+static ConversionResult<OutputParameters> CompressBlock(CompressThreadState* state,
+                                                        std::vector<u8> data, int block_size)
 {
   state->compressed_buffer.resize(block_size);
 
   int retval = deflateReset(&state->z);
-  state->z.next_in = parameters.data.data();
+  state->z.next_in = data.data();
   state->z.avail_in = block_size;
   state->z.next_out = state->compressed_buffer.data();
   state->z.avail_out = block_size;
@@ -215,22 +228,47 @@ static ConversionResult<OutputParameters> Compress(CompressThreadState* state,
 
   state->compressed_buffer.resize(block_size - state->z.avail_out);
 
-  OutputParameters output_parameters;
   if ((status != Z_STREAM_END) || (state->z.avail_out < 10))
   {
     // let's store uncompressed
-    ++*num_stored;
-    output_parameters = OutputParameters{std::move(parameters.data), parameters.block_number, false,
-                                         parameters.inpos};
+    return OutputParameters{std::move(data), 0, false, 0};
   }
   else
   {
     // let's store compressed
-    ++*num_compressed;
-    output_parameters = OutputParameters{std::move(state->compressed_buffer),
-                                         parameters.block_number, true, parameters.inpos};
+    return OutputParameters{std::move(state->compressed_buffer), 0, true, 0};
+  }
+}
+
+static ConversionResult<OutputParameters>
+Compress(CompressThreadState* state, CompressParameters parameters, int block_size,
+         const OutputParameters& zero_block, std::vector<u32>* hashes,
+         std::atomic<int>* num_stored, std::atomic<int>* num_compressed)
+{
+  OutputParameters output_parameters;
+
+  // Scrubbed areas (and padding) are all zeroes. Deflate always produces the same output for the
+  // same input, so these blocks can all reuse the same compressed block without changing the
+  // resulting file, which saves a lot of time when converting scrubbed discs.
+  if (std::all_of(parameters.data.begin(), parameters.data.end(), [](u8 x) { return x == 0; }))
+  {
+    output_parameters = zero_block;
+  }
+  else
+  {
+    auto result = CompressBlock(state, std::move(parameters.data), block_size);
+    if (!result)
+      return result.Error();
+    output_parameters = std::move(*result);
   }
 
+  output_parameters.block_number = parameters.block_number;
+  output_parameters.inpos = parameters.inpos;
+  if (output_parameters.compressed)
+    ++*num_compressed;
+  else
+    ++*num_stored;
+
   (*hashes)[parameters.block_number] =
       Common::HashAdler32(output_parameters.data.data(), output_parameters.data.size());
 
@@ -270,10 +308,22 @@ static ConversionResultCode Output(OutputParameters parameters, File::IOFile* ou
 
 bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
                   const std::string& outfile_path, u32 sub_type, int block_size,
-                  CompressCB callback)
+                  CompressCB callback, int num_threads)
 {
   ASSERT(infile->IsDataSizeAccurate());
 
+  OutputParameters zero_block;
+  {
+    CompressThreadState state;
+    if (SetUpCompressThreadState(&state) != ConversionResultCode::Success)
+      return false;
+
+    auto result = CompressBlock(&state, std::vector<u8>(block_size), block_size);
+    if (!result)
+      return false;
+    zero_block = std::move(*result);
+  }
+
   File::IOFile outfile(outfile_path, "wb");
   if (!outfile)
   {
@@ -307,12 +357,13 @@ bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
   // Now we are ready to write compressed data!
   u64 inpos = 0;
   u64 position = 0;
-  int num_compressed = 0;
-  int num_stored = 0;
+  std::atomic<int> num_compressed = 0;
+  std::atomic<int> num_stored = 0;
   int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
+  const u64 start_time_us = Common::Timer::GetTimeUs();
 
   const auto compress = [&](CompressThreadState* state, CompressParameters parameters) {
-    return Compress(state, std::move(parameters), block_size, &hashes, &num_stored,
+    return Compress(state, std::move(parameters), block_size, zero_block, &hashes, &num_stored,
                     &num_compressed);
   };
 
@@ -322,7 +373,7 @@ bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
   };
 
   MultithreadedCompressor<CompressThreadState, CompressParameters, OutputParameters> compressor(
-      SetUpCompressThreadState, compress, output);
+      SetUpCompressThreadState, compress, output, num_threads);
 
   std::vector<u8> in_buf(block_size);
   for (u32 i = 0; i < header.num_blocks; i++)
@@ -365,6 +416,12 @@ bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
     outfile.WriteArray(offsets.data(), header.num_blocks);
     outfile.WriteArray(hashes.data(), header.num_blocks);
 
+    const double seconds = (Common::Timer::GetTimeUs() - start_time_us) / 1000000.0;
+    NOTICE_LOG_FMT(DISCIO,
+                   "Compressed {} blocks ({} stored uncompressed) in {:.2f} s, {:.1f} MiB/s",
+                   header.num_blocks, num_stored.load(), seconds,
+                   header.data_size / (1024.0 * 1024.0) / std::max(seconds, 0.001));
+
     callback(Common::GetStringT("Done compressing disc image."), 1.0f);
   }
 
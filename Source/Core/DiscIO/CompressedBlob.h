@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 
+#include <zlib.h>
+
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
@@ -73,6 +75,10 @@ private:
   u64 m_file_size;
   std::vector<u8> m_zlib_buffer;
   std::string m_file_name;
+
+  // Reused for every block, since setting up a new stream for each block is relatively slow
+  z_stream m_inflate_stream{};
+  bool m_inflate_stream_ok = false;
 };
 
 }  // namespace DiscIO
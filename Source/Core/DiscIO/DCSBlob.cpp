@@ -0,0 +1,711 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DiscIO/DCSBlob.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zstd.h>
+
+#include "Common/Align.h"
+#include "Common/Assert.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/MultithreadedCompressor.h"
+#include "DiscIO/WIACompression.h"
+
+namespace DiscIO
+{
+constexpr char CHUNKS_FILE_NAME[] = "/chunks.bin";
+constexpr char INDEX_FILE_NAME[] = "/index.bin";
+
+// Shared by all open images, so it's larger than the caches of the other blob types
+constexpr u64 DECODED_CHUNK_CACHE_SIZE = 64 * 1024 * 1024;
+
+namespace
+{
+class DecodedChunkCache
+{
+public:
+  DCSChunkStore::Chunk Get(const DCSChunkStore::Hash& hash)
+  {
+    std::lock_guard lock(m_mutex);
+
+    const auto it = m_map.find(hash);
+    if (it == m_map.end())
+      return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second;
+  }
+
+  void Insert(const DCSChunkStore::Hash& hash, DCSChunkStore::Chunk chunk)
+  {
+    std::lock_guard lock(m_mutex);
+
+    if (m_map.count(hash) != 0)
+      return;
+
+    m_size += chunk->size();
+    m_lru.emplace_front(hash, std::move(chunk));
+    m_map.emplace(hash, m_lru.begin());
+
+    // Always keep the newest chunk, even if it alone is bigger than the cache
+    while (m_size > DECODED_CHUNK_CACHE_SIZE && m_lru.size() > 1)
+    {
+      m_size -= m_lru.back().second->size();
+      m_map.erase(m_lru.back().first);
+      m_lru.pop_back();
+    }
+  }
+
+private:
+  using Entry = std::pair<DCSChunkStore::Hash, DCSChunkStore::Chunk>;
+
+  std::mutex m_mutex;
+  std::list<Entry> m_lru;
+  std::unordered_map<DCSChunkStore::Hash, std::list<Entry>::iterator, DCSChunkStore::HashHasher>
+      m_map;
+  u64 m_size = 0;
+};
+
+DecodedChunkCache s_decoded_chunk_cache;
+
+std::mutex s_stores_mutex;
+std::map<std::string, std::weak_ptr<DCSChunkStore>> s_stores;
+}  // namespace
+
+static bool IsAbsolutePath(const std::string& path)
+{
+#ifdef _WIN32
+  if (path.size() >= 2 && path[1] == ':')
+    return true;
+#endif
+  return !path.empty() && (path[0] == '/' || path[0] == '\\');
+}
+
+// Returns the components of the absolute path, with "." and ".." resolved. The first component is
+// the root: an empty string on POSIX or a drive like "C:" on Windows.
+static std::vector<std::string> GetAbsolutePathComponents(const std::string& path)
+{
+  std::string absolute_path = IsAbsolutePath(path) ? path : File::GetCurrentDir() + '/' + path;
+#ifdef _WIN32
+  absolute_path = ReplaceAll(absolute_path, "\\", "/");
+#endif
+
+  const std::vector<std::string> components = SplitString(absolute_path, '/');
+  std::vector<std::string> result{components[0]};
+  for (size_t i = 1; i < components.size(); ++i)
+  {
+    if (components[i].empty() || components[i] == ".")
+      continue;
+
+    if (components[i] == "..")
+    {
+      if (result.size() > 1)
+        result.pop_back();
+    }
+    else
+    {
+      result.push_back(components[i]);
+    }
+  }
+  return result;
+}
+
+static std::string GetAbsolutePath(const std::string& path)
+{
+  const std::vector<std::string> components = GetAbsolutePathComponents(path);
+  return components.size() == 1 ? components[0] + '/' : JoinStrings(components, "/");
+}
+
+// Returns path relative to directory, or path itself if they are on different drives
+static std::string GetRelativePath(const std::string& path, const std::string& directory)
+{
+  const std::vector<std::string> path_components = GetAbsolutePathComponents(path);
+  const std::vector<std::string> directory_components = GetAbsolutePathComponents(directory);
+  if (path_components[0] != directory_components[0])
+    return GetAbsolutePath(path);
+
+  size_t common = 1;
+  while (common < path_components.size() && common < directory_components.size() &&
+         path_components[common] == directory_components[common])
+  {
+    ++common;
+  }
+
+  std::vector<std::string> result(directory_components.size() - common, "..");
+  result.insert(result.end(), path_components.begin() + common, path_components.end());
+  return result.empty() ? "." : JoinStrings(result, "/");
+}
+
+size_t DCSChunkStore::HashHasher::operator()(const Hash& hash) const
+{
+  // The hash is already uniformly distributed
+  size_t result;
+  std::memcpy(&result, hash.data(), sizeof(result));
+  return result;
+}
+
+DCSChunkStore::DCSChunkStore(std::string path) : m_path(std::move(path))
+{
+}
+
+DCSChunkStore::~DCSChunkStore() = default;
+
+std::shared_ptr<DCSChunkStore> DCSChunkStore::Open(const std::string& path, bool create)
+{
+  const std::string absolute_path = GetAbsolutePath(path);
+
+  std::lock_guard stores_lock(s_stores_mutex);
+
+  std::shared_ptr<DCSChunkStore> store = s_stores[absolute_path].lock();
+  const bool is_new = !store;
+  if (is_new)
+    store = std::shared_ptr<DCSChunkStore>(new DCSChunkStore(absolute_path));
+
+  {
+    std::lock_guard lock(store->m_mutex);
+
+    if (is_new && (create ? !store->OpenForWriting() : !store->LoadIndex()))
+    {
+      ERROR_LOG_FMT(DISCIO, "Failed to open the DCS chunk store {}", absolute_path);
+      return nullptr;
+    }
+
+    if (create && !store->OpenForWriting())
+      return nullptr;
+  }
+
+  s_stores[absolute_path] = store;
+  return store;
+}
+
+// m_mutex must be locked
+bool DCSChunkStore::LoadIndex()
+{
+  if (!m_chunks_file.IsOpen() && !m_chunks_file.Open(m_path + CHUNKS_FILE_NAME, "rb"))
+    return false;
+
+  File::IOFile index_file(m_path + INDEX_FILE_NAME, "rb");
+  if (!index_file)
+    return false;
+
+  if (m_index_bytes_loaded == 0)
+  {
+    DCSIndexHeader header;
+    if (!index_file.ReadArray(&header, 1) || header.magic != DCS_INDEX_MAGIC ||
+        header.version != DCS_VERSION)
+    {
+      return false;
+    }
+    m_index_bytes_loaded = sizeof(DCSIndexHeader);
+  }
+
+  // A partially written entry at the end of the file is ignored
+  const u64 file_size = index_file.GetSize();
+  const size_t new_entries = (file_size - m_index_bytes_loaded) / sizeof(DCSIndexEntry);
+  if (new_entries == 0)
+    return true;
+
+  std::vector<DCSIndexEntry> entries(new_entries);
+  if (!index_file.Seek(m_index_bytes_loaded, SEEK_SET) ||
+      !index_file.ReadArray(entries.data(), entries.size()))
+  {
+    return false;
+  }
+
+  m_index.reserve(m_index.size() + entries.size());
+  for (const DCSIndexEntry& entry : entries)
+    m_index.emplace(entry.hash, entry);
+
+  m_index_bytes_loaded += new_entries * sizeof(DCSIndexEntry);
+  return true;
+}
+
+// m_mutex must be locked
+bool DCSChunkStore::OpenForWriting()
+{
+  if (m_writable)
+    return true;
+
+  if (!File::IsDirectory(m_path) && !File::CreateFullPath(m_path + '/'))
+    return false;
+
+  const bool index_exists = File::Exists(m_path + INDEX_FILE_NAME);
+
+  // Reads can still seek anywhere, but all writes go to the end of the file
+  m_chunks_file.Open(m_path + CHUNKS_FILE_NAME, "a+b");
+  if (!m_chunks_file)
+    return false;
+  m_chunks_file_size = m_chunks_file.GetSize();
+
+  if (index_exists && !LoadIndex())
+    return false;
+
+  if (!m_index_file.Open(m_path + INDEX_FILE_NAME, "ab"))
+    return false;
+
+  // Drop a partial entry left behind by an interrupted write, or the next entry would be misaligned
+  if (index_exists && m_index_file.GetSize() != m_index_bytes_loaded &&
+      !m_index_file.Resize(m_index_bytes_loaded))
+  {
+    return false;
+  }
+
+  if (!index_exists)
+  {
+    const DCSIndexHeader header{DCS_INDEX_MAGIC, DCS_VERSION};
+    if (!m_index_file.WriteArray(&header, 1) || !m_index_file.Flush())
+      return false;
+    m_index_bytes_loaded = sizeof(DCSIndexHeader);
+  }
+
+  m_writable = true;
+  return true;
+}
+
+bool DCSChunkStore::Contains(const Hash& hash)
+{
+  std::lock_guard lock(m_mutex);
+  return m_index.count(hash) != 0;
+}
+
+std::optional<DCSIndexEntry> DCSChunkStore::FindEntry(const Hash& hash)
+{
+  std::lock_guard lock(m_mutex);
+
+  auto it = m_index.find(hash);
+  if (it == m_index.end())
+  {
+    // The chunk may have been added after the index was loaded, for instance by a conversion
+    // which was running in another process
+    if (!LoadIndex())
+      return std::nullopt;
+
+    it = m_index.find(hash);
+    if (it == m_index.end())
+      return std::nullopt;
+  }
+
+  return it->second;
+}
+
+DCSChunkStore::Chunk DCSChunkStore::GetChunk(const Hash& hash)
+{
+  if (Chunk chunk = s_decoded_chunk_cache.Get(hash))
+    return chunk;
+
+  const std::optional<DCSIndexEntry> entry = FindEntry(hash);
+  if (!entry)
+  {
+    ERROR_LOG_FMT(DISCIO, "A chunk is missing from the DCS chunk store {}", m_path);
+    return nullptr;
+  }
+
+  std::vector<u8> stored_data(entry->stored_size);
+  {
+    std::lock_guard lock(m_mutex);
+    if (!m_chunks_file.Seek(entry->offset, SEEK_SET) ||
+        !m_chunks_file.ReadBytes(stored_data.data(), stored_data.size()))
+    {
+      m_chunks_file.Clear();
+      return nullptr;
+    }
+  }
+
+  auto data = std::make_shared<std::vector<u8>>();
+  if (entry->stored_size == entry->size)
+  {
+    *data = std::move(stored_data);
+  }
+  else
+  {
+    data->resize(entry->size);
+    const size_t result =
+        ZSTD_decompress(data->data(), data->size(), stored_data.data(), stored_data.size());
+    if (ZSTD_isError(result) || result != data->size())
+    {
+      ERROR_LOG_FMT(DISCIO, "Failed to decompress a chunk at {:#x} in the DCS chunk store {}",
+                    entry->offset, m_path);
+      return nullptr;
+    }
+  }
+
+  if (Common::SHA1::CalculateDigest(*data) != hash)
+  {
+    ERROR_LOG_FMT(DISCIO, "The chunk at {:#x} in the DCS chunk store {} is corrupt",
+                  entry->offset, m_path);
+    return nullptr;
+  }
+
+  s_decoded_chunk_cache.Insert(hash, data);
+  return data;
+}
+
+bool DCSChunkStore::AddChunk(const Hash& hash, const u8* stored_data, u32 stored_size, u32 size,
+                             bool* was_added)
+{
+  std::lock_guard lock(m_mutex);
+
+  if (was_added)
+    *was_added = false;
+
+  if (m_index.count(hash) != 0)
+    return true;
+
+  if (!m_writable)
+    return false;
+
+  const DCSIndexEntry entry{hash, m_chunks_file_size, stored_size, size};
+
+  if (!m_chunks_file.Seek(0, SEEK_END) || !m_chunks_file.WriteBytes(stored_data, stored_size) ||
+      !m_chunks_file.Flush())
+  {
+    // The offsets of later chunks are based on m_chunks_file_size, so remove what got written
+    m_chunks_file.Clear();
+    m_chunks_file.Resize(m_chunks_file_size);
+    return false;
+  }
+  m_chunks_file_size += stored_size;
+
+  if (!m_index_file.WriteArray(&entry, 1) || !m_index_file.Flush())
+  {
+    m_index_file.Clear();
+    m_index_file.Resize(m_index_bytes_loaded);
+    return false;
+  }
+  m_index_bytes_loaded += sizeof(DCSIndexEntry);
+
+  m_index.emplace(hash, entry);
+
+  if (was_added)
+    *was_added = true;
+  return true;
+}
+
+u64 DCSChunkStore::GetStoredSize()
+{
+  std::lock_guard lock(m_mutex);
+  return m_chunks_file_size;
+}
+
+DCSFileReader::DCSFileReader(const DCSHeader& header, u64 raw_size,
+                             std::vector<DCSChunkStore::Hash> hashes,
+                             std::shared_ptr<DCSChunkStore> store)
+    : m_header(header), m_raw_size(raw_size), m_hashes(std::move(hashes)),
+      m_store(std::move(store))
+{
+}
+
+std::unique_ptr<DCSFileReader> DCSFileReader::Create(File::IOFile file, const std::string& path)
+{
+  DCSHeader header;
+  if (!file.Seek(0, SEEK_SET) || !file.ReadArray(&header, 1) || header.magic != DCS_MAGIC)
+    return nullptr;
+
+  if (header.version != DCS_VERSION || header.chunk_size == 0)
+  {
+    ERROR_LOG_FMT(DISCIO, "Unsupported DCS image {}", path);
+    return nullptr;
+  }
+
+  // Check the sizes against the file before allocating anything based on them
+  const u64 file_size = file.GetSize();
+  const u64 number_of_chunks =
+      header.data_size / header.chunk_size + (header.data_size % header.chunk_size != 0);
+  if (header.store_path_size > file_size - sizeof(DCSHeader) ||
+      number_of_chunks > (file_size - sizeof(DCSHeader) - header.store_path_size) /
+                             sizeof(DCSChunkStore::Hash))
+  {
+    ERROR_LOG_FMT(DISCIO, "The DCS image {} is truncated or corrupt", path);
+    return nullptr;
+  }
+
+  std::string store_path(header.store_path_size, '\0');
+  if (!file.ReadBytes(store_path.data(), store_path.size()))
+    return nullptr;
+
+  std::vector<DCSChunkStore::Hash> hashes(number_of_chunks);
+  if (!file.ReadArray(hashes.data(), hashes.size()))
+    return nullptr;
+
+  if (!IsAbsolutePath(store_path))
+  {
+    std::string directory;
+    SplitPath(path, &directory, nullptr, nullptr);
+    store_path = directory + store_path;
+  }
+
+  std::shared_ptr<DCSChunkStore> store = DCSChunkStore::Open(store_path);
+  if (!store)
+    return nullptr;
+
+  return std::unique_ptr<DCSFileReader>(
+      new DCSFileReader(header, file_size, std::move(hashes), std::move(store)));
+}
+
+bool DCSFileReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  if (offset + size > m_header.data_size || offset + size < offset)
+    return false;
+
+  while (size > 0)
+  {
+    const u64 chunk_index = offset / m_header.chunk_size;
+    const u64 offset_in_chunk = offset % m_header.chunk_size;
+    const u64 bytes_to_copy = std::min(size, m_header.chunk_size - offset_in_chunk);
+
+    if (!m_current_chunk || m_current_chunk_index != chunk_index)
+    {
+      m_current_chunk = m_store->GetChunk(m_hashes[chunk_index]);
+      m_current_chunk_index = chunk_index;
+      if (!m_current_chunk)
+        return false;
+    }
+
+    if (m_current_chunk->size() < offset_in_chunk + bytes_to_copy)
+      return false;
+
+    std::memcpy(out_ptr, m_current_chunk->data() + offset_in_chunk, bytes_to_copy);
+
+    offset += bytes_to_copy;
+    size -= bytes_to_copy;
+    out_ptr += bytes_to_copy;
+  }
+
+  return true;
+}
+
+namespace
+{
+struct DCSCompressThreadState
+{
+  std::unique_ptr<ZstdCompressor> compressor;
+};
+
+struct DCSCompressParameters
+{
+  std::vector<u8> data;
+  u64 chunk_index;
+  u64 inpos;
+};
+
+struct DCSOutputParameters
+{
+  DCSChunkStore::Hash hash;
+  std::vector<u8> stored_data;  // Empty if the chunk already was in the store
+  u32 size;
+  u64 chunk_index;
+  u64 inpos;
+};
+}  // namespace
+
+static ConversionResult<DCSOutputParameters>
+CompressDCSChunk(DCSCompressThreadState* state, DCSCompressParameters parameters,
+                 DCSChunkStore* store)
+{
+  DCSOutputParameters output{};
+  output.hash = Common::SHA1::CalculateDigest(parameters.data);
+  output.size = static_cast<u32>(parameters.data.size());
+  output.chunk_index = parameters.chunk_index;
+  output.inpos = parameters.inpos;
+
+  // Most of the time saved by deduplication comes from not compressing chunks we already have
+  if (store->Contains(output.hash))
+    return output;
+
+  ZstdCompressor* compressor = state->compressor.get();
+  if (!compressor->Start(parameters.data.size()) ||
+      !compressor->Compress(parameters.data.data(), parameters.data.size()) || !compressor->End())
+  {
+    return ConversionResultCode::InternalError;
+  }
+
+  if (compressor->GetSize() < parameters.data.size())
+  {
+    output.stored_data.assign(compressor->GetData(),
+                              compressor->GetData() + compressor->GetSize());
+  }
+  else
+  {
+    output.stored_data = std::move(parameters.data);
+  }
+
+  return output;
+}
+
+bool ConvertToDCS(BlobReader* infile, const std::string& infile_path,
+                  const std::string& outfile_path, const std::string& store_path,
+                  int chunk_size, int compression_level, CompressCB callback, int num_threads)
+{
+  ASSERT(infile->IsDataSizeAccurate());
+  ASSERT(chunk_size > 0);
+
+  const std::shared_ptr<DCSChunkStore> store = DCSChunkStore::Open(store_path, true);
+  if (!store)
+  {
+    PanicAlertFmtT("Failed to open the chunk store \"{0}\".", store_path);
+    return false;
+  }
+
+  File::IOFile outfile(outfile_path, "wb");
+  if (!outfile)
+  {
+    PanicAlertFmtT(
+        "Failed to open the output file \"{0}\".\n"
+        "Check that you have permissions to write the target folder and that the media can "
+        "be written.",
+        outfile_path);
+    return false;
+  }
+
+  callback(Common::GetStringT("Files opened, ready to compress."), 0);
+
+  // Store the path relative to the image, so that a library can be moved together with its store
+  std::string outfile_directory;
+  SplitPath(GetAbsolutePath(outfile_path), &outfile_directory, nullptr, nullptr);
+  const std::string relative_store_path = GetRelativePath(store->GetPath(), outfile_directory);
+
+  DCSHeader header{};
+  header.magic = DCS_MAGIC;
+  header.version = DCS_VERSION;
+  header.data_size = infile->GetDataSize();
+  header.chunk_size = static_cast<u32>(chunk_size);
+  header.store_path_size = static_cast<u32>(relative_store_path.size());
+
+  const u64 number_of_chunks = Common::AlignUp(header.data_size, chunk_size) / chunk_size;
+  std::vector<DCSChunkStore::Hash> hashes(number_of_chunks);
+
+  u64 new_chunks = 0;
+  u64 new_bytes = 0;
+  const u64 progress_monitor = std::max<u64>(1, number_of_chunks / 1000);
+  const u64 start_time_us = Common::Timer::GetTimeUs();
+
+  const auto set_up_compress_thread_state = [compression_level](DCSCompressThreadState* state) {
+    state->compressor = std::make_unique<ZstdCompressor>(compression_level);
+    return ConversionResultCode::Success;
+  };
+
+  const auto compress = [&store](DCSCompressThreadState* state, DCSCompressParameters parameters) {
+    return CompressDCSChunk(state, std::move(parameters), store.get());
+  };
+
+  const auto output = [&](DCSOutputParameters parameters) {
+    hashes[parameters.chunk_index] = parameters.hash;
+
+    if (!parameters.stored_data.empty())
+    {
+      bool was_added;
+      if (!store->AddChunk(parameters.hash, parameters.stored_data.data(),
+                           static_cast<u32>(parameters.stored_data.size()), parameters.size,
+                           &was_added))
+      {
+        return ConversionResultCode::WriteFailed;
+      }
+
+      if (was_added)
+      {
+        ++new_chunks;
+        new_bytes += parameters.stored_data.size();
+      }
+    }
+
+    if (parameters.chunk_index % progress_monitor == 0)
+    {
+      const std::string text =
+          Common::FmtFormatT("{0} of {1} blocks. {2} new blocks stored", parameters.chunk_index,
+                             number_of_chunks, new_chunks);
+      const float completion = static_cast<float>(parameters.inpos) / header.data_size;
+      if (!callback(text, completion))
+        return ConversionResultCode::Canceled;
+    }
+
+    return ConversionResultCode::Success;
+  };
+
+  MultithreadedCompressor<DCSCompressThreadState, DCSCompressParameters, DCSOutputParameters>
+      compressor(set_up_compress_thread_state, compress, output, num_threads);
+
+  u64 inpos = 0;
+  for (u64 i = 0; i < number_of_chunks; ++i)
+  {
+    if (compressor.GetStatus() != ConversionResultCode::Success)
+      break;
+
+    // The last chunk is padded with zeroes, so that all chunks have the same size
+    std::vector<u8> data(chunk_size);
+    const u64 bytes_to_read = std::min<u64>(chunk_size, header.data_size - inpos);
+    if (!infile->Read(inpos, bytes_to_read, data.data()))
+    {
+      compressor.SetError(ConversionResultCode::ReadFailed);
+      break;
+    }
+
+    inpos += bytes_to_read;
+    compressor.CompressAndWrite(DCSCompressParameters{std::move(data), i, inpos});
+  }
+
+  compressor.Shutdown();
+
+  ConversionResultCode result = compressor.GetStatus();
+
+  if (result == ConversionResultCode::Success)
+  {
+    if (!outfile.WriteArray(&header, 1) || !outfile.WriteString(relative_store_path) ||
+        !outfile.WriteArray(hashes.data(), hashes.size()))
+    {
+      result = ConversionResultCode::WriteFailed;
+    }
+  }
+
+  if (result != ConversionResultCode::Success)
+  {
+    // Remove the incomplete output file. Chunks which were added to the store are kept, since
+    // other images may start using them.
+    outfile.Close();
+    File::Delete(outfile_path);
+  }
+  else
+  {
+    const double seconds = (Common::Timer::GetTimeUs() - start_time_us) / 1000000.0;
+    NOTICE_LOG_FMT(DISCIO,
+                   "Stored {} of {} chunks ({} bytes) in {}, the rest was already stored. "
+                   "{:.2f} s, {:.1f} MiB/s",
+                   new_chunks, number_of_chunks, new_bytes, store->GetPath(), seconds,
+                   header.data_size / (1024.0 * 1024.0) / std::max(seconds, 0.001));
+
+    callback(Common::GetStringT("Done compressing disc image."), 1.0f);
+  }
+
+  if (result == ConversionResultCode::ReadFailed)
+    PanicAlertFmtT("Failed to read from the input file \"{0}\".", infile_path);
+
+  if (result == ConversionResultCode::WriteFailed)
+  {
+    PanicAlertFmtT("Failed to write the output file \"{0}\".\n"
+                   "Check that you have enough space available on the target drive.",
+                   outfile_path);
+  }
+
+  return result == ConversionResultCode::Success;
+}
+
+}  // namespace DiscIO
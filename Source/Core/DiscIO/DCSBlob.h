@@ -0,0 +1,149 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "DiscIO/Blob.h"
+
+// A DCS image doesn't contain any disc data itself. The disc is split into fixed-size chunks which
+// are stored zstd-compressed in a chunk store, and the image only lists the SHA-1 of each chunk.
+// Any number of images can share a chunk store, so data which several discs have in common (update
+// partitions, SDK files, region variants of the same game...) only takes up space once.
+//
+// A chunk store is a directory containing two append-only files:
+//  - chunks.bin: The stored chunks, back to back.
+//  - index.bin: A DCSIndexHeader followed by one DCSIndexEntry per chunk in chunks.bin.
+// An index entry is only written after the chunk itself, so an interrupted conversion can at worst
+// leave unreferenced data at the end of chunks.bin.
+//
+// Converting several images into the same store at the same time is supported within one process,
+// but not from several processes.
+
+namespace DiscIO
+{
+constexpr u32 DCS_MAGIC = 0x01534344;        // "DCS\x1" (byteswapped to little endian)
+constexpr u32 DCS_INDEX_MAGIC = 0x49534344;  // "DCSI" (byteswapped to little endian)
+constexpr u32 DCS_VERSION = 1;
+
+#pragma pack(push, 1)
+// Followed by store_path_size bytes of store path and then one SHA-1 per chunk.
+// A relative store path is relative to the directory the image is in.
+struct DCSHeader
+{
+  u32 magic;
+  u32 version;
+  u64 data_size;
+  u32 chunk_size;
+  u32 store_path_size;
+};
+static_assert(sizeof(DCSHeader) == 0x18, "Wrong size for DCS header");
+
+struct DCSIndexHeader
+{
+  u32 magic;
+  u32 version;
+};
+static_assert(sizeof(DCSIndexHeader) == 0x8, "Wrong size for DCS index header");
+
+struct DCSIndexEntry
+{
+  std::array<u8, 20> hash;
+  u64 offset;       // In chunks.bin
+  u32 stored_size;  // Equal to size if the chunk is stored uncompressed
+  u32 size;
+};
+static_assert(sizeof(DCSIndexEntry) == 0x24, "Wrong size for DCS index entry");
+#pragma pack(pop)
+
+class DCSChunkStore
+{
+public:
+  using Hash = std::array<u8, 20>;
+  using Chunk = std::shared_ptr<const std::vector<u8>>;
+
+  struct HashHasher
+  {
+    size_t operator()(const Hash& hash) const;
+  };
+
+  // Stores are shared, so opening the same store twice returns the same object. If create is
+  // set, the store is created if it doesn't exist and opened for writing.
+  static std::shared_ptr<DCSChunkStore> Open(const std::string& path, bool create = false);
+
+  ~DCSChunkStore();
+
+  bool Contains(const Hash& hash);
+
+  // Decoded chunks are kept in a cache which is shared between all stores and images, so that
+  // data which several open images have in common is only decompressed once.
+  Chunk GetChunk(const Hash& hash);
+
+  // Does nothing if the chunk is already in the store. Returns false if writing failed or if the
+  // store wasn't opened for writing. stored_data must be the zstd-compressed chunk, or the chunk
+  // itself if stored_size == size.
+  bool AddChunk(const Hash& hash, const u8* stored_data, u32 stored_size, u32 size,
+                bool* was_added = nullptr);
+
+  const std::string& GetPath() const { return m_path; }
+  u64 GetStoredSize();
+
+private:
+  explicit DCSChunkStore(std::string path);
+
+  bool LoadIndex();
+  bool OpenForWriting();
+  std::optional<DCSIndexEntry> FindEntry(const Hash& hash);
+
+  std::string m_path;
+
+  std::mutex m_mutex;
+  File::IOFile m_chunks_file;
+  File::IOFile m_index_file;
+  bool m_writable = false;
+  u64 m_index_bytes_loaded = 0;
+  u64 m_chunks_file_size = 0;
+  std::unordered_map<Hash, DCSIndexEntry, HashHasher> m_index;
+};
+
+class DCSFileReader final : public BlobReader
+{
+public:
+  static std::unique_ptr<DCSFileReader> Create(File::IOFile file, const std::string& path);
+
+  BlobType GetBlobType() const override { return BlobType::DCS; }
+
+  // Only counts the image file, since the chunks are shared with other images
+  u64 GetRawSize() const override { return m_raw_size; }
+  u64 GetDataSize() const override { return m_header.data_size; }
+  bool IsDataSizeAccurate() const override { return true; }
+
+  u64 GetBlockSize() const override { return m_header.chunk_size; }
+  bool HasFastRandomAccessInBlock() const override { return false; }
+  std::string GetCompressionMethod() const override { return "Zstandard"; }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
+private:
+  DCSFileReader(const DCSHeader& header, u64 raw_size, std::vector<DCSChunkStore::Hash> hashes,
+                std::shared_ptr<DCSChunkStore> store);
+
+  DCSHeader m_header;
+  u64 m_raw_size;
+  std::vector<DCSChunkStore::Hash> m_hashes;
+  std::shared_ptr<DCSChunkStore> m_store;
+
+  u64 m_current_chunk_index = 0;
+  DCSChunkStore::Chunk m_current_chunk;
+};
+
+}  // namespace DiscIO
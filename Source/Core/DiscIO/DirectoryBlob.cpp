@@ -6,17 +6,23 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <ctime>
 #include <locale>
 #include <map>
 #include <memory>
-#include <set>
+#include <mutex>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include <fmt/format.h>
+
 #include "Common/Align.h"
 #include "Common/Assert.h"
+#include "Common/CRC32.h"
+#include "Common/ChunkFile.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
@@ -60,12 +66,39 @@ constexpr u8 ENTRY_SIZE = 0x0c;
 constexpr u8 FILE_ENTRY = 0;
 constexpr u8 DIRECTORY_ENTRY = 1;
 
-DiscContent::DiscContent(u64 offset, u64 size, ContentSource source)
-    : m_offset(offset), m_size(size), m_content_source(std::move(source))
+constexpr u32 FST_CACHE_REVISION = 2;
+
+bool ContentFileHandleCache::Read(const std::string& path, u64 offset, u64 length, u8* buffer)
 {
+  File::IOFile file;
+  {
+    std::lock_guard lk(m_mutex);
+    const auto it = std::find_if(m_files.begin(), m_files.end(),
+                                 [&path](const auto& entry) { return entry.first == path; });
+    if (it != m_files.end())
+    {
+      // Take the handle out of the cache while reading, so other threads can't use it meanwhile
+      file = std::move(it->second);
+      m_files.erase(it);
+    }
+  }
+
+  if (!file.IsOpen() && !file.Open(path, "rb"))
+    return false;
+
+  if (!file.Seek(offset, SEEK_SET) || !file.ReadBytes(buffer, length))
+    return false;
+
+  std::lock_guard lk(m_mutex);
+  m_files.emplace_front(path, std::move(file));
+  if (m_files.size() > MAX_OPEN_FILES)
+    m_files.pop_back();
+
+  return true;
 }
 
-DiscContent::DiscContent(u64 offset) : m_offset(offset)
+DiscContent::DiscContent(u64 offset, u64 size, ContentSource source)
+    : m_offset(offset), m_size(size), m_content_source(std::move(source))
 {
 }
 
@@ -84,7 +117,8 @@ u64 DiscContent::GetSize() const
   return m_size;
 }
 
-bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
+bool DiscContent::Read(u64* offset, u64* length, u8** buffer,
+                       ContentFileHandleCache* file_cache) const
 {
   if (m_size == 0)
     return true;
@@ -99,9 +133,8 @@ bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
     if (std::holds_alternative<ContentFile>(m_content_source))
     {
       const auto& content = std::get<ContentFile>(m_content_source);
-      File::IOFile file(content.m_filename, "rb");
-      if (!file.Seek(content.m_offset + offset_in_content, SEEK_SET) ||
-          !file.ReadBytes(*buffer, bytes_to_read))
+      if (!file_cache->Read(content.m_filename, content.m_offset + offset_in_content,
+                            bytes_to_read, *buffer))
       {
         return false;
       }
@@ -152,8 +185,17 @@ bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
 
 void DiscContentContainer::Add(u64 offset, u64 size, ContentSource source)
 {
-  if (size != 0)
-    m_contents.emplace(offset, size, std::move(source));
+  if (size == 0)
+    return;
+
+  // Contents are almost always added in ascending order, in which case this appends
+  const auto it =
+      std::upper_bound(m_contents.begin(), m_contents.end(), offset,
+                       [](u64 offset_, const DiscContent& content) {
+                         return offset_ < content.GetOffset();
+                       });
+  DEBUG_ASSERT(it == m_contents.end() || offset + size <= it->GetOffset());
+  m_contents.emplace(it, offset, size, std::move(source));
 }
 
 u64 DiscContentContainer::CheckSizeAndAdd(u64 offset, const std::string& path)
@@ -173,7 +215,10 @@ u64 DiscContentContainer::CheckSizeAndAdd(u64 offset, u64 max_size, const std::s
 bool DiscContentContainer::Read(u64 offset, u64 length, u8* buffer) const
 {
   // Determine which DiscContent the offset refers to
-  std::set<DiscContent>::const_iterator it = m_contents.upper_bound(DiscContent(offset));
+  auto it = std::upper_bound(m_contents.cbegin(), m_contents.cend(), offset,
+                             [](u64 offset_, const DiscContent& content) {
+                               return offset_ < content.GetEndOffset();
+                             });
 
   while (it != m_contents.end() && length > 0)
   {
@@ -183,7 +228,7 @@ bool DiscContentContainer::Read(u64 offset, u64 length, u8* buffer) const
     if (length == 0)
       return true;
 
-    if (!it->Read(&offset, &length, &buffer))
+    if (!it->Read(&offset, &length, &buffer, m_file_cache.get()))
       return false;
 
     ++it;
@@ -1016,9 +1061,294 @@ static std::vector<FSTBuilderNode> ConvertFSTEntriesToBuilderNodes(const File::F
   return nodes;
 }
 
+// The oldest cache files are deleted when there are more than this, so that caches of
+// directories which aren't used anymore don't pile up
+constexpr size_t MAX_FST_CACHE_FILES = 64;
+
+static std::string GetFSTCacheDirectory()
+{
+  const std::string& cache_directory = File::GetUserPath(D_CACHE_IDX);
+  if (cache_directory.empty())
+    return {};
+
+  return cache_directory + "DirectoryBlob";
+}
+
+static std::string GetFSTCachePath(const std::string& directory)
+{
+  const std::string cache_directory = GetFSTCacheDirectory();
+  if (cache_directory.empty())
+    return {};
+
+  return fmt::format("{}" DIR_SEP "{:08x}.cache", cache_directory,
+                     Common::ComputeCRC32(directory));
+}
+
+// All entries of the tree (including the root), parents before their children
+static void GetEntries(const File::FSTEntry& entry, std::vector<const File::FSTEntry*>* out)
+{
+  out->push_back(&entry);
+  for (const File::FSTEntry& child : entry.children)
+  {
+    if (child.isDirectory)
+      GetEntries(child, out);
+    else
+      out->push_back(&child);
+  }
+}
+
+static void DoFSTEntryChildren(PointerWrap& p, File::FSTEntry* parent)
+{
+  p.DoEachElement(parent->children, [](PointerWrap& state, File::FSTEntry& entry) {
+    state.Do(entry.isDirectory);
+    state.Do(entry.size);
+    state.Do(entry.virtualName);
+    if (entry.isDirectory)
+      DoFSTEntryChildren(state, &entry);
+  });
+}
+
+// Only used for writing the cache. See FSTCacheReader for reading it.
+static void DoFSTCache(PointerWrap& p, File::FSTEntry* root, s64* scan_time,
+                       std::vector<s64>* modification_times)
+{
+  u32 revision = FST_CACHE_REVISION;
+  p.Do(revision);
+  p.Do(root->physicalName);
+  p.Do(root->size);
+  p.Do(*scan_time);
+  p.Do(*modification_times);
+  DoFSTEntryChildren(p, root);
+}
+
+namespace
+{
+// Reads what DoFSTCache writes. PointerWrap doesn't check that it stays within its buffer, and
+// the cache file could be truncated or corrupt, so every read here is checked against the end.
+class FSTCacheReader
+{
+public:
+  FSTCacheReader(const u8* data, size_t size) : m_ptr(data), m_end(data + size) {}
+
+  bool IsAtEnd() const { return m_ptr == m_end; }
+
+  template <typename T>
+  bool Read(T* value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (GetRemainingSize() < sizeof(T))
+      return false;
+    std::memcpy(value, m_ptr, sizeof(T));
+    m_ptr += sizeof(T);
+    return true;
+  }
+
+  bool Read(bool* value)
+  {
+    u8 stable;
+    if (!Read(&stable))
+      return false;
+    *value = stable != 0;
+    return true;
+  }
+
+  bool Read(std::string* value)
+  {
+    u32 size;
+    if (!ReadCount(&size, sizeof(char)))
+      return false;
+    value->assign(reinterpret_cast<const char*>(m_ptr), size);
+    m_ptr += size;
+    return true;
+  }
+
+  bool Read(std::vector<s64>* values)
+  {
+    u32 count;
+    if (!ReadCount(&count, sizeof(s64)))
+      return false;
+    values->resize(count);
+    std::memcpy(values->data(), m_ptr, count * sizeof(s64));
+    m_ptr += count * sizeof(s64);
+    return true;
+  }
+
+  // Fails if the remaining data can't hold count elements of at least min_element_size bytes
+  bool ReadCount(u32* count, size_t min_element_size)
+  {
+    return Read(count) && *count <= GetRemainingSize() / min_element_size;
+  }
+
+private:
+  size_t GetRemainingSize() const { return static_cast<size_t>(m_end - m_ptr); }
+
+  const u8* m_ptr;
+  const u8* m_end;
+};
+}  // namespace
+
+static bool ReadFSTEntryChildren(FSTCacheReader& reader, File::FSTEntry* parent)
+{
+  // isDirectory, size and the size of virtualName
+  constexpr size_t MIN_ENTRY_SIZE = sizeof(u8) + sizeof(u64) + sizeof(u32);
+
+  u32 count;
+  if (!reader.ReadCount(&count, MIN_ENTRY_SIZE))
+    return false;
+
+  parent->children.resize(count);
+  for (File::FSTEntry& entry : parent->children)
+  {
+    if (!reader.Read(&entry.isDirectory) || !reader.Read(&entry.size) ||
+        !reader.Read(&entry.virtualName))
+    {
+      return false;
+    }
+    entry.physicalName = parent->physicalName + DIR_SEP + entry.virtualName;
+    if (entry.isDirectory && !ReadFSTEntryChildren(reader, &entry))
+      return false;
+  }
+
+  return true;
+}
+
+// Returns the tree from the cache if no entry in it has been modified since it was scanned
+static std::optional<File::FSTEntry> LoadFSTCache(const std::string& cache_path,
+                                                  const std::string& directory)
+{
+  File::IOFile file(cache_path, "rb");
+  std::vector<u8> buffer(file.GetSize());
+  if (buffer.empty() || !file.ReadBytes(buffer.data(), buffer.size()))
+    return std::nullopt;
+
+  File::FSTEntry root;
+  s64 scan_time = 0;
+  std::vector<s64> modification_times;
+  u32 revision;
+  FSTCacheReader reader(buffer.data(), buffer.size());
+  if (!reader.Read(&revision) || revision != FST_CACHE_REVISION ||
+      !reader.Read(&root.physicalName) || root.physicalName != directory ||
+      !reader.Read(&root.size) || !reader.Read(&scan_time) || !reader.Read(&modification_times) ||
+      !ReadFSTEntryChildren(reader, &root) || !reader.IsAtEnd())
+  {
+    return std::nullopt;
+  }
+
+  std::vector<const File::FSTEntry*> entries;
+  GetEntries(root, &entries);
+  if (entries.size() != modification_times.size())
+    return std::nullopt;
+
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    // An entry modified in the same second as the scan might have been modified after it
+    const File::FileInfo info(entries[i]->physicalName);
+    const s64 modification_time = info.GetModificationTime();
+    if (modification_time == 0 || modification_time != modification_times[i] ||
+        modification_time >= scan_time || info.IsDirectory() != entries[i]->isDirectory ||
+        (!entries[i]->isDirectory && info.GetSize() != entries[i]->size))
+    {
+      return std::nullopt;
+    }
+  }
+
+  root.isDirectory = true;
+  return root;
+}
+
+static void DeleteOldFSTCaches()
+{
+  const File::FSTEntry cache_directory = File::ScanDirectoryTree(GetFSTCacheDirectory(), false);
+  std::vector<std::pair<s64, const std::string*>> caches;
+  for (const File::FSTEntry& entry : cache_directory.children)
+  {
+    if (!entry.isDirectory && StringEndsWith(entry.virtualName, ".cache"))
+    {
+      const s64 modification_time = File::FileInfo(entry.physicalName).GetModificationTime();
+      caches.emplace_back(modification_time, &entry.physicalName);
+    }
+  }
+
+  if (caches.size() <= MAX_FST_CACHE_FILES)
+    return;
+
+  const auto newest_to_keep = caches.end() - MAX_FST_CACHE_FILES;
+  std::nth_element(caches.begin(), newest_to_keep, caches.end());
+  for (auto it = caches.begin(); it != newest_to_keep; ++it)
+    File::Delete(*it->second);
+}
+
+static void SaveFSTCache(const std::string& cache_path, File::FSTEntry* root, s64 scan_time)
+{
+  std::vector<const File::FSTEntry*> entries;
+  GetEntries(*root, &entries);
+  std::vector<s64> modification_times(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i)
+    modification_times[i] = File::FileInfo(entries[i]->physicalName).GetModificationTime();
+
+  u8* ptr = nullptr;
+  PointerWrap p_measure(&ptr, PointerWrap::MODE_MEASURE);
+  DoFSTCache(p_measure, root, &scan_time, &modification_times);
+  std::vector<u8> buffer(reinterpret_cast<size_t>(ptr));
+
+  ptr = buffer.data();
+  PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+  DoFSTCache(p, root, &scan_time, &modification_times);
+
+  if (!File::CreateFullPath(cache_path))
+    return;
+
+  // Write to a temporary file first so that an interrupted write can't leave a broken cache behind
+  const std::string temp_path = cache_path + ".tmp";
+  {
+    File::IOFile file(temp_path, "wb");
+    if (!file.WriteBytes(buffer.data(), buffer.size()) || !file.Close())
+    {
+      ERROR_LOG_FMT(DISCIO, "Failed to write {}", temp_path);
+      File::Delete(temp_path);
+      return;
+    }
+  }
+
+  if (!File::Rename(temp_path, cache_path))
+  {
+    File::Delete(temp_path);
+    return;
+  }
+
+  DeleteOldFSTCaches();
+}
+
+// Scanning the files directory of a big game can take a while, so the result is cached on disk.
+// Adding, removing or renaming an entry changes the modification time of the directory it's in,
+// and rewriting a file changes its own modification time (and usually its size), so the cache is
+// used as long as no entry in the tree has been modified. This still takes a stat per entry, but
+// avoids listing every directory again.
+static File::FSTEntry ScanDirectoryTreeCached(std::string directory)
+{
+  if (!directory.empty() && IsDirectorySeparator(directory.back()))
+    directory.pop_back();
+
+  const std::string cache_path = GetFSTCachePath(directory);
+  if (cache_path.empty())
+    return File::ScanDirectoryTree(directory, true);
+
+  std::optional<File::FSTEntry> cached_root = LoadFSTCache(cache_path, directory);
+  if (cached_root)
+  {
+    INFO_LOG_FMT(DISCIO, "Using cached directory tree for {}", directory);
+    return std::move(*cached_root);
+  }
+
+  const s64 scan_time = static_cast<s64>(std::time(nullptr));
+  File::FSTEntry root = File::ScanDirectoryTree(directory, true);
+  SaveFSTCache(cache_path, &root, scan_time);
+  return root;
+}
+
 void DirectoryBlobPartition::BuildFSTFromFolder(const std::string& fst_root_path, u64 fst_address)
 {
-  auto nodes = ConvertFSTEntriesToBuilderNodes(File::ScanDirectoryTree(fst_root_path, true));
+  auto nodes = ConvertFSTEntriesToBuilderNodes(ScanDirectoryTreeCached(fst_root_path));
   BuildFST(std::move(nodes), fst_address);
 }
 
@@ -6,16 +6,19 @@
 #include <array>
 #include <cstddef>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
-#include <set>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/Volume.h"
 #include "DiscIO/WiiEncryptionCache.h"
@@ -23,7 +26,6 @@
 namespace File
 {
 struct FSTEntry;
-class IOFile;
 }  // namespace File
 
 namespace DiscIO
@@ -129,25 +131,29 @@ struct FSTBuilderNode
   }
 };
 
+// Keeps the most recently used host files open, so that reading a file piece by piece doesn't
+// reopen it for every piece.
+class ContentFileHandleCache
+{
+public:
+  bool Read(const std::string& path, u64 offset, u64 length, u8* buffer);
+
+private:
+  static constexpr size_t MAX_OPEN_FILES = 16;
+
+  std::mutex m_mutex;
+  std::list<std::pair<std::string, File::IOFile>> m_files;  // Most recently used first
+};
+
 class DiscContent
 {
 public:
   DiscContent(u64 offset, u64 size, ContentSource source);
 
-  // Provided because it's convenient when searching for DiscContent in an std::set
-  explicit DiscContent(u64 offset);
-
   u64 GetOffset() const;
   u64 GetEndOffset() const;
   u64 GetSize() const;
-  bool Read(u64* offset, u64* length, u8** buffer) const;
-
-  bool operator==(const DiscContent& other) const { return GetEndOffset() == other.GetEndOffset(); }
-  bool operator!=(const DiscContent& other) const { return !(*this == other); }
-  bool operator<(const DiscContent& other) const { return GetEndOffset() < other.GetEndOffset(); }
-  bool operator>(const DiscContent& other) const { return other < *this; }
-  bool operator<=(const DiscContent& other) const { return !(*this > other); }
-  bool operator>=(const DiscContent& other) const { return !(*this < other); }
+  bool Read(u64* offset, u64* length, u8** buffer, ContentFileHandleCache* file_cache) const;
 
 private:
   // Position of this content chunk within its parent DiscContentContainer.
@@ -175,7 +181,11 @@ public:
   bool Read(u64 offset, u64 length, u8* buffer) const;
 
 private:
-  std::set<DiscContent> m_contents;
+  // Sorted by offset. Contents never overlap, so this is also sorted by end offset.
+  std::vector<DiscContent> m_contents;
+
+  std::unique_ptr<ContentFileHandleCache> m_file_cache =
+      std::make_unique<ContentFileHandleCache>();
 };
 
 class DirectoryBlobPartition
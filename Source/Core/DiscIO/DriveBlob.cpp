@@ -102,6 +102,8 @@ DriveReader::DriveReader(const std::string& drive)
 
 DriveReader::~DriveReader()
 {
+  StopPrefetching();
+
 #ifdef _WIN32
 #ifdef _LOCKDRIVE  // Do we want to lock the drive?
   // Unlock the disc in the CD-ROM drive.
@@ -147,11 +149,15 @@ bool DriveReader::ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* o
     ERROR_LOG_FMT(DISCIO, "Disc Read Error");
     return false;
   }
+  AddBytesReadFromStorage(bytes_read);
   return bytes_read == GetSectorSize() * num_blocks;
 #else
   m_file.Seek(GetSectorSize() * block_num, SEEK_SET);
   if (m_file.ReadBytes(out_ptr, num_blocks * GetSectorSize()))
+  {
+    AddBytesReadFromStorage(num_blocks * GetSectorSize());
     return true;
+  }
   m_file.Clear();
   return false;
 #endif
@@ -2,21 +2,51 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#else
+#include <sys/mount.h>
+#include <sys/param.h>
+#endif
+#endif
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "DiscIO/FileBlob.h"
 
 namespace DiscIO
 {
+// How far ahead of a sequential read (such as when a game is booting) the OS is asked to read
+constexpr u64 READ_AHEAD_SIZE = 4 * 1024 * 1024;
+constexpr u64 MIN_PAGE_SIZE = 4096;
+
 PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
 {
   m_size = m_file.GetSize();
+  if (IsOnLocalFixedStorage())
+    MapFile();
+}
+
+PlainFileReader::~PlainFileReader()
+{
+  UnmapFile();
 }
 
 std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
@@ -27,8 +57,155 @@ std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
   return nullptr;
 }
 
+// Accessing a mapping of a file on storage that goes away (a network share, a USB stick) raises
+// SIGBUS or an in-page error instead of returning an error, so only map files on local disks.
+bool PlainFileReader::IsOnLocalFixedStorage()
+{
+#ifdef _WIN32
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file.GetHandle())));
+  std::wstring path(MAX_PATH, L'\0');
+  const DWORD length = GetFinalPathNameByHandleW(file_handle, path.data(),
+                                                 static_cast<DWORD>(path.size()), VOLUME_NAME_DOS);
+  if (length == 0 || length >= path.size())
+    return false;
+
+  // The path looks like \\?\C:\... for local drives and \\?\UNC\... for network shares
+  constexpr std::wstring_view prefix = L"\\\\?\\";
+  if (path.compare(0, prefix.size(), prefix) != 0 || path[prefix.size() + 1] != L':')
+    return false;
+
+  const std::wstring root = path.substr(prefix.size(), 3);
+  return GetDriveTypeW(root.c_str()) == DRIVE_FIXED;
+#elif defined(__linux__)
+  struct statfs fs;
+  if (fstatfs(fileno(m_file.GetHandle()), &fs) != 0)
+    return false;
+
+  // Network, FUSE and optical file systems, and the FAT variants used on removable drives
+  switch (static_cast<u32>(fs.f_type))
+  {
+  case 0x6969:      // NFS
+  case 0x517b:      // SMB
+  case 0xff534d42:  // CIFS
+  case 0xfe534d42:  // SMB2
+  case 0x65735546:  // FUSE
+  case 0x01021997:  // 9P
+  case 0x73757245:  // Coda
+  case 0x5346414f:  // AFS
+  case 0x00c36400:  // Ceph
+  case 0x9660:      // ISO 9660
+  case 0x15013346:  // UDF
+  case 0x4d44:      // FAT
+  case 0x2011bab0:  // exFAT
+    return false;
+  default:
+    return true;
+  }
+#else
+  struct statfs fs;
+  return fstatfs(fileno(m_file.GetHandle()), &fs) == 0 && (fs.f_flags & MNT_LOCAL) != 0;
+#endif
+}
+
+void PlainFileReader::MapFile()
+{
+  if (m_size <= 0 || static_cast<u64>(m_size) > std::numeric_limits<size_t>::max())
+    return;
+
+#ifdef _WIN32
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file.GetHandle())));
+  m_mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping_handle)
+    return;
+
+  m_mapped_data = static_cast<u8*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+  if (!m_mapped_data)
+  {
+    CloseHandle(m_mapping_handle);
+    m_mapping_handle = nullptr;
+  }
+#else
+  void* data = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_SHARED,
+                    fileno(m_file.GetHandle()), 0);
+  if (data != MAP_FAILED)
+    m_mapped_data = static_cast<u8*>(data);
+#endif
+
+  if (!m_mapped_data)
+    WARN_LOG_FMT(DISCIO, "Failed to memory-map the disc image, falling back to regular reads");
+}
+
+void PlainFileReader::UnmapFile()
+{
+  if (!m_mapped_data)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_mapped_data);
+  CloseHandle(m_mapping_handle);
+  m_mapping_handle = nullptr;
+#else
+  munmap(m_mapped_data, static_cast<size_t>(m_size));
+#endif
+  m_mapped_data = nullptr;
+}
+
+void PlainFileReader::ReadAhead(u64 offset, u64 nbytes)
+{
+  const u64 end = offset + nbytes;
+  const bool sequential = offset == m_next_sequential_offset;
+  m_next_sequential_offset = end;
+
+  if (!sequential)
+  {
+    m_read_ahead_end = end;
+    return;
+  }
+
+  // Extend the window in large steps, so that small sequential reads don't each need a syscall
+  if (m_read_ahead_end >= end + READ_AHEAD_SIZE / 2)
+    return;
+
+  const u64 start = std::max(end, m_read_ahead_end);
+  m_read_ahead_end = std::min<u64>(end + READ_AHEAD_SIZE, m_size);
+  if (m_read_ahead_end <= start)
+    return;
+
+#ifdef _WIN32
+  if (m_mapped_data)
+  {
+    WIN32_MEMORY_RANGE_ENTRY range{m_mapped_data + start,
+                                   static_cast<SIZE_T>(m_read_ahead_end - start)};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+#else
+  static const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+  const u64 aligned_start = start - start % page_size;
+  if (m_mapped_data)
+  {
+    madvise(m_mapped_data + aligned_start, static_cast<size_t>(m_read_ahead_end - aligned_start),
+            MADV_WILLNEED);
+  }
+#ifdef POSIX_FADV_WILLNEED
+  else
+  {
+    posix_fadvise(fileno(m_file.GetHandle()), static_cast<off_t>(aligned_start),
+                  static_cast<off_t>(m_read_ahead_end - aligned_start), POSIX_FADV_WILLNEED);
+  }
+#endif
+#endif
+}
+
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  // Even if the file is mapped, read through the file descriptor. Unlike accessing the mapping,
+  // this reports I/O errors and reads past the end of a truncated file as errors.
+  if (offset > static_cast<u64>(m_size) || nbytes > m_size - offset)
+    return false;
+
+  ReadAhead(offset, nbytes);
+
+#ifdef _WIN32
   if (m_file.Seek(offset, SEEK_SET) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
@@ -38,6 +215,41 @@ bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
     m_file.Clear();
     return false;
   }
+#else
+  // pread doesn't go through the stdio buffer and doesn't need a separate seek
+  const int fd = fileno(m_file.GetHandle());
+  while (nbytes != 0)
+  {
+    const ssize_t result =
+        pread(fd, out_ptr, static_cast<size_t>(nbytes), static_cast<off_t>(offset));
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+
+    offset += static_cast<u64>(result);
+    nbytes -= static_cast<u64>(result);
+    out_ptr += result;
+  }
+  return true;
+#endif
+}
+
+const u8* PlainFileReader::GetMappedData(u64 offset, u64 nbytes)
+{
+  if (!m_mapped_data || offset > static_cast<u64>(m_size) || nbytes > m_size - offset)
+    return nullptr;
+
+  ReadAhead(offset, nbytes);
+
+  // Fault the pages in now, so that whoever copies the data later doesn't have to wait for I/O
+  const u8* data = m_mapped_data + offset;
+  for (u64 i = 0; i < nbytes; i += MIN_PAGE_SIZE)
+    static_cast<void>(*static_cast<const volatile u8*>(data + i));
+  if (nbytes != 0)
+    static_cast<void>(*static_cast<const volatile u8*>(data + nbytes - 1));
+
+  return data;
 }
 
 bool ConvertToPlain(BlobReader* infile, const std::string& infile_path,
@@ -17,6 +17,7 @@ class PlainFileReader : public BlobReader
 {
 public:
   static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  ~PlainFileReader();
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
 
@@ -29,12 +30,32 @@ public:
   std::string GetCompressionMethod() const override { return {}; }
 
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
+  const u8* GetMappedData(u64 offset, u64 nbytes) override;
 
 private:
   PlainFileReader(File::IOFile file);
 
+  bool IsOnLocalFixedStorage();
+  void MapFile();
+  void UnmapFile();
+
+  // If reads are sequential (such as when a game is booting), asks the OS to start reading the
+  // data that comes after the given range.
+  void ReadAhead(u64 offset, u64 nbytes);
+
   File::IOFile m_file;
   s64 m_size;
+
+  // The whole file is mapped read-only if it is on a local disk and the OS allows it. The mapping
+  // is only handed out by GetMappedData; Read always goes through m_file. Pointers into it are
+  // kept by DVDThread, so it stays mapped until the reader is destroyed.
+  u8* m_mapped_data = nullptr;
+#ifdef _WIN32
+  void* m_mapping_handle = nullptr;
+#endif
+
+  u64 m_next_sequential_offset = 0;
+  u64 m_read_ahead_end = 0;
 };
 
 }  // namespace DiscIO
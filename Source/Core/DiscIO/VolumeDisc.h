@@ -6,9 +6,8 @@
 #include <optional>
 #include <string>
 
-#include <mbedtls/sha1.h>
-
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
 #include "DiscIO/Volume.h"
 
 namespace DiscIO
@@ -27,7 +26,7 @@ public:
 
 protected:
   Region RegionCodeToRegion(std::optional<u32> region_code) const;
-  void AddGamePartitionToSyncHash(mbedtls_sha1_context* context) const;
+  void AddGamePartitionToSyncHash(Common::SHA1::Context* context) const;
 };
 
 }  // namespace DiscIO
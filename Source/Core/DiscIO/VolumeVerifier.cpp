@@ -13,13 +13,12 @@
 #include <unordered_set>
 
 #include <mbedtls/md5.h>
-#include <mbedtls/sha1.h>
 #include <pugixml.hpp>
 #include <unzip.h>
-#include <zlib.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
+#include "Common/CRC32.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
@@ -356,6 +355,7 @@ RedumpVerifier::Result RedumpVerifier::Finish(const Hashes<std::vector<u8>>& has
 }
 
 constexpr u64 DEFAULT_READ_SIZE = 0x20000;  // Arbitrary value
+constexpr size_t MAX_CHUNKS_IN_FLIGHT = 8;
 
 VolumeVerifier::VolumeVerifier(const Volume& volume, bool redump_verification,
                                Hashes<bool> hashes_to_calculate)
@@ -1041,58 +1041,160 @@ void VolumeVerifier::SetUpHashing()
             [](const GroupToVerify& a, const GroupToVerify& b) { return a.offset < b.offset; });
 
   if (m_hashes_to_calculate.crc32)
-    m_crc32_context = crc32(0, nullptr, 0);
+  {
+    m_crc32_context = 0;
+    m_crc32_thread.Reset([this](ChunkPointer chunk) {
+      m_crc32_context =
+          Common::UpdateCRC32(m_crc32_context, chunk->data.data(), chunk->bytes_to_hash);
+      FinishChunk(*chunk);
+    });
+  }
 
   if (m_hashes_to_calculate.md5)
   {
     mbedtls_md5_init(&m_md5_context);
     mbedtls_md5_starts_ret(&m_md5_context);
+    m_md5_thread.Reset([this](ChunkPointer chunk) {
+      mbedtls_md5_update_ret(&m_md5_context, chunk->data.data(), chunk->bytes_to_hash);
+      FinishChunk(*chunk);
+    });
   }
 
   if (m_hashes_to_calculate.sha1)
   {
-    mbedtls_sha1_init(&m_sha1_context);
-    mbedtls_sha1_starts_ret(&m_sha1_context);
+    m_sha1_context = Common::SHA1::CreateContext();
+    m_sha1_thread.Reset([this](ChunkPointer chunk) {
+      m_sha1_context->Update(chunk->data.data(), chunk->bytes_to_hash);
+      FinishChunk(*chunk);
+    });
+  }
+
+  if (!m_content_offsets.empty() || !m_groups.empty())
+  {
+    m_integrity_thread.Reset([this](ChunkPointer chunk) {
+      CheckChunkIntegrity(*chunk);
+      FinishChunk(*chunk);
+    });
   }
 }
 
-void VolumeVerifier::WaitForAsyncOperations() const
+void VolumeVerifier::WaitForAsyncOperations()
 {
-  if (m_crc32_future.valid())
-    m_crc32_future.wait();
-  if (m_md5_future.valid())
-    m_md5_future.wait();
-  if (m_sha1_future.valid())
-    m_sha1_future.wait();
-  if (m_content_future.valid())
-    m_content_future.wait();
-  if (m_group_future.valid())
-    m_group_future.wait();
+  std::unique_lock lock(m_chunks_in_flight_mutex);
+  m_chunks_in_flight_cv.wait(lock, [this] { return m_chunks_in_flight == 0; });
 }
 
-bool VolumeVerifier::ReadChunkAndWaitForAsyncOperations(u64 bytes_to_read)
+bool VolumeVerifier::ReadChunk(u64 bytes_to_read, std::vector<u8>* data) const
 {
-  std::vector<u8> data(bytes_to_read);
+  data->resize(bytes_to_read);
 
-  const u64 bytes_to_copy = std::min(m_excess_bytes, bytes_to_read);
-  if (bytes_to_copy > 0)
-    std::memcpy(data.data(), m_data.data() + m_data.size() - m_excess_bytes, bytes_to_copy);
+  // The end of the previous chunk may overlap with this chunk. There is no need to read it again,
+  // unless the previous read failed
+  u64 bytes_to_copy = 0;
+  if (m_previous_chunk && m_previous_chunk->read_succeeded)
+  {
+    const std::vector<u8>& previous_data = m_previous_chunk->data;
+    bytes_to_copy = std::min(m_excess_bytes, bytes_to_read);
+    if (bytes_to_copy > 0)
+    {
+      std::memcpy(data->data(), previous_data.data() + previous_data.size() - m_excess_bytes,
+                  bytes_to_copy);
+    }
+  }
   bytes_to_read -= bytes_to_copy;
 
   if (bytes_to_read > 0)
   {
-    if (!m_volume.Read(m_progress + bytes_to_copy, bytes_to_read, data.data() + bytes_to_copy,
-                       PARTITION_NONE))
-    {
-      return false;
-    }
+    return m_volume.Read(m_progress + bytes_to_copy, bytes_to_read, data->data() + bytes_to_copy,
+                         PARTITION_NONE);
   }
 
-  WaitForAsyncOperations();
-  m_data = std::move(data);
   return true;
 }
 
+void VolumeVerifier::QueueChunk(ChunkPointer chunk)
+{
+  const bool hash = m_calculating_any_hash && chunk->read_succeeded;
+  const bool check_integrity = chunk->content || chunk->group_index;
+
+  const u32 workers = (hash && m_hashes_to_calculate.crc32) + (hash && m_hashes_to_calculate.md5) +
+                      (hash && m_hashes_to_calculate.sha1) + check_integrity;
+  if (workers == 0)
+    return;
+
+  {
+    std::unique_lock lock(m_chunks_in_flight_mutex);
+    m_chunks_in_flight_cv.wait(lock,
+                               [this] { return m_chunks_in_flight < MAX_CHUNKS_IN_FLIGHT; });
+    ++m_chunks_in_flight;
+  }
+
+  chunk->pending_workers = workers;
+
+  if (hash && m_hashes_to_calculate.crc32)
+    m_crc32_thread.EmplaceItem(chunk);
+  if (hash && m_hashes_to_calculate.md5)
+    m_md5_thread.EmplaceItem(chunk);
+  if (hash && m_hashes_to_calculate.sha1)
+    m_sha1_thread.EmplaceItem(chunk);
+  if (check_integrity)
+    m_integrity_thread.EmplaceItem(chunk);
+}
+
+void VolumeVerifier::FinishChunk(const Chunk& chunk)
+{
+  if (--chunk.pending_workers != 0)
+    return;
+
+  {
+    std::lock_guard lock(m_chunks_in_flight_mutex);
+    --m_chunks_in_flight;
+  }
+  m_chunks_in_flight_cv.notify_one();
+}
+
+void VolumeVerifier::CheckChunkIntegrity(const Chunk& chunk)
+{
+  if (chunk.content)
+  {
+    const IOS::ES::Content& content = *chunk.content;
+    if (!chunk.read_succeeded || !m_volume.CheckContentIntegrity(content, chunk.data, m_ticket))
+      AddProblem(Severity::High, Common::FmtFormatT("Content {0:08x} is corrupt.", content.id));
+  }
+
+  if (chunk.group_index)
+  {
+    const GroupToVerify& group = m_groups[*chunk.group_index];
+    u64 offset_in_group = 0;
+    for (u64 block_index = group.block_index_start; block_index < group.block_index_end;
+         ++block_index, offset_in_group += VolumeWii::BLOCK_TOTAL_SIZE)
+    {
+      const u64 block_offset = group.offset + offset_in_group;
+
+      if (chunk.read_succeeded && m_volume.CheckBlockIntegrity(
+                                      block_index, chunk.data.data() + offset_in_group,
+                                      group.partition))
+      {
+        m_biggest_verified_offset =
+            std::max(m_biggest_verified_offset, block_offset + VolumeWii::BLOCK_TOTAL_SIZE);
+      }
+      else
+      {
+        if (m_scrubber.CanBlockBeScrubbed(block_offset))
+        {
+          WARN_LOG_FMT(DISCIO, "Integrity check failed for unused block at {:#x}", block_offset);
+          m_unused_block_errors[group.partition]++;
+        }
+        else
+        {
+          WARN_LOG_FMT(DISCIO, "Integrity check failed for block at {:#x}", block_offset);
+          m_block_errors[group.partition]++;
+        }
+      }
+    }
+  }
+}
+
 void VolumeVerifier::Process()
 {
   ASSERT(m_started);
@@ -1152,10 +1254,12 @@ void VolumeVerifier::Process()
       excess_bytes -= bytes_over_max;
   }
 
+  auto chunk = std::make_shared<Chunk>();
+
   const bool is_data_needed = m_calculating_any_hash || content_read || group_read;
-  const bool read_succeeded = is_data_needed && ReadChunkAndWaitForAsyncOperations(bytes_to_read);
+  chunk->read_succeeded = is_data_needed && ReadChunk(bytes_to_read, &chunk->data);
 
-  if (!read_succeeded)
+  if (!chunk->read_succeeded)
   {
     ERROR_LOG_FMT(DISCIO, "Read failed at {:#x} to {:#x}", m_progress, m_progress + bytes_to_read);
 
@@ -1165,81 +1269,23 @@ void VolumeVerifier::Process()
 
   m_excess_bytes = excess_bytes;
   const u64 byte_increment = bytes_to_read - excess_bytes;
-
-  if (m_calculating_any_hash)
-  {
-    if (m_hashes_to_calculate.crc32)
-    {
-      m_crc32_future = std::async(std::launch::async, [this, byte_increment] {
-        // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
-        m_crc32_context =
-            crc32(m_crc32_context, m_data.data(), static_cast<unsigned int>(byte_increment));
-      });
-    }
-
-    if (m_hashes_to_calculate.md5)
-    {
-      m_md5_future = std::async(std::launch::async, [this, byte_increment] {
-        mbedtls_md5_update_ret(&m_md5_context, m_data.data(), byte_increment);
-      });
-    }
-
-    if (m_hashes_to_calculate.sha1)
-    {
-      m_sha1_future = std::async(std::launch::async, [this, byte_increment] {
-        mbedtls_sha1_update_ret(&m_sha1_context, m_data.data(), byte_increment);
-      });
-    }
-  }
+  chunk->bytes_to_hash = byte_increment;
 
   if (content_read)
   {
-    m_content_future = std::async(std::launch::async, [this, read_succeeded, content] {
-      if (!read_succeeded || !m_volume.CheckContentIntegrity(content, m_data, m_ticket))
-      {
-        AddProblem(Severity::High, Common::FmtFormatT("Content {0:08x} is corrupt.", content.id));
-      }
-    });
-
+    chunk->content = content;
     m_content_index++;
   }
 
   if (group_read)
   {
-    m_group_future = std::async(std::launch::async, [this, read_succeeded,
-                                                     group_index = m_group_index] {
-      const GroupToVerify& group = m_groups[group_index];
-      u64 offset_in_group = 0;
-      for (u64 block_index = group.block_index_start; block_index < group.block_index_end;
-           ++block_index, offset_in_group += VolumeWii::BLOCK_TOTAL_SIZE)
-      {
-        const u64 block_offset = group.offset + offset_in_group;
-
-        if (read_succeeded && m_volume.CheckBlockIntegrity(
-                                  block_index, m_data.data() + offset_in_group, group.partition))
-        {
-          m_biggest_verified_offset =
-              std::max(m_biggest_verified_offset, block_offset + VolumeWii::BLOCK_TOTAL_SIZE);
-        }
-        else
-        {
-          if (m_scrubber.CanBlockBeScrubbed(block_offset))
-          {
-            WARN_LOG_FMT(DISCIO, "Integrity check failed for unused block at {:#x}", block_offset);
-            m_unused_block_errors[group.partition]++;
-          }
-          else
-          {
-            WARN_LOG_FMT(DISCIO, "Integrity check failed for block at {:#x}", block_offset);
-            m_block_errors[group.partition]++;
-          }
-        }
-      }
-    });
-
+    chunk->group_index = m_group_index;
     m_group_index++;
   }
 
+  QueueChunk(chunk);
+  m_previous_chunk = std::move(chunk);
+
   m_progress += byte_increment;
 }
 
@@ -1279,8 +1325,8 @@ void VolumeVerifier::Finish()
 
     if (m_hashes_to_calculate.sha1)
     {
-      m_result.hashes.sha1 = std::vector<u8>(20);
-      mbedtls_sha1_finish_ret(&m_sha1_context, m_result.hashes.sha1.data());
+      const auto digest = m_sha1_context->Finish();
+      m_result.hashes.sha1 = std::vector<u8>(digest.begin(), digest.end());
     }
   }
 
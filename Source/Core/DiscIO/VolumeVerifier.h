@@ -3,16 +3,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <mbedtls/md5.h>
-#include <mbedtls/sha1.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/WorkQueueThread.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/DiscScrubber.h"
 #include "DiscIO/Volume.h"
@@ -142,6 +147,20 @@ private:
     size_t block_index_end;
   };
 
+  // A chunk of the volume which is read once and then handed to every worker which needs it
+  struct Chunk
+  {
+    std::vector<u8> data;
+    u64 bytes_to_hash;
+    bool read_succeeded;
+    std::optional<IOS::ES::Content> content;
+    std::optional<size_t> group_index;
+
+    // The number of workers which haven't finished processing this chunk yet
+    mutable std::atomic<u32> pending_workers{0};
+  };
+  using ChunkPointer = std::shared_ptr<const Chunk>;
+
   std::vector<Partition> CheckPartitions();
   bool CheckPartition(const Partition& partition);  // Returns false if partition should be ignored
   std::string GetPartitionName(std::optional<u32> type) const;
@@ -154,8 +173,11 @@ private:
   void CheckMisc();
   void CheckSuperPaperMario();
   void SetUpHashing();
-  void WaitForAsyncOperations() const;
-  bool ReadChunkAndWaitForAsyncOperations(u64 bytes_to_read);
+  void WaitForAsyncOperations();
+  bool ReadChunk(u64 bytes_to_read, std::vector<u8>* data) const;
+  void QueueChunk(ChunkPointer chunk);
+  void FinishChunk(const Chunk& chunk);
+  void CheckChunkIntegrity(const Chunk& chunk);
 
   void AddProblem(Severity severity, std::string text);
 
@@ -172,17 +194,18 @@ private:
 
   Hashes<bool> m_hashes_to_calculate{};
   bool m_calculating_any_hash = false;
-  unsigned long m_crc32_context = 0;
+  u32 m_crc32_context = 0;
   mbedtls_md5_context m_md5_context{};
-  mbedtls_sha1_context m_sha1_context{};
+  std::unique_ptr<Common::SHA1::Context> m_sha1_context;
 
   u64 m_excess_bytes = 0;
-  std::vector<u8> m_data;
-  std::future<void> m_crc32_future;
-  std::future<void> m_md5_future;
-  std::future<void> m_sha1_future;
-  std::future<void> m_content_future;
-  std::future<void> m_group_future;
+  ChunkPointer m_previous_chunk;
+
+  // Chunks which are queued or being processed. Limited so that reading can't get arbitrarily far
+  // ahead of the workers.
+  std::mutex m_chunks_in_flight_mutex;
+  std::condition_variable m_chunks_in_flight_cv;
+  size_t m_chunks_in_flight = 0;
 
   DiscScrubber m_scrubber;
   IOS::ES::TicketReader m_ticket;
@@ -200,6 +223,14 @@ private:
   bool m_done = false;
   u64 m_progress = 0;
   u64 m_max_progress = 0;
+
+  // Every chunk is read once and then streamed through these persistent workers. Each worker
+  // processes the chunks in order, so the hash contexts need no locking. Declared last so that
+  // the threads are stopped before anything they use is destroyed.
+  Common::WorkQueueThread<ChunkPointer> m_crc32_thread;
+  Common::WorkQueueThread<ChunkPointer> m_md5_thread;
+  Common::WorkQueueThread<ChunkPointer> m_sha1_thread;
+  Common::WorkQueueThread<ChunkPointer> m_integrity_thread;
 };
 
 }  // namespace DiscIO
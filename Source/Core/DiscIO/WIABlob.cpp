@@ -11,16 +11,18 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
 #include <fmt/format.h>
-#include <mbedtls/sha1.h>
 #include <zstd.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
@@ -76,13 +78,18 @@ std::pair<int, int> GetAllowedCompressionLevels(WIARVZCompressionType compressio
 
 template <bool RVZ>
 WIARVZFileReader<RVZ>::WIARVZFileReader(File::IOFile file, const std::string& path)
-    : m_file(std::move(file)), m_encryption_cache(this)
+    : m_file(std::move(file)), m_path(path), m_encryption_cache(this)
 {
   m_valid = Initialize(path);
 }
 
 template <bool RVZ>
-WIARVZFileReader<RVZ>::~WIARVZFileReader() = default;
+WIARVZFileReader<RVZ>::~WIARVZFileReader()
+{
+  // Don't wait for chunks that nobody is going to read anymore
+  for (std::unique_ptr<ReadAheadWorker>& worker : m_read_ahead_workers)
+    worker->thread.Cancel();
+}
 
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
@@ -106,9 +113,8 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
     return false;
   }
 
-  SHA1 header_1_actual_hash;
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(&m_header_1), sizeof(m_header_1) - sizeof(SHA1),
-                   header_1_actual_hash.data());
+  const SHA1 header_1_actual_hash = Common::SHA1::CalculateDigest(
+      reinterpret_cast<const u8*>(&m_header_1), sizeof(m_header_1) - sizeof(SHA1));
   if (m_header_1.header_1_hash != header_1_actual_hash)
     return false;
 
@@ -127,8 +133,7 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   if (!m_file.ReadBytes(header_2.data(), header_2.size()))
     return false;
 
-  SHA1 header_2_actual_hash;
-  mbedtls_sha1_ret(header_2.data(), header_2.size(), header_2_actual_hash.data());
+  const SHA1 header_2_actual_hash = Common::SHA1::CalculateDigest(header_2);
   if (m_header_1.header_2_hash != header_2_actual_hash)
     return false;
 
@@ -165,9 +170,8 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   if (!m_file.ReadBytes(partition_entries.data(), partition_entries.size()))
     return false;
 
-  SHA1 partition_entries_actual_hash;
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(partition_entries.data()), partition_entries.size(),
-                   partition_entries_actual_hash.data());
+  const SHA1 partition_entries_actual_hash = Common::SHA1::CalculateDigest(
+      reinterpret_cast<const u8*>(partition_entries.data()), partition_entries.size());
   if (m_header_2.partition_entries_hash != partition_entries_actual_hash)
     return false;
 
@@ -506,22 +510,23 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
     const u64 group_offset_in_data = i * chunk_size;
     const u64 offset_in_group = *offset - group_offset_in_data - data_offset;
 
-    chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
-
-    const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
-    u32 group_data_size = Common::swap32(group.data_size);
-
-    WIARVZCompressionType compression_type = m_compression_type;
-    u32 rvz_packed_size = 0;
-    if constexpr (RVZ)
+    if (total_group_index != m_last_group_read)
     {
-      if ((group_data_size & 0x80000000) == 0)
-        compression_type = WIARVZCompressionType::None;
+      if (total_group_index == m_last_group_read + 1)
+      {
+        ReadAhead(chunk_size, data_size, group_index, static_cast<u32>(i + 1), number_of_groups,
+                  exception_lists);
+      }
+      m_last_group_read = total_group_index;
+    }
 
-      group_data_size &= 0x7FFFFFFF;
+    chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
 
-      rvz_packed_size = Common::swap32(group.rvz_packed_size);
-    }
+    const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
+    u32 group_data_size;
+    u32 rvz_packed_size;
+    const WIARVZCompressionType compression_type =
+        GetGroupCompressionType(group, &group_data_size, &rvz_packed_size);
 
     if (group_data_size == 0)
     {
@@ -537,7 +542,7 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
 
       if (!chunk.Read(offset_in_group, bytes_to_read, *out_ptr))
       {
-        m_cached_chunk_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
+        m_chunk_cache.erase(group_offset_in_file);  // Invalidate the cache
         return false;
       }
 
@@ -567,9 +572,34 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
                                           WIARVZCompressionType compression_type,
                                           u32 exception_lists, u32 rvz_packed_size, u64 data_offset)
 {
-  if (offset_in_file == m_cached_chunk_offset)
-    return m_cached_chunk;
+  const auto it = m_chunk_cache.find(offset_in_file);
+  if (it != m_chunk_cache.end())
+  {
+    CachedChunk& cached = it->second;
+    cached.last_use = ++m_chunk_cache_use_counter;
+    if (!cached.decompressed.valid() || cached.decompressed.get())
+      return *cached.chunk;
+
+    // Reading ahead failed. Start over on this thread so that the error gets handled normally.
+    m_chunk_cache.erase(it);
+  }
 
+  std::shared_ptr<Chunk> chunk =
+      CreateChunk(&m_file, offset_in_file, compressed_size, decompressed_size, compression_type,
+                  exception_lists, rvz_packed_size, data_offset);
+  Chunk& result = *chunk;
+  m_chunk_cache.emplace(offset_in_file,
+                        CachedChunk{std::move(chunk), {}, ++m_chunk_cache_use_counter});
+  EvictChunks();
+  return result;
+}
+
+template <bool RVZ>
+std::shared_ptr<typename WIARVZFileReader<RVZ>::Chunk>
+WIARVZFileReader<RVZ>::CreateChunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size,
+                                   u64 decompressed_size, WIARVZCompressionType compression_type,
+                                   u32 exception_lists, u32 rvz_packed_size, u64 data_offset) const
+{
   std::unique_ptr<Decompressor> decompressor;
   switch (compression_type)
   {
@@ -598,11 +628,118 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
 
   const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
 
-  m_cached_chunk =
-      Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
-            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor));
-  m_cached_chunk_offset = offset_in_file;
-  return m_cached_chunk;
+  return std::make_shared<Chunk>(file, offset_in_file, compressed_size, decompressed_size,
+                                 exception_lists, compressed_exception_lists, rvz_packed_size,
+                                 data_offset, std::move(decompressor));
+}
+
+template <bool RVZ>
+WIARVZCompressionType
+WIARVZFileReader<RVZ>::GetGroupCompressionType(const GroupEntry& group, u32* data_size,
+                                               u32* rvz_packed_size) const
+{
+  *data_size = Common::swap32(group.data_size);
+  *rvz_packed_size = 0;
+
+  WIARVZCompressionType compression_type = m_compression_type;
+  if constexpr (RVZ)
+  {
+    if ((*data_size & 0x80000000) == 0)
+      compression_type = WIARVZCompressionType::None;
+
+    *data_size &= 0x7FFFFFFF;
+
+    *rvz_packed_size = Common::swap32(group.rvz_packed_size);
+  }
+
+  return compression_type;
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::ReadAhead(u64 chunk_size, u64 data_size, u32 group_index,
+                                      u32 next_group, u32 number_of_groups, u32 exception_lists)
+{
+  if (m_read_ahead_workers.empty() && !StartReadAheadWorkers())
+    return;
+
+  const u64 groups_to_read = std::max<u64>(1, READ_AHEAD_SIZE / chunk_size);
+  const u64 end_group = std::min<u64>(number_of_groups, next_group + groups_to_read);
+  for (u64 i = next_group; i < end_group; ++i)
+  {
+    const u64 total_group_index = group_index + i;
+    const u64 group_offset_in_data = i * chunk_size;
+    if (total_group_index >= m_group_entries.size() || group_offset_in_data >= data_size)
+      break;
+
+    const GroupEntry& group = m_group_entries[total_group_index];
+    u32 group_data_size;
+    u32 rvz_packed_size;
+    const WIARVZCompressionType compression_type =
+        GetGroupCompressionType(group, &group_data_size, &rvz_packed_size);
+
+    const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+    if (group_data_size == 0 || m_chunk_cache.count(group_offset_in_file) != 0)
+      continue;
+
+    ReadAheadWorker& worker = *m_read_ahead_workers[m_next_read_ahead_worker];
+    m_next_read_ahead_worker = (m_next_read_ahead_worker + 1) % m_read_ahead_workers.size();
+
+    ReadAheadRequest request;
+    request.chunk = CreateChunk(&worker.file, group_offset_in_file, group_data_size,
+                                std::min(chunk_size, data_size - group_offset_in_data),
+                                compression_type, exception_lists, rvz_packed_size,
+                                group_offset_in_data);
+    m_chunk_cache.emplace(group_offset_in_file,
+                          CachedChunk{request.chunk, request.promise.get_future().share(),
+                                      ++m_chunk_cache_use_counter});
+    worker.thread.EmplaceItem(std::move(request));
+  }
+
+  EvictChunks();
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::StartReadAheadWorkers()
+{
+  if (m_read_ahead_failed)
+    return false;
+
+  const unsigned int workers = std::clamp<unsigned int>(std::thread::hardware_concurrency(), 1,
+                                                        MAX_READ_AHEAD_WORKERS);
+  for (unsigned int i = 0; i < workers; ++i)
+  {
+    auto worker = std::make_unique<ReadAheadWorker>();
+    if (!worker->file.Open(m_path, "rb"))
+    {
+      WARN_LOG_FMT(DISCIO, "Failed to open {} for reading ahead", m_path);
+      m_read_ahead_workers.clear();
+      m_read_ahead_failed = true;
+      return false;
+    }
+
+    worker->thread.Reset([](ReadAheadRequest request) {
+      request.promise.set_value(request.chunk->DecompressAll());
+    });
+    m_read_ahead_workers.push_back(std::move(worker));
+  }
+
+  return true;
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::EvictChunks()
+{
+  // Room for the chunks that are being read ahead plus the ones that were read most recently
+  const u64 chunk_size = std::max<u32>(1, Common::swap32(m_header_2.chunk_size));
+  const size_t max_chunks = 2 * std::max<u64>(1, READ_AHEAD_SIZE / chunk_size) + 1;
+
+  while (m_chunk_cache.size() > max_chunks)
+  {
+    // A chunk that is still being decompressed is kept alive by its worker
+    m_chunk_cache.erase(std::min_element(
+        m_chunk_cache.begin(), m_chunk_cache.end(),
+        [](const auto& a, const auto& b) { return a.second.last_use < b.second.last_use; }));
+  }
 }
 
 template <bool RVZ>
@@ -619,9 +756,6 @@ std::string WIARVZFileReader<RVZ>::VersionToString(u32 version)
     return fmt::format("{}.{:02x}.{:02x}.beta{}", a, b, c, d);
 }
 
-template <bool RVZ>
-WIARVZFileReader<RVZ>::Chunk::Chunk() = default;
-
 template <bool RVZ>
 WIARVZFileReader<RVZ>::Chunk::Chunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size,
                                     u64 decompressed_size, u32 exception_lists,
@@ -645,17 +779,33 @@ WIARVZFileReader<RVZ>::Chunk::Chunk(File::IOFile* file, u64 offset_in_file, u64
 
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  if (!DecompressUntil(offset + size))
+    return false;
+
+  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressAll()
+{
+  return DecompressUntil(m_out.data.size() - m_out_bytes_allocated_for_exceptions);
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressUntil(u64 end_offset)
 {
   if (!m_decompressor || !m_file ||
-      offset + size > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
+      end_offset > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
   {
     return false;
   }
 
-  while (offset + size > GetOutBytesWrittenExcludingExceptions())
+  while (end_offset > GetOutBytesWrittenExcludingExceptions())
   {
     u64 bytes_to_read;
-    if (offset + size == m_out.data.size())
+    if (end_offset == m_out.data.size())
     {
       // Read all the remaining data.
       bytes_to_read = m_in.data.size() - m_in.bytes_written;
@@ -668,7 +818,7 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 
       // The compressed data is probably not much bigger than the decompressed data.
       // Add a few bytes for possible compression overhead and for any hash exceptions.
-      bytes_to_read = offset + size - GetOutBytesWrittenExcludingExceptions() + 0x100;
+      bytes_to_read = end_offset - GetOutBytesWrittenExcludingExceptions() + 0x100;
 
       // Align the access in an attempt to gain speed. But we don't actually know the
       // block size of the underlying storage device, so we just use the Wii block size.
@@ -748,7 +898,6 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
     }
   }
 
-  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
   return true;
 }
 
@@ -1320,8 +1469,8 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
   {
     const PartitionEntry& partition_entry = partition_entries[parameters.data_entry->index];
 
-    mbedtls_aes_context aes_context;
-    mbedtls_aes_setkey_dec(&aes_context, partition_entry.partition_key.data(), 128);
+    const std::unique_ptr<Common::AES::Context> aes_context =
+        Common::AES::CreateContextDecrypt(partition_entry.partition_key.data());
 
     const u64 groups = Common::AlignUp(parameters.data.size(), VolumeWii::GROUP_TOTAL_SIZE) /
                        VolumeWii::GROUP_TOTAL_SIZE;
@@ -1390,7 +1539,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
           {
             const u64 offset_of_block = offset_of_group + j * VolumeWii::BLOCK_TOTAL_SIZE;
             VolumeWii::DecryptBlockData(parameters.data.data() + offset_of_block,
-                                        state->decryption_buffer[j].data(), &aes_context);
+                                        state->decryption_buffer[j].data(), aes_context.get());
           }
           else
           {
@@ -1415,7 +1564,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
 
           VolumeWii::HashBlock hashes;
           VolumeWii::DecryptBlockHashes(parameters.data.data() + offset_of_block, &hashes,
-                                        &aes_context);
+                                        aes_context.get());
 
           const auto compare_hash = [&](size_t offset_in_block) {
             ASSERT(offset_in_block + sizeof(SHA1) <= VolumeWii::BLOCK_HEADER_SIZE);
@@ -1732,7 +1881,8 @@ template <bool RVZ>
 ConversionResultCode
 WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volume,
                                File::IOFile* outfile, WIARVZCompressionType compression_type,
-                               int compression_level, int chunk_size, CompressCB callback)
+                               int compression_level, int chunk_size, CompressCB callback,
+                               int num_threads)
 {
   ASSERT(infile->IsDataSizeAccurate());
   ASSERT(chunk_size > 0);
@@ -1838,7 +1988,7 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   };
 
   MultithreadedCompressor<CompressThreadState, CompressParameters, OutputParameters> mt_compressor(
-      set_up_compress_thread_state, process_and_compress, output);
+      set_up_compress_thread_state, process_and_compress, output, num_threads);
 
   for (const DataEntry& data_entry : data_entries)
   {
@@ -1992,10 +2142,8 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   header_2.partition_entry_size = Common::swap32(sizeof(PartitionEntry));
   header_2.partition_entries_offset = Common::swap64(partition_entries_offset);
 
-  if (partition_entries.data() == nullptr)
-    partition_entries.reserve(1);  // Avoid a crash in mbedtls_sha1_ret
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(partition_entries.data()), partition_entries_size,
-                   header_2.partition_entries_hash.data());
+  header_2.partition_entries_hash = Common::SHA1::CalculateDigest(
+      reinterpret_cast<const u8*>(partition_entries.data()), partition_entries_size);
 
   header_2.number_of_raw_data_entries = Common::swap32(static_cast<u32>(raw_data_entries.size()));
   header_2.raw_data_entries_offset = Common::swap64(raw_data_entries_offset);
@@ -2011,12 +2159,12 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   header_1.version_compatible =
       Common::swap32(RVZ ? RVZ_VERSION_WRITE_COMPATIBLE : WIA_VERSION_WRITE_COMPATIBLE);
   header_1.header_2_size = Common::swap32(sizeof(WIAHeader2));
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(&header_2), sizeof(header_2),
-                   header_1.header_2_hash.data());
+  header_1.header_2_hash =
+      Common::SHA1::CalculateDigest(reinterpret_cast<const u8*>(&header_2), sizeof(header_2));
   header_1.iso_file_size = Common::swap64(infile->GetDataSize());
   header_1.wia_file_size = Common::swap64(outfile->GetSize());
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(&header_1), offsetof(WIAHeader1, header_1_hash),
-                   header_1.header_1_hash.data());
+  header_1.header_1_hash = Common::SHA1::CalculateDigest(reinterpret_cast<const u8*>(&header_1),
+                                                         offsetof(WIAHeader1, header_1_hash));
 
   if (!outfile->Seek(0, SEEK_SET))
     return ConversionResultCode::WriteFailed;
@@ -2032,7 +2180,7 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
 bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
                        const std::string& outfile_path, bool rvz,
                        WIARVZCompressionType compression_type, int compression_level,
-                       int chunk_size, CompressCB callback)
+                       int chunk_size, CompressCB callback, int num_threads)
 {
   File::IOFile outfile(outfile_path, "wb");
   if (!outfile)
@@ -2050,7 +2198,7 @@ bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
   const auto convert = rvz ? RVZFileReader::Convert : WIAFileReader::Convert;
   const ConversionResultCode result =
       convert(infile, infile_volume.get(), &outfile, compression_type, compression_level,
-              chunk_size, callback);
+              chunk_size, callback, num_threads);
 
   if (result == ConversionResultCode::ReadFailed)
     PanicAlertFmtT("Failed to read from the input file \"{0}\".", infile_path);
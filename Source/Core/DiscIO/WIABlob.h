@@ -4,16 +4,20 @@
 #pragma once
 
 #include <array>
+#include <future>
 #include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
 #include "Common/Swap.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/MultithreadedCompressor.h"
 #include "DiscIO/WIACompression.h"
@@ -63,7 +67,8 @@ public:
 
   static ConversionResultCode Convert(BlobReader* infile, const VolumeDisc* infile_volume,
                                       File::IOFile* outfile, WIARVZCompressionType compression_type,
-                                      int compression_level, int chunk_size, CompressCB callback);
+                                      int compression_level, int chunk_size, CompressCB callback,
+                                      int num_threads);
 
 private:
   using SHA1 = std::array<u8, 20>;
@@ -182,13 +187,15 @@ private:
   class Chunk
   {
   public:
-    Chunk();
     Chunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
           u32 exception_lists, bool compressed_exception_lists, u32 rvz_packed_size,
           u64 data_offset, std::unique_ptr<Decompressor> decompressor);
 
     bool Read(u64 offset, u64 size, u8* out_ptr);
 
+    // Decompresses everything, so that later reads don't need to access the file
+    bool DecompressAll();
+
     // This can only be called once at least one byte of data has been read
     void GetHashExceptions(std::vector<HashExceptionEntry>* exception_list,
                            u64 exception_list_index, u16 additional_offset) const;
@@ -200,6 +207,7 @@ private:
     }
 
   private:
+    bool DecompressUntil(u64 end_offset);
     bool Decompress();
     bool HandleExceptions(const u8* data, size_t bytes_allocated, size_t bytes_written,
                           size_t* bytes_used, bool align);
@@ -235,6 +243,17 @@ private:
   Chunk& ReadCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
                             WIARVZCompressionType compression_type, u32 exception_lists = 0,
                             u32 rvz_packed_size = 0, u64 data_offset = 0);
+  std::shared_ptr<Chunk> CreateChunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size,
+                                     u64 decompressed_size, WIARVZCompressionType compression_type,
+                                     u32 exception_lists, u32 rvz_packed_size,
+                                     u64 data_offset) const;
+  WIARVZCompressionType GetGroupCompressionType(const GroupEntry& group, u32* data_size,
+                                                u32* rvz_packed_size) const;
+
+  void ReadAhead(u64 chunk_size, u64 data_size, u32 group_index, u32 next_group,
+                 u32 number_of_groups, u32 exception_lists);
+  bool StartReadAheadWorkers();
+  void EvictChunks();
 
   static bool ApplyHashExceptions(const std::vector<HashExceptionEntry>& exception_list,
                                   VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
@@ -361,10 +380,39 @@ private:
   WIARVZCompressionType m_compression_type;
 
   File::IOFile m_file;
-  Chunk m_cached_chunk;
-  u64 m_cached_chunk_offset = std::numeric_limits<u64>::max();
+  std::string m_path;
   WiiEncryptionCache m_encryption_cache;
 
+  // Chunks are decompressed ahead of time on worker threads (each with its own file handle) once
+  // groups start getting read sequentially. Decompressed chunks, including the ones decompressed
+  // on the reading thread, are kept in a small LRU cache keyed by their offset in the file.
+  struct ReadAheadRequest
+  {
+    std::shared_ptr<Chunk> chunk;
+    std::promise<bool> promise;
+  };
+
+  struct ReadAheadWorker
+  {
+    File::IOFile file;
+    Common::WorkQueueThread<ReadAheadRequest> thread;
+  };
+
+  struct CachedChunk
+  {
+    std::shared_ptr<Chunk> chunk;
+    std::shared_future<bool> decompressed;  // Only valid for chunks handed to a worker
+    u64 last_use;
+  };
+
+  std::vector<std::unique_ptr<ReadAheadWorker>> m_read_ahead_workers;
+  size_t m_next_read_ahead_worker = 0;
+  bool m_read_ahead_failed = false;
+  u64 m_last_group_read = std::numeric_limits<u64>::max();
+
+  std::map<u64, CachedChunk> m_chunk_cache;
+  u64 m_chunk_cache_use_counter = 0;
+
   std::vector<HashExceptionEntry> m_exception_list;
   bool m_write_to_exception_list = false;
   u64 m_exception_list_last_group_index;
@@ -388,6 +436,10 @@ private:
   static constexpr u32 RVZ_VERSION = 0x01000000;
   static constexpr u32 RVZ_VERSION_WRITE_COMPATIBLE = 0x00030000;
   static constexpr u32 RVZ_VERSION_READ_COMPATIBLE = 0x00030000;
+
+  // How much data to decompress ahead of the current position when reading sequentially
+  static constexpr u64 READ_AHEAD_SIZE = 8 * 1024 * 1024;
+  static constexpr unsigned int MAX_READ_AHEAD_WORKERS = 4;
 };
 
 using WIAFileReader = WIARVZFileReader<false>;
@@ -26,8 +26,8 @@ static const QStringList game_filters{
     QStringLiteral("*.[tT][gG][cC]"), QStringLiteral("*.[cC][iI][sS][oO]"),
     QStringLiteral("*.[gG][cC][zZ]"), QStringLiteral("*.[wW][bB][fF][sS]"),
     QStringLiteral("*.[wW][iI][aA]"), QStringLiteral("*.[rR][vV][zZ]"),
-    QStringLiteral("*.[wW][aA][dD]"), QStringLiteral("*.[eE][lL][fF]"),
-    QStringLiteral("*.[dD][oO][lL]")};
+    QStringLiteral("*.[dD][cC][sS]"), QStringLiteral("*.[wW][aA][dD]"),
+    QStringLiteral("*.[eE][lL][fF]"), QStringLiteral("*.[dD][oO][lL]")};
 
 GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
 {
@@ -37,6 +37,12 @@ GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
   connect(qApp, &QApplication::aboutToQuit, this, [this] {
     m_processing_halted = true;
     m_load_thread.Cancel();
+    // Cancelling drops a queued SaveCache, so save here instead now that the thread has stopped
+    if (m_cache_save_queued)
+    {
+      m_cache_save_queued = false;
+      m_cache.Save();
+    }
   });
   connect(this, &QFileSystemWatcher::directoryChanged, this, &GameTracker::UpdateDirectory);
   connect(this, &QFileSystemWatcher::fileChanged, this, &GameTracker::UpdateFile);
@@ -81,8 +87,18 @@ GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
           m_processing_halted);
       QueueOnObject(this, [] { Settings::Instance().NotifyMetadataRefreshComplete(); });
       break;
+    case CommandType::SaveCache:
+      m_cache_save_queued = false;
+      m_cache.Save();
+      break;
     case CommandType::ResumeProcessing:
       m_processing_halted = false;
+      // RefreshAll clears the queue, which may have dropped a queued SaveCache
+      if (m_cache_save_queued)
+      {
+        m_cache_save_queued = false;
+        m_cache.Save();
+      }
       break;
     case CommandType::PurgeCache:
       m_cache.Clear(UICommon::GameFileCache::DeleteOnDisk::Yes);
@@ -356,10 +372,21 @@ void GameTracker::LoadGame(const QString& path)
     if (game)
       emit GameLoaded(std::move(game));
     if (cache_changed)
-      m_cache.Save();
+      QueueCacheSave();
   }
 }
 
+// Saving writes the whole cache, so when many files change at once (such as when a directory
+// is added or a lot of games are copied into one), save once after all of them are processed.
+void GameTracker::QueueCacheSave()
+{
+  if (m_cache_save_queued)
+    return;
+
+  m_cache_save_queued = true;
+  m_load_thread.EmplaceItem(Command{CommandType::SaveCache, {}});
+}
+
 void GameTracker::PurgeCache()
 {
   m_needs_purge = true;
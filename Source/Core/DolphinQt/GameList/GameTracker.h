@@ -59,6 +59,7 @@ private:
   void UpdateFileInternal(const QString& path);
   QSet<QString> FindMissingFiles(const QString& dir);
   void LoadGame(const QString& path);
+  void QueueCacheSave();
 
   bool AddPath(const QString& path);
   bool RemovePath(const QString& path);
@@ -72,6 +73,7 @@ private:
     UpdateDirectory,
     UpdateFile,
     UpdateMetadata,
+    SaveCache,
     ResumeProcessing,
     PurgeCache,
     BeginRefresh,
@@ -94,6 +96,8 @@ private:
   bool m_initial_games_emitted = false;
   bool m_started = false;
   bool m_needs_purge = false;
+  // Only accessed on m_load_thread, or after it has been stopped
+  bool m_cache_save_queued = false;
   std::atomic_bool m_processing_halted = false;
 };
 
@@ -44,7 +44,7 @@ void PathPane::BrowseDefaultGame()
   QString file = QDir::toNativeSeparators(DolphinFileDialog::getOpenFileName(
       this, tr("Select a Game"), Settings::Instance().GetDefaultGame(),
       tr("All GC/Wii files (*.elf *.dol *.gcm *.iso *.tgc *.wbfs "
-         "*.ciso *.gcz *.wia *.rvz *.wad *.m3u);;All Files (*)")));
+         "*.ciso *.gcz *.wia *.rvz *.dcs *.wad *.m3u);;All Files (*)")));
 
   if (!file.isEmpty())
     Settings::Instance().SetDefaultGame(file);
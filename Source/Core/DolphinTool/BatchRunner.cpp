@@ -0,0 +1,240 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/BatchRunner.h"
+
+#include <OptionParser.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Timer.h"
+
+namespace DolphinTool
+{
+static bool IsSuccess(const picojson::object& result)
+{
+  const auto it = result.find("success");
+  return it != result.end() && it->second.is<bool>() && it->second.get<bool>();
+}
+
+void BatchRunner::AddOptions(optparse::OptionParser* parser)
+{
+  parser->add_option("-j", "--jobs")
+      .type("int")
+      .action("store")
+      .set_default(1)
+      .help("Number of images to process at the same time [%default]")
+      .metavar("N");
+
+  parser->add_option("-t", "--threads")
+      .type("int")
+      .action("store")
+      .help("Total number of worker threads shared by all jobs. Defaults to the number of CPU "
+            "threads")
+      .metavar("N");
+
+  parser->add_option("-r", "--resume")
+      .type("string")
+      .action("store")
+      .help("Progress file. Images which already finished successfully according to it are "
+            "skipped, and every finished image is added to it")
+      .metavar("FILE");
+
+  parser->add_option("-s", "--summary")
+      .type("string")
+      .action("store")
+      .help("Write a JSON summary of all images to this file")
+      .metavar("FILE");
+}
+
+bool BatchRunner::ParseOptions(const optparse::Values& options)
+{
+  m_jobs = static_cast<int>(options.get("jobs"));
+  if (m_jobs < 1)
+  {
+    std::fprintf(stderr, "Error: The number of jobs must be at least 1\n");
+    return false;
+  }
+
+  m_threads = options.is_set("threads") ? static_cast<int>(options.get("threads")) :
+                                          static_cast<int>(std::thread::hardware_concurrency());
+  m_threads = std::max(m_threads, 1);
+
+  if (options.is_set("resume"))
+    m_resume_path = static_cast<const char*>(options.get("resume"));
+  if (options.is_set("summary"))
+    m_summary_path = static_cast<const char*>(options.get("summary"));
+
+  return true;
+}
+
+void BatchRunner::LoadResumeFile()
+{
+  std::string contents;
+  if (m_resume_path.empty() || !File::ReadFileToString(m_resume_path, contents))
+    return;
+
+  std::istringstream stream(contents);
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    picojson::value value;
+    const std::string error = picojson::parse(value, line);
+    if (!error.empty() || !value.is<picojson::object>())
+      continue;
+
+    // Only the latest entry for each image counts
+    const picojson::object& result = value.get<picojson::object>();
+    const auto input = result.find("input");
+    if (input == result.end() || !input->second.is<std::string>())
+      continue;
+
+    const auto same_input = [&input](const picojson::object& other) {
+      return other.at("input").get<std::string>() == input->second.get<std::string>();
+    };
+    m_resumed_results.erase(
+        std::remove_if(m_resumed_results.begin(), m_resumed_results.end(), same_input),
+        m_resumed_results.end());
+    m_resumed_results.push_back(result);
+  }
+
+  // Failed images get another try
+  m_resumed_results.erase(std::remove_if(m_resumed_results.begin(), m_resumed_results.end(),
+                                         [](const auto& result) { return !IsSuccess(result); }),
+                          m_resumed_results.end());
+}
+
+int BatchRunner::Run(const std::vector<std::string>& inputs, const Job& job)
+{
+  LoadResumeFile();
+
+  std::set<std::string> finished_inputs;
+  for (const picojson::object& result : m_resumed_results)
+    finished_inputs.insert(result.at("input").get<std::string>());
+
+  std::vector<std::string> pending_inputs;
+  for (const std::string& input : inputs)
+  {
+    if (finished_inputs.count(input) == 0)
+      pending_inputs.push_back(input);
+  }
+
+  if (pending_inputs.size() != inputs.size())
+  {
+    std::printf("Skipping %zu image(s) which were already processed\n",
+                inputs.size() - pending_inputs.size());
+  }
+
+  File::IOFile resume_file;
+  if (!m_resume_path.empty())
+  {
+    resume_file.Open(m_resume_path, "ab");
+    if (!resume_file)
+    {
+      std::fprintf(stderr, "Error: Failed to open %s\n", m_resume_path.c_str());
+      return 1;
+    }
+  }
+
+  // Every job needs at least one thread, so the thread budget also limits the number of jobs
+  const int num_workers =
+      std::min({m_jobs, m_threads, static_cast<int>(pending_inputs.size())});
+  const int threads_per_job = std::max(1, m_threads / std::max(num_workers, 1));
+
+  std::vector<picojson::object> results(pending_inputs.size());
+  std::atomic<size_t> next_input = 0;
+  size_t num_finished = 0;
+  std::mutex mutex;
+
+  const u64 start_time_us = Common::Timer::GetTimeUs();
+
+  const auto worker = [&] {
+    while (true)
+    {
+      const size_t index = next_input++;
+      if (index >= pending_inputs.size())
+        return;
+
+      const std::string& input = pending_inputs[index];
+      const u64 job_start_time_us = Common::Timer::GetTimeUs();
+
+      picojson::object result = job(input, threads_per_job);
+      result["input"] = picojson::value(input);
+      result["seconds"] =
+          picojson::value((Common::Timer::GetTimeUs() - job_start_time_us) / 1000000.0);
+
+      std::lock_guard lock(mutex);
+      ++num_finished;
+
+      const bool success = IsSuccess(result);
+      const auto error = result.find("error");
+      std::printf("[%zu/%zu] %s %s%s%s\n", num_finished, pending_inputs.size(),
+                  success ? "OK    " : "FAILED", input.c_str(),
+                  error != result.end() ? ": " : "",
+                  error != result.end() ? error->second.to_str().c_str() : "");
+      std::fflush(stdout);
+
+      if (resume_file)
+      {
+        resume_file.WriteString(picojson::value(result).serialize() + '\n');
+        resume_file.Flush();
+      }
+
+      results[index] = std::move(result);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < num_workers; ++i)
+    workers.emplace_back(worker);
+  worker();
+  for (std::thread& thread : workers)
+    thread.join();
+
+  results.insert(results.begin(), m_resumed_results.begin(), m_resumed_results.end());
+  const size_t num_failed = std::count_if(results.begin(), results.end(),
+                                          [](const auto& result) { return !IsSuccess(result); });
+
+  std::printf("%zu of %zu image(s) succeeded\n", results.size() - num_failed, results.size());
+
+  if (!m_summary_path.empty())
+  {
+    picojson::array result_array;
+    for (picojson::object& result : results)
+      result_array.emplace_back(std::move(result));
+
+    picojson::object summary;
+    summary["images"] = picojson::value(std::move(result_array));
+    summary["succeeded"] = picojson::value(static_cast<double>(results.size() - num_failed));
+    summary["failed"] = picojson::value(static_cast<double>(num_failed));
+    summary["threads"] = picojson::value(static_cast<double>(m_threads));
+    summary["seconds"] = picojson::value((Common::Timer::GetTimeUs() - start_time_us) / 1000000.0);
+
+    if (!File::WriteStringToFile(m_summary_path, picojson::value(summary).serialize(true)))
+    {
+      std::fprintf(stderr, "Error: Failed to write %s\n", m_summary_path.c_str());
+      return 1;
+    }
+  }
+
+  return num_failed == 0 ? 0 : 1;
+}
+
+std::string BatchRunner::FormatHash(const u8* hash, size_t size)
+{
+  std::string result;
+  for (size_t i = 0; i < size; ++i)
+    result += fmt::format("{:02x}", hash[i]);
+  return result;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,61 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <picojson.h>
+
+#include "Common/CommonTypes.h"
+
+namespace optparse
+{
+class OptionParser;
+class Values;
+}  // namespace optparse
+
+namespace DolphinTool
+{
+// Runs a job for each disc image in a list, for the commands that work on many images at once.
+class BatchRunner
+{
+public:
+  // The job gets the input path and the number of worker threads it may use. It returns an object
+  // describing the result, which must contain a "success" boolean and may contain an "error".
+  using Job = std::function<picojson::object(const std::string& input, int threads)>;
+
+  // Adds the --jobs, --threads, --resume and --summary options
+  static void AddOptions(optparse::OptionParser* parser);
+
+  // Returns false and prints an error if the options are invalid
+  bool ParseOptions(const optparse::Values& options);
+
+  // Returns the exit code for the command
+  int Run(const std::vector<std::string>& inputs, const Job& job);
+
+  // Formats a hash as a lowercase hex string for the results
+  static std::string FormatHash(const u8* hash, size_t size);
+
+private:
+  void LoadResumeFile();
+
+  // How many images are processed at the same time
+  int m_jobs = 1;
+
+  // The total number of worker threads that may be used across all jobs. This is split evenly
+  // between the jobs, instead of each job using one thread per CPU thread.
+  int m_threads = 0;
+
+  // Every finished job is appended to this file as one line of JSON. Images which already have a
+  // successful entry in the file are skipped, so an interrupted batch can be resumed.
+  std::string m_resume_path;
+
+  // If set, the results of all jobs (including resumed ones) are written here as JSON
+  std::string m_summary_path;
+
+  std::vector<picojson::object> m_resumed_results;
+};
+}  // namespace DolphinTool
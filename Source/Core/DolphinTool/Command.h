@@ -0,0 +1,19 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace DolphinTool
+{
+class Command
+{
+public:
+  virtual ~Command() = default;
+
+  // Runs the command with the arguments following the command name. Returns the exit code.
+  virtual int Main(const std::vector<std::string>& args) = 0;
+};
+}  // namespace DolphinTool
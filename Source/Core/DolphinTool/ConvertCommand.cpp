@@ -0,0 +1,399 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/ConvertCommand.h"
+
+#include <OptionParser.h>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <optional>
+
+#include "Common/CommonPaths.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/MathUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "DiscIO/ScrubbedBlob.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeDisc.h"
+#include "DolphinTool/BatchRunner.h"
+
+namespace DolphinTool
+{
+// Because DVD timings are emulated as if we can't read less than an entire ECC block at once
+// (32 KiB - 0x8000), there is little reason to use a block size smaller than that.
+constexpr int MIN_BLOCK_SIZE = 0x8000;
+
+// For performance reasons, blocks shouldn't be too large.
+// 2 MiB (0x200000) was picked because it is the smallest block size supported by WIA.
+constexpr int MAX_BLOCK_SIZE = 0x200000;
+
+constexpr int DEFAULT_BLOCK_SIZE = 0x20000;
+
+static std::optional<DiscIO::BlobType> ParseFormat(const std::string& format)
+{
+  if (format == "iso")
+    return DiscIO::BlobType::PLAIN;
+  if (format == "gcz")
+    return DiscIO::BlobType::GCZ;
+  if (format == "wia")
+    return DiscIO::BlobType::WIA;
+  if (format == "rvz")
+    return DiscIO::BlobType::RVZ;
+  if (format == "dcs")
+    return DiscIO::BlobType::DCS;
+  return std::nullopt;
+}
+
+static std::optional<DiscIO::WIARVZCompressionType> ParseCompression(const std::string& compression)
+{
+  if (compression == "none")
+    return DiscIO::WIARVZCompressionType::None;
+  if (compression == "purge")
+    return DiscIO::WIARVZCompressionType::Purge;
+  if (compression == "bzip2")
+    return DiscIO::WIARVZCompressionType::Bzip2;
+  if (compression == "lzma")
+    return DiscIO::WIARVZCompressionType::LZMA;
+  if (compression == "lzma2")
+    return DiscIO::WIARVZCompressionType::LZMA2;
+  if (compression == "zstd")
+    return DiscIO::WIARVZCompressionType::Zstd;
+  return std::nullopt;
+}
+
+static const char* GetExtension(DiscIO::BlobType format)
+{
+  switch (format)
+  {
+  case DiscIO::BlobType::GCZ:
+    return ".gcz";
+  case DiscIO::BlobType::WIA:
+    return ".wia";
+  case DiscIO::BlobType::RVZ:
+    return ".rvz";
+  case DiscIO::BlobType::DCS:
+    return ".dcs";
+  default:
+    return ".iso";
+  }
+}
+
+// Picks the same block size as the convert dialog in DolphinQt
+static int GetDefaultBlockSize(DiscIO::BlobType format, u64 data_size)
+{
+  switch (format)
+  {
+  case DiscIO::BlobType::GCZ:
+  {
+    // In order for versions of Dolphin prior to 5.0-11893 to be able to convert a GCZ file
+    // to ISO without messing up the final part of the file in some way, the file size
+    // must be an integer multiple of the block size (fixed in 3aa463c) and must not be
+    // an integer multiple of the block size multiplied by 32 (fixed in 26b21e3).
+    const auto block_size_ok = [data_size](int block_size) {
+      constexpr u64 BLOCKS_PER_BUFFER = 32;
+      return data_size % block_size == 0 && data_size % (block_size * BLOCKS_PER_BUFFER) != 0;
+    };
+
+    // Use the largest block size in the normal range which isn't larger than the default size
+    // and doesn't cause problems, or else the block size that was hardcoded in old versions.
+    int result = 0x4000;
+    for (int block_size = MIN_BLOCK_SIZE; block_size <= DEFAULT_BLOCK_SIZE; block_size *= 2)
+    {
+      if (block_size_ok(block_size))
+        result = block_size;
+    }
+    return result;
+  }
+  case DiscIO::BlobType::WIA:
+    return MAX_BLOCK_SIZE;
+  default:
+    return DEFAULT_BLOCK_SIZE;
+  }
+}
+
+static std::optional<std::string> CalculateSHA1(const std::string& path)
+{
+  File::IOFile file(path, "rb");
+  if (!file)
+    return std::nullopt;
+
+  const std::unique_ptr<Common::SHA1::Context> context = Common::SHA1::CreateContext();
+  std::vector<u8> buffer(0x100000);
+  u64 remaining = file.GetSize();
+  while (remaining > 0)
+  {
+    const size_t size = static_cast<size_t>(std::min<u64>(buffer.size(), remaining));
+    if (!file.ReadBytes(buffer.data(), size))
+      return std::nullopt;
+    context->Update(buffer.data(), size);
+    remaining -= size;
+  }
+
+  const Common::SHA1::Digest digest = context->Finish();
+  return BatchRunner::FormatHash(digest.data(), digest.size());
+}
+
+int ConvertCommand::Main(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: convert [options]... IMAGE...");
+  parser.description("Converts disc images to another format. Several images can be converted "
+                     "at the same time, sharing a fixed number of compression threads.");
+
+  parser.add_option("-o", "--output-dir")
+      .type("string")
+      .action("store")
+      .help("Directory to write the converted images to")
+      .metavar("DIRECTORY");
+
+  parser.add_option("-f", "--format")
+      .type("string")
+      .action("store")
+      .help("Format to convert to: iso, gcz, wia, rvz or dcs")
+      .metavar("FORMAT");
+
+  parser.add_option("-b", "--block-size")
+      .type("int")
+      .action("store")
+      .help("Block size in bytes for GCZ, WIA, RVZ and DCS. By default, the same block size as in "
+            "the convert dialog is used")
+      .metavar("SIZE");
+
+  parser.add_option("-c", "--compression")
+      .type("string")
+      .action("store")
+      .help("Compression method for WIA and RVZ: none, purge (WIA only), bzip2, lzma, lzma2 or "
+            "zstd (RVZ only). Defaults to zstd for RVZ and none for WIA")
+      .metavar("METHOD");
+
+  parser.add_option("-l", "--compression-level")
+      .type("int")
+      .action("store")
+      .set_default(5)
+      .help("Compression level for WIA, RVZ and DCS [%default]")
+      .metavar("LEVEL");
+
+  parser.add_option("--scrub")
+      .action("store_true")
+      .help("Remove junk data (irreversible). Not available for RVZ, which stores junk data "
+            "efficiently anyway");
+
+  parser.add_option("--store")
+      .type("string")
+      .action("store")
+      .help("Chunk store for DCS images, shared by all images converted into it. Defaults to "
+            "the directory \"chunks\" in the output directory")
+      .metavar("DIRECTORY");
+
+  parser.add_option("--hash")
+      .action("store_true")
+      .help("Calculate the SHA-1 of each converted image for the summary");
+
+  BatchRunner::AddOptions(&parser);
+
+  optparse::Values& options = parser.parse_args(args);
+  const std::vector<std::string> inputs = parser.args();
+
+  BatchRunner runner;
+  if (!runner.ParseOptions(options))
+    return 1;
+
+  if (inputs.empty())
+  {
+    std::fprintf(stderr, "Error: No input images set\n");
+    return 1;
+  }
+
+  if (!options.is_set("output_dir"))
+  {
+    std::fprintf(stderr, "Error: No output directory set\n");
+    return 1;
+  }
+  m_output_directory = static_cast<const char*>(options.get("output_dir"));
+  if (!File::IsDirectory(m_output_directory) && !File::CreateFullPath(m_output_directory + '/'))
+  {
+    std::fprintf(stderr, "Error: Failed to create %s\n", m_output_directory.c_str());
+    return 1;
+  }
+
+  const std::optional<DiscIO::BlobType> format =
+      ParseFormat(options.is_set("format") ? static_cast<const char*>(options.get("format")) : "");
+  if (!format)
+  {
+    std::fprintf(stderr, "Error: No valid output format set\n");
+    return 1;
+  }
+  m_format = *format;
+
+  const bool wia_or_rvz = m_format == DiscIO::BlobType::WIA || m_format == DiscIO::BlobType::RVZ;
+
+  if (options.is_set("block_size"))
+  {
+    m_block_size = static_cast<int>(options.get("block_size"));
+    if (m_block_size < MIN_BLOCK_SIZE || !MathUtil::IsPow2(m_block_size) ||
+        (m_format == DiscIO::BlobType::WIA && m_block_size < MAX_BLOCK_SIZE))
+    {
+      std::fprintf(stderr, "Error: Invalid block size %d\n", m_block_size);
+      return 1;
+    }
+  }
+
+  // DCS always uses Zstandard, but the level can be set
+  m_compression = m_format == DiscIO::BlobType::RVZ || m_format == DiscIO::BlobType::DCS ?
+                      DiscIO::WIARVZCompressionType::Zstd :
+                      DiscIO::WIARVZCompressionType::None;
+  if (options.is_set("compression"))
+  {
+    const std::optional<DiscIO::WIARVZCompressionType> compression =
+        ParseCompression(static_cast<const char*>(options.get("compression")));
+    if (!compression || !wia_or_rvz ||
+        (*compression == DiscIO::WIARVZCompressionType::Purge &&
+         m_format != DiscIO::BlobType::WIA) ||
+        (*compression == DiscIO::WIARVZCompressionType::Zstd && m_format != DiscIO::BlobType::RVZ))
+    {
+      std::fprintf(stderr, "Error: Invalid compression method for this format\n");
+      return 1;
+    }
+    m_compression = *compression;
+  }
+
+  const std::pair<int, int> levels = DiscIO::GetAllowedCompressionLevels(m_compression);
+  m_compression_level = static_cast<int>(options.get("compression_level"));
+  if (levels.first > levels.second)
+  {
+    m_compression_level = 0;
+  }
+  else if (m_compression_level < levels.first || m_compression_level > levels.second)
+  {
+    std::fprintf(stderr, "Error: The compression level must be between %d and %d\n",
+                 levels.first, levels.second);
+    return 1;
+  }
+
+  m_scrub = static_cast<bool>(options.get("scrub"));
+  if (m_scrub && m_format == DiscIO::BlobType::RVZ)
+  {
+    std::fprintf(stderr, "Error: Junk data can't be removed when converting to RVZ\n");
+    return 1;
+  }
+
+  m_hash = static_cast<bool>(options.get("hash"));
+
+  m_store_path = options.is_set("store") ? static_cast<const char*>(options.get("store")) :
+                                           m_output_directory + DIR_SEP "chunks";
+
+  // Images with the same name in different directories would be written to the same file
+  std::map<std::string, int> output_counts;
+  for (const std::string& input : inputs)
+    output_counts[GetOutputPath(input)]++;
+  for (const auto& [output, count] : output_counts)
+  {
+    if (count > 1)
+      m_duplicate_outputs.insert(output);
+  }
+
+  return runner.Run(inputs, [this](const std::string& input, int threads) {
+    return ConvertImage(input, threads);
+  });
+}
+
+std::string ConvertCommand::GetOutputPath(const std::string& input) const
+{
+  std::string name;
+  SplitPath(input, nullptr, &name, nullptr);
+  return m_output_directory + DIR_SEP + name + GetExtension(m_format);
+}
+
+picojson::object ConvertCommand::ConvertImage(const std::string& input, int threads) const
+{
+  picojson::object result;
+  const auto fail = [&result](const std::string& error) {
+    result["success"] = picojson::value(false);
+    result["error"] = picojson::value(error);
+    return result;
+  };
+
+  const std::string output = GetOutputPath(input);
+  result["output"] = picojson::value(output);
+
+  if (output == input)
+    return fail("The output would overwrite the input");
+  if (m_duplicate_outputs.count(output) != 0)
+    return fail("Another input image would be converted to the same output file");
+
+  std::unique_ptr<DiscIO::BlobReader> blob_reader =
+      m_scrub ? DiscIO::ScrubbedBlob::Create(input) : DiscIO::CreateBlobReader(input);
+  if (!blob_reader)
+    return fail(m_scrub ? "Failed to open the image or to remove its junk data" :
+                          "Failed to open the image");
+
+  if (!blob_reader->IsDataSizeAccurate())
+    return fail("The size of the image's data is unknown");
+
+  const u64 data_size = blob_reader->GetDataSize();
+  const int block_size =
+      m_block_size != 0 ? m_block_size : GetDefaultBlockSize(m_format, data_size);
+
+  const auto callback = [](const std::string&, float) { return true; };
+
+  const u64 start_time_us = Common::Timer::GetTimeUs();
+
+  bool success = false;
+  switch (m_format)
+  {
+  case DiscIO::BlobType::PLAIN:
+    success = DiscIO::ConvertToPlain(blob_reader.get(), input, output, callback);
+    break;
+
+  case DiscIO::BlobType::GCZ:
+  {
+    const std::unique_ptr<DiscIO::VolumeDisc> volume = DiscIO::CreateDisc(input);
+    const u32 sub_type = volume && volume->GetVolumeType() == DiscIO::Platform::WiiDisc ? 1 : 0;
+    success = DiscIO::ConvertToGCZ(blob_reader.get(), input, output, sub_type, block_size,
+                                   callback, threads);
+    break;
+  }
+
+  case DiscIO::BlobType::DCS:
+    success = DiscIO::ConvertToDCS(blob_reader.get(), input, output, m_store_path, block_size,
+                                   m_compression_level, callback, threads);
+    result["store"] = picojson::value(m_store_path);
+    break;
+
+  default:
+    success = DiscIO::ConvertToWIAOrRVZ(blob_reader.get(), input, output,
+                                        m_format == DiscIO::BlobType::RVZ, m_compression,
+                                        m_compression_level, block_size, callback, threads);
+    break;
+  }
+
+  const double seconds = (Common::Timer::GetTimeUs() - start_time_us) / 1000000.0;
+
+  if (!success)
+    return fail("Conversion failed");
+
+  const u64 output_size = File::GetSize(output);
+  result["success"] = picojson::value(true);
+  result["data_size"] = picojson::value(static_cast<double>(data_size));
+  result["output_size"] = picojson::value(static_cast<double>(output_size));
+  result["block_size"] = picojson::value(static_cast<double>(block_size));
+  result["threads"] = picojson::value(static_cast<double>(threads));
+  result["mib_per_second"] =
+      picojson::value(data_size / (1024.0 * 1024.0) / std::max(seconds, 0.001));
+
+  if (m_hash)
+  {
+    const std::optional<std::string> sha1 = CalculateSHA1(output);
+    if (!sha1)
+      return fail("Failed to read the converted image");
+    result["sha1"] = picojson::value(*sha1);
+  }
+
+  return result;
+}
+}  // namespace DolphinTool
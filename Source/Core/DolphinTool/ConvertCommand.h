@@ -0,0 +1,37 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <picojson.h>
+
+#include "DiscIO/Blob.h"
+#include "DiscIO/WIABlob.h"
+#include "DolphinTool/Command.h"
+
+namespace DolphinTool
+{
+class ConvertCommand final : public Command
+{
+public:
+  int Main(const std::vector<std::string>& args) override;
+
+private:
+  std::string GetOutputPath(const std::string& input) const;
+  picojson::object ConvertImage(const std::string& input, int threads) const;
+
+  std::string m_output_directory;
+  DiscIO::BlobType m_format = DiscIO::BlobType::RVZ;
+  int m_block_size = 0;  // 0 means that a block size is picked for each image
+  DiscIO::WIARVZCompressionType m_compression = DiscIO::WIARVZCompressionType::Zstd;
+  int m_compression_level = 5;
+  bool m_scrub = false;
+  bool m_hash = false;
+  std::string m_store_path;
+  std::set<std::string> m_duplicate_outputs;
+};
+}  // namespace DolphinTool
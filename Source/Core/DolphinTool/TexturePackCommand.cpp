@@ -0,0 +1,70 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/TexturePackCommand.h"
+
+#include <OptionParser.h>
+#include <cstdio>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/HiresTexturePack.h"
+#include "VideoCommon/HiresTextures.h"
+
+namespace DolphinTool
+{
+int TexturePackCommand::Main(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: texturepack [options]...");
+  parser.description("Packs a custom texture directory into a single texture pack file, which "
+                     "Dolphin uses instead of the loose texture files in that directory.");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to the custom texture directory, e.g. Load/Textures/<game ID>")
+      .metavar("DIRECTORY");
+
+  parser.add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Path to the texture pack file. Defaults to " +
+            std::string(HiresTexturePack::FILENAME) + " inside the input directory")
+      .metavar("FILE");
+
+  optparse::Values& options = parser.parse_args(args);
+
+  if (!options.is_set("input"))
+  {
+    std::fprintf(stderr, "Error: No input directory set\n");
+    return 1;
+  }
+  const std::string input_directory = static_cast<const char*>(options.get("input"));
+  if (!File::IsDirectory(input_directory))
+  {
+    std::fprintf(stderr, "Error: %s is not a directory\n", input_directory.c_str());
+    return 1;
+  }
+
+  const std::string output_path =
+      options.is_set("output") ? static_cast<const char*>(options.get("output")) :
+                                 input_directory + DIR_SEP + HiresTexturePack::FILENAME;
+
+  // Keep block-compressed DDS data as-is. Whether the backend in use can sample it is only
+  // checked when the texture is loaded from the pack.
+  HiresTexture::CompressedFormats formats;
+  formats.s3tc = true;
+  formats.bptc = true;
+
+  if (!HiresTexture::CreateTexturePack(input_directory, output_path, formats))
+  {
+    std::fprintf(stderr, "Error: Failed to create texture pack %s\n", output_path.c_str());
+    return 1;
+  }
+
+  std::printf("Wrote %s (%.1f MB)\n", output_path.c_str(),
+              File::GetSize(output_path) / (1024.0 * 1024.0));
+  return 0;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,54 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/MsgHandler.h"
+#include "DolphinTool/Command.h"
+#include "DolphinTool/ConvertCommand.h"
+#include "DolphinTool/TexturePackCommand.h"
+#include "DolphinTool/VerifyCommand.h"
+
+static void PrintUsage()
+{
+  std::fprintf(stderr, "usage: dolphin-tool COMMAND -h\n"
+                       "\n"
+                       "commands supported: [convert, verify, texturepack]\n");
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  const std::string command_name = argv[1];
+  const std::vector<std::string> args(argv + 2, argv + argc);
+
+  // Print errors instead of showing message boxes, since the tool may run unattended
+  Common::RegisterMsgAlertHandler([](const char*, const char* text, bool, Common::MsgType) {
+    std::fprintf(stderr, "%s\n", text);
+    return false;
+  });
+
+  std::unique_ptr<DolphinTool::Command> command;
+  if (command_name == "convert")
+    command = std::make_unique<DolphinTool::ConvertCommand>();
+  else if (command_name == "verify")
+    command = std::make_unique<DolphinTool::VerifyCommand>();
+  else if (command_name == "texturepack")
+    command = std::make_unique<DolphinTool::TexturePackCommand>();
+
+  if (!command)
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  return command->Main(args);
+}
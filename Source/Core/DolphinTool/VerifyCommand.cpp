@@ -0,0 +1,140 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/VerifyCommand.h"
+
+#include <OptionParser.h>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#include "Common/Timer.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeVerifier.h"
+#include "DolphinTool/BatchRunner.h"
+
+namespace DolphinTool
+{
+static const char* GetSeverityName(DiscIO::VolumeVerifier::Severity severity)
+{
+  switch (severity)
+  {
+  case DiscIO::VolumeVerifier::Severity::Low:
+    return "low";
+  case DiscIO::VolumeVerifier::Severity::Medium:
+    return "medium";
+  case DiscIO::VolumeVerifier::Severity::High:
+    return "high";
+  default:
+    return "none";
+  }
+}
+
+static const char* GetRedumpStatusName(DiscIO::RedumpVerifier::Status status)
+{
+  switch (status)
+  {
+  case DiscIO::RedumpVerifier::Status::GoodDump:
+    return "good";
+  case DiscIO::RedumpVerifier::Status::BadDump:
+    return "bad";
+  case DiscIO::RedumpVerifier::Status::Error:
+    return "error";
+  default:
+    return "unknown";
+  }
+}
+
+int VerifyCommand::Main(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: verify [options]... IMAGE...");
+  parser.description("Checks disc images for problems and calculates their CRC32, MD5 and SHA-1. "
+                     "Exits with an error if any image has a high severity problem.");
+
+  parser.add_option("--redump")
+      .action("store_true")
+      .help("Compare the hashes against the redump.org database (downloads the database)");
+
+  BatchRunner::AddOptions(&parser);
+
+  optparse::Values& options = parser.parse_args(args);
+  const std::vector<std::string> inputs = parser.args();
+
+  BatchRunner runner;
+  if (!runner.ParseOptions(options))
+    return 1;
+
+  if (inputs.empty())
+  {
+    std::fprintf(stderr, "Error: No input images set\n");
+    return 1;
+  }
+
+  m_redump = static_cast<bool>(options.get("redump"));
+
+  // VolumeVerifier decides by itself how to spread its work over threads, so the thread budget
+  // only limits how many images are verified at the same time.
+  return runner.Run(inputs,
+                    [this](const std::string& input, int) { return VerifyImage(input); });
+}
+
+picojson::object VerifyCommand::VerifyImage(const std::string& input) const
+{
+  picojson::object result;
+
+  const std::unique_ptr<DiscIO::Volume> volume = DiscIO::CreateVolume(input);
+  if (!volume)
+  {
+    result["success"] = picojson::value(false);
+    result["error"] = picojson::value("Failed to open the image");
+    return result;
+  }
+
+  const u64 start_time_us = Common::Timer::GetTimeUs();
+
+  DiscIO::VolumeVerifier verifier(*volume, m_redump, {true, true, true});
+  verifier.Start();
+  while (verifier.GetBytesProcessed() != verifier.GetTotalBytes())
+    verifier.Process();
+  verifier.Finish();
+
+  const double seconds = (Common::Timer::GetTimeUs() - start_time_us) / 1000000.0;
+  const DiscIO::VolumeVerifier::Result& verifier_result = verifier.GetResult();
+
+  picojson::array problems;
+  bool has_high_severity_problem = false;
+  for (const DiscIO::VolumeVerifier::Problem& problem : verifier_result.problems)
+  {
+    picojson::object problem_object;
+    problem_object["severity"] = picojson::value(GetSeverityName(problem.severity));
+    problem_object["text"] = picojson::value(problem.text);
+    problems.emplace_back(std::move(problem_object));
+
+    if (problem.severity == DiscIO::VolumeVerifier::Severity::High)
+      has_high_severity_problem = true;
+  }
+
+  const auto& hashes = verifier_result.hashes;
+  result["success"] = picojson::value(!has_high_severity_problem);
+  if (has_high_severity_problem)
+    result["error"] = picojson::value(verifier_result.summary_text);
+  result["summary"] = picojson::value(verifier_result.summary_text);
+  result["problems"] = picojson::value(std::move(problems));
+  result["crc32"] =
+      picojson::value(BatchRunner::FormatHash(hashes.crc32.data(), hashes.crc32.size()));
+  result["md5"] = picojson::value(BatchRunner::FormatHash(hashes.md5.data(), hashes.md5.size()));
+  result["sha1"] =
+      picojson::value(BatchRunner::FormatHash(hashes.sha1.data(), hashes.sha1.size()));
+  if (m_redump)
+  {
+    result["redump_status"] = picojson::value(GetRedumpStatusName(verifier_result.redump.status));
+    result["redump_message"] = picojson::value(verifier_result.redump.message);
+  }
+  result["data_size"] = picojson::value(static_cast<double>(verifier.GetTotalBytes()));
+  result["mib_per_second"] = picojson::value(verifier.GetTotalBytes() / (1024.0 * 1024.0) /
+                                             std::max(seconds, 0.001));
+
+  return result;
+}
+}  // namespace DolphinTool
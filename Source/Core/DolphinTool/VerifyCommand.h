@@ -0,0 +1,25 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <picojson.h>
+
+#include "DolphinTool/Command.h"
+
+namespace DolphinTool
+{
+class VerifyCommand final : public Command
+{
+public:
+  int Main(const std::vector<std::string>& args) override;
+
+private:
+  picojson::object VerifyImage(const std::string& input) const;
+
+  bool m_redump = false;
+};
+}  // namespace DolphinTool
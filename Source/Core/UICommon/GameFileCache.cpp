@@ -6,11 +6,13 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -20,6 +22,7 @@
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/Thread.h"
 
 #include "DiscIO/DirectoryBlob.h"
 
@@ -27,13 +30,51 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 20;  // Last changed in PR 9461
+static constexpr u32 CACHE_REVISION = 21;
+
+// The cache file starts with this header, followed by the end offset of each game's record and
+// then the records themselves. Knowing where every record is lets them be read on several threads.
+#pragma pack(push, 1)
+struct CacheFileHeader
+{
+  u32 revision;
+  u32 count;
+  u64 size;
+};
+#pragma pack(pop)
+
+// Calls function(i) for every i in [0, count), spread over all CPU threads
+static void ParallelForEach(size_t count, const std::function<void(size_t)>& function)
+{
+  const size_t thread_count =
+      std::min<size_t>(count, std::max(std::thread::hardware_concurrency(), 1u));
+
+  std::atomic<size_t> next_index = 0;
+  const auto worker = [&] {
+    for (size_t i = next_index++; i < count; i = next_index++)
+      function(i);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i)
+  {
+    threads.emplace_back([&worker] {
+      Common::SetCurrentThreadName("GameFileCache worker");
+      worker();
+    });
+  }
+  worker();
+
+  for (std::thread& thread : threads)
+    thread.join();
+}
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
 {
   static const std::vector<std::string> search_extensions = {
-      ".gcm", ".tgc", ".iso", ".ciso", ".gcz", ".wbfs", ".wia", ".rvz", ".wad", ".dol", ".elf"};
+      ".gcm", ".tgc", ".iso", ".ciso", ".gcz", ".wbfs", ".wia", ".rvz", ".dcs", ".wad", ".dol",
+      ".elf"};
 
   // TODO: We could process paths iteratively as they are found
   return Common::DoFileSearch(directories_to_scan, search_extensions, recursive_scan);
@@ -60,24 +101,24 @@ void GameFileCache::Clear(DeleteOnDisk delete_on_disk)
     File::Delete(m_path);
 
   m_cached_files.clear();
+  m_index.clear();
 }
 
 std::shared_ptr<const GameFile> GameFileCache::AddOrGet(const std::string& path,
                                                         bool* cache_changed)
 {
-  auto it = std::find_if(
-      m_cached_files.begin(), m_cached_files.end(),
-      [&path](const std::shared_ptr<GameFile>& file) { return file->GetFilePath() == path; });
-  const bool found = it != m_cached_files.cend();
+  const auto it = m_index.find(path);
+  const bool found = it != m_index.cend();
   if (!found)
   {
     std::shared_ptr<UICommon::GameFile> game = std::make_shared<GameFile>(path);
     if (!game->IsValid())
       return nullptr;
+    m_index.emplace(path, m_cached_files.size());
     m_cached_files.emplace_back(std::move(game));
   }
-  std::shared_ptr<GameFile>& result = found ? *it : m_cached_files.back();
-  if (UpdateAdditionalMetadata(&result) || !found)
+  std::shared_ptr<GameFile>& result = found ? m_cached_files[it->second] : m_cached_files.back();
+  if (UpdateAdditionalMetadata(&result, true) || !found)
     *cache_changed = true;
 
   return result;
@@ -132,22 +173,42 @@ bool GameFileCache::Update(
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
-  {
+  // Reading the files is what takes time when many games are added, so it's done in parallel.
+  // Constructing GameFiles concurrently is safe: each one opens its own volume and blob reader,
+  // the state that readers share between files (the DCS stores and their chunk cache) is guarded
+  // by mutexes, FST caches are written to a temporary file and then renamed, and the settings are
+  // only read (Config has its own lock, and the user paths are set before the game list exists).
+  const std::vector<std::string> new_paths(game_paths.cbegin(), game_paths.cend());
+  std::vector<std::shared_ptr<GameFile>> new_files(new_paths.size());
+  std::mutex callback_mutex;
+  ParallelForEach(new_paths.size(), [&](size_t i) {
     if (processing_halted)
-      break;
+      return;
 
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
+    auto file = std::make_shared<GameFile>(new_paths[i]);
+    if (!file->IsValid())
+      return;
+
+    if (game_added_to_cache)
     {
-      if (game_added_to_cache)
-        game_added_to_cache(file);
+      std::lock_guard lk(callback_mutex);
+      game_added_to_cache(file);
+    }
 
+    new_files[i] = std::move(file);
+  });
+
+  for (std::shared_ptr<GameFile>& file : new_files)
+  {
+    if (file)
+    {
       cache_changed = true;
       m_cached_files.push_back(std::move(file));
     }
   }
 
+  RebuildIndex();
+
   return cache_changed;
 }
 
@@ -155,29 +216,52 @@ bool GameFileCache::UpdateAdditionalMetadata(
     std::function<void(const std::shared_ptr<const GameFile>&)> game_updated,
     const std::atomic_bool& processing_halted)
 {
-  bool cache_changed = false;
+  std::atomic_bool cache_changed = false;
+  std::mutex callback_mutex;
+
+  // Only the local files are checked in parallel. Missing covers are downloaded afterwards on this
+  // thread, so that GameTDB doesn't get a request from every CPU thread at once.
+  ParallelForEach(m_cached_files.size(), [&](size_t i) {
+    if (processing_halted)
+      return;
+
+    std::shared_ptr<GameFile>& file = m_cached_files[i];
+    if (!UpdateAdditionalMetadata(&file, false))
+      return;
+
+    cache_changed = true;
+    if (game_updated)
+    {
+      std::lock_guard lk(callback_mutex);
+      game_updated(file);
+    }
+  });
 
   for (std::shared_ptr<GameFile>& file : m_cached_files)
   {
     if (processing_halted)
       break;
 
-    const bool updated = UpdateAdditionalMetadata(&file);
-    cache_changed |= updated;
-    if (game_updated && updated)
+    if (!UpdateDefaultCover(&file))
+      continue;
+
+    cache_changed = true;
+    if (game_updated)
       game_updated(file);
   }
 
   return cache_changed;
 }
 
-bool GameFileCache::UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file)
+bool GameFileCache::UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file,
+                                             bool download_cover)
 {
   const bool xml_metadata_changed = (*game_file)->XMLMetadataChanged();
   const bool wii_banner_changed = (*game_file)->WiiBannerChanged();
   const bool custom_banner_changed = (*game_file)->CustomBannerChanged();
 
-  (*game_file)->DownloadDefaultCover();
+  if (download_cover)
+    (*game_file)->DownloadDefaultCover();
 
   const bool default_cover_changed = (*game_file)->DefaultCoverChanged();
   const bool custom_cover_changed = (*game_file)->CustomCoverChanged();
@@ -208,6 +292,19 @@ bool GameFileCache::UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_fil
   return true;
 }
 
+bool GameFileCache::UpdateDefaultCover(std::shared_ptr<GameFile>* game_file)
+{
+  (*game_file)->DownloadDefaultCover();
+  if (!(*game_file)->DefaultCoverChanged())
+    return false;
+
+  std::shared_ptr<GameFile> copy = std::make_shared<GameFile>(**game_file);
+  copy->DefaultCoverCommit();
+  std::atomic_store(game_file, std::move(copy));
+
+  return true;
+}
+
 bool GameFileCache::Load()
 {
   return SyncCacheFile(false);
@@ -220,69 +317,118 @@ bool GameFileCache::Save()
 
 bool GameFileCache::SyncCacheFile(bool save)
 {
-  const char* open_mode = save ? "wb" : "rb";
-  File::IOFile f(m_path, open_mode);
-  if (!f)
+  if (!save && !File::Exists(m_path))
     return false;
-  bool success = false;
-  if (save)
-  {
-    // Measure the size of the buffer.
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-    DoState(&p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
 
-    // Then actually do the write.
-    std::vector<u8> buffer(buffer_size);
-    ptr = &buffer[0];
-    p.SetMode(PointerWrap::MODE_WRITE);
-    DoState(&p, buffer_size);
-    if (f.WriteBytes(buffer.data(), buffer.size()))
-      success = true;
-  }
-  else
-  {
-    std::vector<u8> buffer(f.GetSize());
-    if (!buffer.empty() && f.ReadBytes(buffer.data(), buffer.size()))
-    {
-      u8* ptr = buffer.data();
-      PointerWrap p(&ptr, PointerWrap::MODE_READ);
-      DoState(&p, buffer.size());
-      if (p.GetMode() == PointerWrap::MODE_READ)
-        success = true;
-    }
-  }
+  const bool success = save ? WriteCacheFile() : ReadCacheFile();
   if (!success)
   {
     // If some file operation failed, try to delete the probably-corrupted cache
-    f.Close();
     File::Delete(m_path);
   }
   return success;
 }
 
-void GameFileCache::DoState(PointerWrap* p, u64 size)
+bool GameFileCache::ReadCacheFile()
 {
-  struct
-  {
-    u32 revision;
-    u64 expected_size;
-  } header = {CACHE_REVISION, size};
-  p->Do(header);
-  if (p->GetMode() == PointerWrap::MODE_READ)
-  {
-    if (header.revision != CACHE_REVISION || header.expected_size != size)
+  // The file is read into a buffer rather than mapped, since a mapping would fault if another
+  // instance of Dolphin truncated the file while it's being read
+  File::IOFile cache_file(m_path, "rb");
+  std::vector<u8> buffer(cache_file.GetSize());
+  if (buffer.empty() || !cache_file.ReadBytes(buffer.data(), buffer.size()))
+    return false;
+  u8* data = buffer.data();
+  const size_t size = buffer.size();
+
+  CacheFileHeader header;
+  if (size < sizeof(header))
+    return false;
+  std::memcpy(&header, data, sizeof(header));
+
+  const u64 records_offset = sizeof(header) + u64{header.count} * sizeof(u64);
+  if (header.revision != CACHE_REVISION || header.size != size || records_offset > size)
+    return false;
+
+  std::vector<u64> end_offsets(header.count);
+  std::memcpy(end_offsets.data(), data + sizeof(header), end_offsets.size() * sizeof(u64));
+
+  std::vector<std::shared_ptr<GameFile>> files(header.count);
+  std::atomic_bool success = true;
+  ParallelForEach(files.size(), [&](size_t i) {
+    const u64 start = i == 0 ? records_offset : end_offsets[i - 1];
+    const u64 end = end_offsets[i];
+    if (start > end || end > size)
     {
-      p->SetMode(PointerWrap::MODE_MEASURE);
+      success = false;
       return;
     }
-  }
-  p->DoEachElement(m_cached_files, [](PointerWrap& state, std::shared_ptr<GameFile>& elem) {
-    if (state.GetMode() == PointerWrap::MODE_READ)
-      elem = std::make_shared<GameFile>();
-    elem->DoState(state);
+
+    u8* ptr = data + start;
+    PointerWrap p(&ptr, PointerWrap::MODE_READ);
+    auto file = std::make_shared<GameFile>();
+    file->DoState(p);
+    if (ptr != data + end)
+    {
+      success = false;
+      return;
+    }
+
+    files[i] = std::move(file);
   });
+
+  if (!success)
+    return false;
+
+  m_cached_files = std::move(files);
+  RebuildIndex();
+  return true;
+}
+
+bool GameFileCache::WriteCacheFile()
+{
+  const size_t count = m_cached_files.size();
+
+  std::vector<std::vector<u8>> records(count);
+  ParallelForEach(count, [&](size_t i) {
+    u8* ptr = nullptr;
+    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+    m_cached_files[i]->DoState(p);
+
+    records[i].resize(reinterpret_cast<size_t>(ptr));
+    ptr = records[i].data();
+    p.SetMode(PointerWrap::MODE_WRITE);
+    m_cached_files[i]->DoState(p);
+  });
+
+  std::vector<u64> end_offsets(count);
+  u64 offset = sizeof(CacheFileHeader) + count * sizeof(u64);
+  for (size_t i = 0; i < count; ++i)
+  {
+    offset += records[i].size();
+    end_offsets[i] = offset;
+  }
+
+  const CacheFileHeader header{CACHE_REVISION, static_cast<u32>(count), offset};
+
+  File::IOFile file(m_path, "wb");
+  if (!file.WriteBytes(&header, sizeof(header)) || !file.WriteArray(end_offsets.data(), count))
+    return false;
+
+  for (const std::vector<u8>& record : records)
+  {
+    if (!file.WriteBytes(record.data(), record.size()))
+      return false;
+  }
+
+  return true;
+}
+
+void GameFileCache::RebuildIndex()
+{
+  m_index.clear();
+  m_index.reserve(m_cached_files.size());
+  for (size_t i = 0; i < m_cached_files.size(); ++i)
+    m_index.emplace(m_cached_files[i]->GetFilePath(), i);
 }
 
 }  // namespace UICommon
@@ -8,12 +8,11 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 
-class PointerWrap;
-
 namespace UICommon
 {
 class GameFile;
@@ -40,7 +39,8 @@ public:
   // Returns nullptr if the file is invalid.
   std::shared_ptr<const GameFile> AddOrGet(const std::string& path, bool* cache_changed);
 
-  // These functions return true if the call modified the cache.
+  // These functions return true if the call modified the cache. The callbacks may be called from
+  // several threads, but never concurrently.
   bool Update(const std::vector<std::string>& all_game_paths,
               std::function<void(const std::shared_ptr<const GameFile>&)> game_added_to_cache = {},
               std::function<void(const std::string&)> game_removed_from_cache = {},
@@ -53,13 +53,19 @@ public:
   bool Save();
 
 private:
-  bool UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file);
+  bool UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file, bool download_cover);
+  bool UpdateDefaultCover(std::shared_ptr<GameFile>* game_file);
 
   bool SyncCacheFile(bool save);
-  void DoState(PointerWrap* p, u64 size = 0);
+  bool ReadCacheFile();
+  bool WriteCacheFile();
+  void RebuildIndex();
 
   std::string m_path;
   std::vector<std::shared_ptr<GameFile>> m_cached_files;
+
+  // Path -> index in m_cached_files
+  std::unordered_map<std::string, size_t> m_index;
 };
 
 }  // namespace UICommon
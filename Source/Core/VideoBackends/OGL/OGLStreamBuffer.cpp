@@ -316,6 +316,7 @@ public:
   }
 
   ~BufferSubData() { delete[] m_pointer; }
+  bool SubAllocates() const override { return false; }
   std::pair<u8*, u32> Map(u32 size) override { return std::make_pair(m_pointer, 0); }
   void Unmap(u32 used_size) override { glBufferSubData(m_buffertype, 0, used_size, m_pointer); }
   u8* m_pointer;
@@ -336,6 +337,7 @@ public:
   }
 
   ~BufferData() { delete[] m_pointer; }
+  bool SubAllocates() const override { return false; }
   std::pair<u8*, u32> Map(u32 size) override { return std::make_pair(m_pointer, 0); }
   void Unmap(u32 used_size) override
   {
@@ -22,6 +22,10 @@ public:
   u32 GetSize() const { return m_size; }
   u32 GetCurrentOffset() const { return m_iterator; }
 
+  // Whether each mapping gets its own range of the buffer. Implementations which always upload to
+  // offset zero return false, as older allocations are overwritten by the next one.
+  virtual bool SubAllocates() const { return true; }
+
   /* This mapping function will return a pair of:
    * - the pointer to the mapped buffer
    * - the offset into the real GPU buffer (always multiple of stride)
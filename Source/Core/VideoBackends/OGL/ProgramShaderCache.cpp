@@ -36,7 +36,6 @@
 
 namespace OGL
 {
-u32 ProgramShaderCache::s_ubo_buffer_size;
 s32 ProgramShaderCache::s_ubo_align = 1;
 GLuint ProgramShaderCache::s_attributeless_VBO = 0;
 GLuint ProgramShaderCache::s_attributeless_VAO = 0;
@@ -217,36 +216,67 @@ u32 ProgramShaderCache::GetUniformBufferAlignment()
 
 void ProgramShaderCache::UploadConstants()
 {
-  if (PixelShaderManager::dirty || VertexShaderManager::dirty || GeometryShaderManager::dirty)
-  {
-    auto buffer = s_buffer->Map(s_ubo_buffer_size, s_ubo_align);
-
-    memcpy(buffer.first, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
+  if (!PixelShaderManager::dirty && !VertexShaderManager::dirty && !GeometryShaderManager::dirty)
+    return;
 
-    memcpy(buffer.first + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align),
-           &VertexShaderManager::constants, sizeof(VertexShaderConstants));
+  const u32 ps_size = Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align);
+  const u32 vs_size = Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align);
+  const u32 gs_size = Common::AlignUp(sizeof(GeometryShaderConstants), s_ubo_align);
+  const auto get_upload_size = [&] {
+    return (PixelShaderManager::dirty ? ps_size : 0) + (VertexShaderManager::dirty ? vs_size : 0) +
+           (GeometryShaderManager::dirty ? gs_size : 0);
+  };
 
-    memcpy(buffer.first + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
-               Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
-           &GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
+  // Blocks which have not changed keep their previous binding. That data is only guaranteed to be
+  // intact until the stream buffer wraps around, so re-upload every block when it is about to, or
+  // always if the stream buffer places every upload at the start of the buffer.
+  if (!s_buffer->SubAllocates() ||
+      Common::AlignUp(s_buffer->GetCurrentOffset(), static_cast<u32>(s_ubo_align)) +
+              get_upload_size() >=
+          s_buffer->GetSize())
+  {
+    PixelShaderManager::dirty = true;
+    VertexShaderManager::dirty = true;
+    GeometryShaderManager::dirty = true;
+  }
 
-    s_buffer->Unmap(s_ubo_buffer_size);
-    glBindBufferRange(GL_UNIFORM_BUFFER, 1, s_buffer->m_buffer, buffer.second,
-                      sizeof(PixelShaderConstants));
-    glBindBufferRange(GL_UNIFORM_BUFFER, 2, s_buffer->m_buffer,
-                      buffer.second + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align),
-                      sizeof(VertexShaderConstants));
-    glBindBufferRange(GL_UNIFORM_BUFFER, 3, s_buffer->m_buffer,
-                      buffer.second + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
-                          Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
-                      sizeof(GeometryShaderConstants));
+  const u32 upload_size = get_upload_size();
+  auto buffer = s_buffer->Map(upload_size, s_ubo_align);
+
+  u32 offset = 0;
+  std::array<u32, 3> block_offsets{};
+  std::array<bool, 3> block_dirty{};
+  const auto copy_block = [&](size_t block, const void* data, u32 data_size, u32 aligned_size) {
+    std::memcpy(buffer.first + offset, data, data_size);
+    block_offsets[block] = buffer.second + offset;
+    block_dirty[block] = true;
+    offset += aligned_size;
+  };
+  if (PixelShaderManager::dirty)
+    copy_block(0, &PixelShaderManager::constants, sizeof(PixelShaderConstants), ps_size);
+  if (VertexShaderManager::dirty)
+    copy_block(1, &VertexShaderManager::constants, sizeof(VertexShaderConstants), vs_size);
+  if (GeometryShaderManager::dirty)
+    copy_block(2, &GeometryShaderManager::constants, sizeof(GeometryShaderConstants), gs_size);
+
+  s_buffer->Unmap(upload_size);
+
+  static constexpr std::array<u32, 3> block_sizes = {
+      sizeof(PixelShaderConstants), sizeof(VertexShaderConstants), sizeof(GeometryShaderConstants)};
+  for (size_t block = 0; block < block_dirty.size(); block++)
+  {
+    if (block_dirty[block])
+    {
+      glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(block + 1), s_buffer->m_buffer,
+                        block_offsets[block], block_sizes[block]);
+    }
+  }
 
-    PixelShaderManager::dirty = false;
-    VertexShaderManager::dirty = false;
-    GeometryShaderManager::dirty = false;
+  PixelShaderManager::dirty = false;
+  VertexShaderManager::dirty = false;
+  GeometryShaderManager::dirty = false;
 
-    ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, s_ubo_buffer_size);
-  }
+  ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, upload_size);
 }
 
 void ProgramShaderCache::UploadConstants(const void* data, u32 data_size)
@@ -433,11 +463,6 @@ void ProgramShaderCache::Init()
   // then the UBO will fail.
   glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &s_ubo_align);
 
-  s_ubo_buffer_size =
-      static_cast<u32>(Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
-                       Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align) +
-                       Common::AlignUp(sizeof(GeometryShaderConstants), s_ubo_align));
-
   // We multiply by *4*4 because we need to get down to basic machine units.
   // So multiply by four to get how many floats we have from vec4s
   // Then once more to get bytes
@@ -113,7 +113,6 @@ private:
   static PipelineProgramMap s_pipeline_programs;
   static std::mutex s_pipeline_program_lock;
 
-  static u32 s_ubo_buffer_size;
   static s32 s_ubo_align;
 
   static GLuint s_attributeless_VBO;
@@ -3,6 +3,7 @@
 
 #include "VideoBackends/Software/SWVertexLoader.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
 
@@ -68,28 +69,46 @@ void SWVertexLoader::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 base_
     Rasterizer::SetTevReg(i, Tev::ALP_C, PixelShaderManager::constants.kcolors[i][3]);
   }
 
-  for (u32 i = 0; i < m_index_generator.GetIndexLen(); i++)
+  // Parse and transform each vertex once, even if it is referenced by several indices.
+  const u32 num_indices_in_batch = m_index_generator.GetIndexLen();
+  u32 num_vertices = 0;
+  for (u32 i = 0; i < num_indices_in_batch; i++)
+    num_vertices = std::max<u32>(num_vertices, m_cpu_index_buffer[i] + 1);
+
+  m_input_vertices.resize(num_vertices);
+  m_transformed_vertices.resize(num_vertices);
+  for (u32 index = 0; index < num_vertices; index++)
   {
-    const u16 index = m_cpu_index_buffer[i];
     memset(static_cast<void*>(&m_vertex), 0, sizeof(m_vertex));
 
     // parse the videocommon format to our own struct format (m_vertex)
     SetFormat(g_main_cp_state.last_id, primitiveType);
     ParseVertex(VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration(), index);
+    m_input_vertices[index] = m_vertex;
+  }
 
-    // transform this vertex so that it can be used for rasterization (outVertex)
-    OutputVertexData* outVertex = m_setup_unit.GetVertex();
-    TransformUnit::TransformPosition(&m_vertex, outVertex);
-    outVertex->normal = {};
-    if (VertexLoaderManager::g_current_components & VB_HAS_NRM0)
-    {
-      TransformUnit::TransformNormal(
-          &m_vertex, (VertexLoaderManager::g_current_components & VB_HAS_NRM2) != 0, outVertex);
-    }
-    TransformUnit::TransformColor(&m_vertex, outVertex);
-    TransformUnit::TransformTexCoord(&m_vertex, outVertex);
+  // transform the vertices so that they can be used for rasterization
+  const InputVertexData* const input = m_input_vertices.data();
+  OutputVertexData* const output = m_transformed_vertices.data();
+  for (u32 index = 0; index < num_vertices; index++)
+    output[index] = {};
+  TransformUnit::TransformPositions(input, output, num_vertices);
+  if (VertexLoaderManager::g_current_components & VB_HAS_NRM0)
+  {
+    TransformUnit::TransformNormals(
+        input, (VertexLoaderManager::g_current_components & VB_HAS_NRM2) != 0, output,
+        num_vertices);
+  }
+  TransformUnit::TransformColors(input, output, num_vertices);
+  for (u32 index = 0; index < num_vertices; index++)
+    TransformUnit::TransformTexCoord(&input[index], &output[index]);
+
+  for (u32 i = 0; i < num_indices_in_batch; i++)
+  {
+    const u16 index = m_cpu_index_buffer[i];
 
     // assemble and rasterize the primitive
+    *m_setup_unit.GetVertex() = output[index];
     m_setup_unit.SetupVertex();
 
     INCSTAT(g_stats.this_frame.num_vertices_loaded)
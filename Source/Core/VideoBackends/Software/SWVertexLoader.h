@@ -26,5 +26,7 @@ protected:
   void ParseVertex(const PortableVertexDeclaration& vdec, int index);
 
   InputVertexData m_vertex{};
+  std::vector<InputVertexData> m_input_vertices;
+  std::vector<OutputVertexData> m_transformed_vertices;
   SetupUnit m_setup_unit;
 };
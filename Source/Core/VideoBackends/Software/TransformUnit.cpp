@@ -8,6 +8,10 @@
 #include <cmath>
 #include <cstring>
 
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#endif
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -108,6 +112,165 @@ void TransformNormal(const InputVertexData* src, bool nbt, OutputVertexData* dst
   }
 }
 
+#if defined(_M_X86) || defined(_M_X86_64)
+// The SSE versions below process four vertices in SoA form. Each lane performs exactly the same
+// single precision operations in the same order as the scalar functions above (no reciprocal
+// approximations or fused multiply-adds), so the results are bit-identical.
+struct Vec3x4
+{
+  __m128 x;
+  __m128 y;
+  __m128 z;
+};
+
+template <typename GetVec>
+static Vec3x4 LoadVec3x4(GetVec get)
+{
+  return {_mm_setr_ps(get(0).x, get(1).x, get(2).x, get(3).x),
+          _mm_setr_ps(get(0).y, get(1).y, get(2).y, get(3).y),
+          _mm_setr_ps(get(0).z, get(1).z, get(2).z, get(3).z)};
+}
+
+template <typename GetVec>
+static void StoreVec3x4(const Vec3x4& v, GetVec get)
+{
+  alignas(16) std::array<float, 4> x, y, z;
+  _mm_store_ps(x.data(), v.x);
+  _mm_store_ps(y.data(), v.y);
+  _mm_store_ps(z.data(), v.z);
+  for (int i = 0; i < 4; i++)
+  {
+    Vec3& dst = get(i);
+    dst.x = x[i];
+    dst.y = y[i];
+    dst.z = z[i];
+  }
+}
+
+// mat[0] * v.x + mat[1] * v.y + mat[2] * v.z
+static __m128 MultiplyRow3(const float* mat, const Vec3x4& v)
+{
+  const __m128 xy = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mat[0]), v.x),
+                               _mm_mul_ps(_mm_set1_ps(mat[1]), v.y));
+  return _mm_add_ps(xy, _mm_mul_ps(_mm_set1_ps(mat[2]), v.z));
+}
+
+static void TransformPosition4(const InputVertexData* src, OutputVertexData* dst)
+{
+  const float* mat = &xfmem.posMatrices[src->posMtx * 4];
+  const Vec3x4 pos = LoadVec3x4([src](int i) -> const Vec3& { return src[i].position; });
+
+  Vec3x4 mv;
+  mv.x = _mm_add_ps(MultiplyRow3(&mat[0], pos), _mm_set1_ps(mat[3]));
+  mv.y = _mm_add_ps(MultiplyRow3(&mat[4], pos), _mm_set1_ps(mat[7]));
+  mv.z = _mm_add_ps(MultiplyRow3(&mat[8], pos), _mm_set1_ps(mat[11]));
+  StoreVec3x4(mv, [dst](int i) -> Vec3& { return dst[i].mvPosition; });
+
+  const Projection::Raw& proj = xfmem.projection.rawProjection;
+  __m128 px, py, pz, pw;
+  if (xfmem.projection.type == ProjectionType::Perspective)
+  {
+    px = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mv.x), _mm_mul_ps(_mm_set1_ps(proj[1]), mv.z));
+    py = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mv.y), _mm_mul_ps(_mm_set1_ps(proj[3]), mv.z));
+    pz = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mv.z), _mm_set1_ps(proj[5])),
+                    _mm_set1_ps(1.0f - (float)1e-7));
+    pw = _mm_xor_ps(mv.z, _mm_set1_ps(-0.0f));
+  }
+  else
+  {
+    px = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mv.x), _mm_set1_ps(proj[1]));
+    py = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mv.y), _mm_set1_ps(proj[3]));
+    pz = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mv.z), _mm_set1_ps(proj[5]));
+    pw = _mm_set1_ps(1.0f);
+  }
+
+  // Transpose the SoA result back into one Vec4 per vertex.
+  _MM_TRANSPOSE4_PS(px, py, pz, pw);
+  _mm_storeu_ps(&dst[0].projectedPosition.x, px);
+  _mm_storeu_ps(&dst[1].projectedPosition.x, py);
+  _mm_storeu_ps(&dst[2].projectedPosition.x, pz);
+  _mm_storeu_ps(&dst[3].projectedPosition.x, pw);
+}
+
+static void TransformNormal4(const InputVertexData* src, bool nbt, OutputVertexData* dst)
+{
+  const float* mat = &xfmem.normalMatrices[(src->posMtx & 31) * 3];
+
+  const size_t num_normals = nbt ? 3 : 1;
+  for (size_t n = 0; n < num_normals; n++)
+  {
+    const Vec3x4 normal = LoadVec3x4([src, n](int i) -> const Vec3& { return src[i].normal[n]; });
+    Vec3x4 result{MultiplyRow3(&mat[0], normal), MultiplyRow3(&mat[3], normal),
+                  MultiplyRow3(&mat[6], normal)};
+
+    if (n == 0)
+    {
+      // Vec3::Normalize: multiply by 1 / sqrt((x * x + y * y) + z * z)
+      const __m128 length2 =
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(result.x, result.x), _mm_mul_ps(result.y, result.y)),
+                     _mm_mul_ps(result.z, result.z));
+      const __m128 inv_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length2));
+      result.x = _mm_mul_ps(result.x, inv_length);
+      result.y = _mm_mul_ps(result.y, inv_length);
+      result.z = _mm_mul_ps(result.z, inv_length);
+    }
+
+    StoreVec3x4(result, [dst, n](int i) -> Vec3& { return dst[i].normal[n]; });
+  }
+}
+
+// The matrices are selected per vertex, so a group of four can only be transformed together if
+// all of them use the same one. This is the common case, as most games don't use matrix indices.
+static bool HaveSamePosMatrix(const InputVertexData* src)
+{
+  return src[0].posMtx == src[1].posMtx && src[0].posMtx == src[2].posMtx &&
+         src[0].posMtx == src[3].posMtx;
+}
+#endif
+
+void TransformPositions(const InputVertexData* src, OutputVertexData* dst, std::size_t count)
+{
+  std::size_t i = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  for (; i + 4 <= count; i += 4)
+  {
+    if (HaveSamePosMatrix(&src[i]))
+    {
+      TransformPosition4(&src[i], &dst[i]);
+    }
+    else
+    {
+      for (std::size_t j = i; j < i + 4; j++)
+        TransformPosition(&src[j], &dst[j]);
+    }
+  }
+#endif
+  for (; i < count; i++)
+    TransformPosition(&src[i], &dst[i]);
+}
+
+void TransformNormals(const InputVertexData* src, bool nbt, OutputVertexData* dst,
+                      std::size_t count)
+{
+  std::size_t i = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  for (; i + 4 <= count; i += 4)
+  {
+    if (HaveSamePosMatrix(&src[i]))
+    {
+      TransformNormal4(&src[i], nbt, &dst[i]);
+    }
+    else
+    {
+      for (std::size_t j = i; j < i + 4; j++)
+        TransformNormal(&src[j], nbt, &dst[j]);
+    }
+  }
+#endif
+  for (; i < count; i++)
+    TransformNormal(&src[i], nbt, &dst[i]);
+}
+
 static void TransformTexCoordRegular(const TexMtxInfo& texinfo, int coordNum,
                                      const InputVertexData* srcVertex, OutputVertexData* dstVertex)
 {
@@ -312,92 +475,338 @@ static void LightAlpha(const Vec3& pos, const Vec3& normal, u8 lightNum, const L
   }
 }
 
+static Vec3 GetAmbientColor(const InputVertexData* src, u32 chan)
+{
+  if (xfmem.color[chan].ambsource == AmbSource::Vertex)
+    return Vec3(src->color[chan][1], src->color[chan][2], src->color[chan][3]);
+
+  const u8* ambColor = reinterpret_cast<u8*>(&xfmem.ambColor[chan]);
+  return Vec3(ambColor[1], ambColor[2], ambColor[3]);
+}
+
+static float GetAmbientAlpha(const InputVertexData* src, u32 chan)
+{
+  if (xfmem.alpha[chan].ambsource == AmbSource::Vertex)
+    return src->color[chan][0];
+
+  return static_cast<float>(xfmem.ambColor[chan] & 0xff);
+}
+
+// Combines the material color with the accumulated light color and alpha of a channel. The light
+// values are ignored if lighting is disabled for the color or alpha part of the channel.
+static void WriteChannelColor(const InputVertexData* src, OutputVertexData* dst, u32 chan,
+                              const Vec3& lightCol, float lightAlpha)
+{
+  // abgr
+  std::array<u8, 4> matcolor;
+  std::array<u8, 4> chancolor;
+
+  // color
+  const LitChannel& colorchan = xfmem.color[chan];
+  if (colorchan.matsource == MatSource::Vertex)
+    matcolor = src->color[chan];
+  else
+    std::memcpy(matcolor.data(), &xfmem.matColor[chan], sizeof(u32));
+
+  if (colorchan.enablelighting)
+  {
+    int light_x = std::clamp(static_cast<int>(lightCol.x), 0, 255);
+    int light_y = std::clamp(static_cast<int>(lightCol.y), 0, 255);
+    int light_z = std::clamp(static_cast<int>(lightCol.z), 0, 255);
+    chancolor[1] = (matcolor[1] * (light_x + (light_x >> 7))) >> 8;
+    chancolor[2] = (matcolor[2] * (light_y + (light_y >> 7))) >> 8;
+    chancolor[3] = (matcolor[3] * (light_z + (light_z >> 7))) >> 8;
+  }
+  else
+  {
+    chancolor = matcolor;
+  }
+
+  // alpha
+  const LitChannel& alphachan = xfmem.alpha[chan];
+  if (alphachan.matsource == MatSource::Vertex)
+    matcolor[0] = src->color[chan][0];
+  else
+    matcolor[0] = xfmem.matColor[chan] & 0xff;
+
+  if (alphachan.enablelighting)
+  {
+    int light_a = std::clamp(static_cast<int>(lightAlpha), 0, 255);
+    chancolor[0] = (matcolor[0] * (light_a + (light_a >> 7))) >> 8;
+  }
+  else
+  {
+    chancolor[0] = matcolor[0];
+  }
+
+  // abgr -> rgba
+  const u32 rgba_color = Common::swap32(chancolor.data());
+  std::memcpy(dst->color[chan].data(), &rgba_color, sizeof(u32));
+}
+
 void TransformColor(const InputVertexData* src, OutputVertexData* dst)
 {
   for (u32 chan = 0; chan < NUM_XF_COLOR_CHANNELS; chan++)
   {
-    // abgr
-    std::array<u8, 4> matcolor;
-    std::array<u8, 4> chancolor;
-
-    // color
+    Vec3 lightCol(0.0f);
     const LitChannel& colorchan = xfmem.color[chan];
-    if (colorchan.matsource == MatSource::Vertex)
-      matcolor = src->color[chan];
-    else
-      std::memcpy(matcolor.data(), &xfmem.matColor[chan], sizeof(u32));
-
     if (colorchan.enablelighting)
     {
-      Vec3 lightCol;
-      if (colorchan.ambsource == AmbSource::Vertex)
+      lightCol = GetAmbientColor(src, chan);
+
+      u8 mask = colorchan.GetFullLightMask();
+      for (int i = 0; i < 8; ++i)
       {
-        lightCol.x = src->color[chan][1];
-        lightCol.y = src->color[chan][2];
-        lightCol.z = src->color[chan][3];
+        if (mask & (1 << i))
+          LightColor(dst->mvPosition, dst->normal[0], i, colorchan, lightCol);
       }
-      else
+    }
+
+    float lightAlpha = 0.0f;
+    const LitChannel& alphachan = xfmem.alpha[chan];
+    if (alphachan.enablelighting)
+    {
+      lightAlpha = GetAmbientAlpha(src, chan);
+
+      u8 mask = alphachan.GetFullLightMask();
+      for (int i = 0; i < 8; ++i)
       {
-        const u8* ambColor = reinterpret_cast<u8*>(&xfmem.ambColor[chan]);
-        lightCol.x = ambColor[1];
-        lightCol.y = ambColor[2];
-        lightCol.z = ambColor[3];
+        if (mask & (1 << i))
+          LightAlpha(dst->mvPosition, dst->normal[0], i, alphachan, lightAlpha);
       }
+    }
+
+    WriteChannelColor(src, dst, chan, lightCol, lightAlpha);
+  }
+}
+
+#if defined(_M_X86) || defined(_M_X86_64)
+// The light and channel configuration is the same for every vertex, so the lighting functions
+// below only branch on it and evaluate the per-vertex conditions of the scalar versions with
+// masks. As with positions and normals, each lane matches the scalar result bit for bit.
+static __m128 Dot4(const Vec3x4& a, const Vec3x4& b)
+{
+  return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)),
+                    _mm_mul_ps(a.z, b.z));
+}
+
+static __m128 Dot4(const Vec3x4& a, const Vec3& b)
+{
+  return MultiplyRow3(&b.x, a);
+}
+
+static Vec3x4 Scale4(const Vec3x4& v, __m128 f)
+{
+  return {_mm_mul_ps(v.x, f), _mm_mul_ps(v.y, f), _mm_mul_ps(v.z, f)};
+}
+
+static __m128 Select4(__m128 mask, __m128 a, __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// std::max(0.0f, v), which also returns 0 for NaN
+static __m128 Max0(__m128 v)
+{
+  return _mm_max_ps(v, _mm_setzero_ps());
+}
+
+static __m128 SafeDivide4(__m128 n, __m128 d)
+{
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one_if_positive = _mm_and_ps(_mm_cmpgt_ps(n, zero), _mm_set1_ps(1.0f));
+  return Select4(_mm_cmpeq_ps(d, zero), one_if_positive, _mm_div_ps(n, d));
+}
+
+static Vec3x4 Normalized4(const Vec3x4& v)
+{
+  return Scale4(v, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(Dot4(v, v))));
+}
+
+static __m128 CalculateLightAttn4(const LightPointer* light, Vec3x4* ldir, const Vec3x4& normal,
+                                  const LitChannel& chan)
+{
+  __m128 attn = _mm_set1_ps(1.0f);
+
+  switch (chan.attnfunc)
+  {
+  case AttenuationFunc::None:
+  case AttenuationFunc::Dir:
+  {
+    *ldir = Normalized4(*ldir);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 is_zero = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(ldir->x, zero),
+                                                 _mm_cmpeq_ps(ldir->y, zero)),
+                                      _mm_cmpeq_ps(ldir->z, zero));
+    ldir->x = Select4(is_zero, normal.x, ldir->x);
+    ldir->y = Select4(is_zero, normal.y, ldir->y);
+    ldir->z = Select4(is_zero, normal.z, ldir->z);
+    break;
+  }
+  case AttenuationFunc::Spec:
+  {
+    *ldir = Normalized4(*ldir);
+    const __m128 facing = _mm_cmpge_ps(Dot4(*ldir, normal), _mm_setzero_ps());
+    attn = _mm_and_ps(facing, Max0(Dot4(normal, light->dir)));
+
+    const Vec3 cosAttn = light->cosatt;
+    Vec3 distAttn = light->distatt;
+    if (chan.diffusefunc != DiffuseFunc::None)
+      distAttn = distAttn.Normalized();
+
+    // attLen = (1, attn, attn * attn)
+    const Vec3x4 attLen = {_mm_set1_ps(1.0f), attn, _mm_mul_ps(attn, attn)};
+    attn = SafeDivide4(Max0(Dot4(attLen, cosAttn)), Dot4(attLen, distAttn));
+    break;
+  }
+  case AttenuationFunc::Spot:
+  {
+    const __m128 dist2 = Dot4(*ldir, *ldir);
+    const __m128 dist = _mm_sqrt_ps(dist2);
+    *ldir = Scale4(*ldir, _mm_div_ps(_mm_set1_ps(1.0f), dist));
+    attn = Max0(Dot4(*ldir, light->dir));
+
+    const Vec3& cosatt = light->cosatt;
+    const Vec3& distatt = light->distatt;
+    const __m128 cosAtt =
+        _mm_add_ps(_mm_add_ps(_mm_set1_ps(cosatt.x), _mm_mul_ps(_mm_set1_ps(cosatt.y), attn)),
+                   _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(cosatt.z), attn), attn));
+    const __m128 distAtt =
+        _mm_add_ps(_mm_add_ps(_mm_set1_ps(distatt.x), _mm_mul_ps(_mm_set1_ps(distatt.y), dist)),
+                   _mm_mul_ps(_mm_set1_ps(distatt.z), dist2));
+    attn = SafeDivide4(Max0(cosAtt), distAtt);
+    break;
+  }
+  default:
+    PanicAlertFmt("Invalid attnfunc: {}", chan.attnfunc);
+  }
+
+  return attn;
+}
+
+static Vec3x4 GetLightDirection4(const LightPointer* light, const Vec3x4& pos)
+{
+  return {_mm_sub_ps(_mm_set1_ps(light->pos.x), pos.x),
+          _mm_sub_ps(_mm_set1_ps(light->pos.y), pos.y),
+          _mm_sub_ps(_mm_set1_ps(light->pos.z), pos.z)};
+}
+
+static void LightColor4(const Vec3x4& pos, const Vec3x4& normal, u8 lightNum,
+                        const LitChannel& chan, Vec3x4& lightCol)
+{
+  const LightPointer* light = (const LightPointer*)&xfmem.lights[lightNum];
+
+  Vec3x4 ldir = GetLightDirection4(light, pos);
+  __m128 scale = CalculateLightAttn4(light, &ldir, normal, chan);
+
+  switch (chan.diffusefunc)
+  {
+  case DiffuseFunc::None:
+    break;
+  case DiffuseFunc::Sign:
+    scale = _mm_mul_ps(scale, Dot4(ldir, normal));
+    break;
+  case DiffuseFunc::Clamp:
+    scale = _mm_mul_ps(scale, Max0(Dot4(ldir, normal)));
+    break;
+  default:
+    PanicAlertFmt("Invalid diffusefunc: {}", chan.attnfunc);
+    return;
+  }
+
+  lightCol.x = _mm_add_ps(lightCol.x, _mm_mul_ps(_mm_set1_ps(light->color[1]), scale));
+  lightCol.y = _mm_add_ps(lightCol.y, _mm_mul_ps(_mm_set1_ps(light->color[2]), scale));
+  lightCol.z = _mm_add_ps(lightCol.z, _mm_mul_ps(_mm_set1_ps(light->color[3]), scale));
+}
+
+static void LightAlpha4(const Vec3x4& pos, const Vec3x4& normal, u8 lightNum,
+                        const LitChannel& chan, __m128& lightCol)
+{
+  const LightPointer* light = (const LightPointer*)&xfmem.lights[lightNum];
+
+  Vec3x4 ldir = GetLightDirection4(light, pos);
+  const __m128 attn = CalculateLightAttn4(light, &ldir, normal, chan);
+
+  // Unlike LightColor, the color is multiplied by the attenuation before the diffuse factor.
+  __m128 light_col = _mm_mul_ps(_mm_set1_ps(light->color[0]), attn);
+  switch (chan.diffusefunc)
+  {
+  case DiffuseFunc::None:
+    break;
+  case DiffuseFunc::Sign:
+    light_col = _mm_mul_ps(light_col, Dot4(ldir, normal));
+    break;
+  case DiffuseFunc::Clamp:
+    light_col = _mm_mul_ps(light_col, Max0(Dot4(ldir, normal)));
+    break;
+  default:
+    PanicAlertFmt("Invalid diffusefunc: {}", chan.attnfunc);
+    return;
+  }
+
+  lightCol = _mm_add_ps(lightCol, light_col);
+}
+
+static void TransformColor4(const InputVertexData* src, OutputVertexData* dst)
+{
+  const Vec3x4 pos = LoadVec3x4([dst](int i) -> const Vec3& { return dst[i].mvPosition; });
+  const Vec3x4 normal = LoadVec3x4([dst](int i) -> const Vec3& { return dst[i].normal[0]; });
+
+  for (u32 chan = 0; chan < NUM_XF_COLOR_CHANNELS; chan++)
+  {
+    std::array<Vec3, 4> lightCol;
+    lightCol.fill(Vec3(0.0f));
+    const LitChannel& colorchan = xfmem.color[chan];
+    if (colorchan.enablelighting)
+    {
+      for (int i = 0; i < 4; i++)
+        lightCol[i] = GetAmbientColor(&src[i], chan);
+      Vec3x4 lightCol4 = LoadVec3x4([&lightCol](int i) -> const Vec3& { return lightCol[i]; });
 
       u8 mask = colorchan.GetFullLightMask();
       for (int i = 0; i < 8; ++i)
       {
         if (mask & (1 << i))
-          LightColor(dst->mvPosition, dst->normal[0], i, colorchan, lightCol);
+          LightColor4(pos, normal, i, colorchan, lightCol4);
       }
 
-      int light_x = std::clamp(static_cast<int>(lightCol.x), 0, 255);
-      int light_y = std::clamp(static_cast<int>(lightCol.y), 0, 255);
-      int light_z = std::clamp(static_cast<int>(lightCol.z), 0, 255);
-      chancolor[1] = (matcolor[1] * (light_x + (light_x >> 7))) >> 8;
-      chancolor[2] = (matcolor[2] * (light_y + (light_y >> 7))) >> 8;
-      chancolor[3] = (matcolor[3] * (light_z + (light_z >> 7))) >> 8;
-    }
-    else
-    {
-      chancolor = matcolor;
+      StoreVec3x4(lightCol4, [&lightCol](int i) -> Vec3& { return lightCol[i]; });
     }
 
-    // alpha
+    alignas(16) std::array<float, 4> lightAlpha{};
     const LitChannel& alphachan = xfmem.alpha[chan];
-    if (alphachan.matsource == MatSource::Vertex)
-      matcolor[0] = src->color[chan][0];
-    else
-      matcolor[0] = xfmem.matColor[chan] & 0xff;
-
-    if (xfmem.alpha[chan].enablelighting)
+    if (alphachan.enablelighting)
     {
-      float lightCol;
-      if (alphachan.ambsource == AmbSource::Vertex)
-        lightCol = src->color[chan][0];
-      else
-        lightCol = static_cast<float>(xfmem.ambColor[chan] & 0xff);
+      __m128 lightAlpha4 =
+          _mm_setr_ps(GetAmbientAlpha(&src[0], chan), GetAmbientAlpha(&src[1], chan),
+                      GetAmbientAlpha(&src[2], chan), GetAmbientAlpha(&src[3], chan));
 
       u8 mask = alphachan.GetFullLightMask();
       for (int i = 0; i < 8; ++i)
       {
         if (mask & (1 << i))
-          LightAlpha(dst->mvPosition, dst->normal[0], i, alphachan, lightCol);
+          LightAlpha4(pos, normal, i, alphachan, lightAlpha4);
       }
 
-      int light_a = std::clamp(static_cast<int>(lightCol), 0, 255);
-      chancolor[0] = (matcolor[0] * (light_a + (light_a >> 7))) >> 8;
-    }
-    else
-    {
-      chancolor[0] = matcolor[0];
+      _mm_store_ps(lightAlpha.data(), lightAlpha4);
     }
 
-    // abgr -> rgba
-    const u32 rgba_color = Common::swap32(chancolor.data());
-    std::memcpy(dst->color[chan].data(), &rgba_color, sizeof(u32));
+    for (int i = 0; i < 4; i++)
+      WriteChannelColor(&src[i], &dst[i], chan, lightCol[i], lightAlpha[i]);
   }
 }
+#endif
+
+void TransformColors(const InputVertexData* src, OutputVertexData* dst, std::size_t count)
+{
+  std::size_t i = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  for (; i + 4 <= count; i += 4)
+    TransformColor4(&src[i], &dst[i]);
+#endif
+  for (; i < count; i++)
+    TransformColor(&src[i], &dst[i]);
+}
 
 void TransformTexCoord(const InputVertexData* src, OutputVertexData* dst)
 {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 struct InputVertexData;
 struct OutputVertexData;
 
@@ -12,4 +14,12 @@ void TransformPosition(const InputVertexData* src, OutputVertexData* dst);
 void TransformNormal(const InputVertexData* src, bool nbt, OutputVertexData* dst);
 void TransformColor(const InputVertexData* src, OutputVertexData* dst);
 void TransformTexCoord(const InputVertexData* src, OutputVertexData* dst);
+
+// Batched versions of TransformPosition, TransformNormal and TransformColor for count consecutive
+// vertices. Where possible, four vertices are processed at once; the results are bit-identical to
+// transforming each vertex individually.
+void TransformPositions(const InputVertexData* src, OutputVertexData* dst, std::size_t count);
+void TransformNormals(const InputVertexData* src, bool nbt, OutputVertexData* dst,
+                      std::size_t count);
+void TransformColors(const InputVertexData* src, OutputVertexData* dst, std::size_t count);
 }  // namespace TransformUnit
@@ -0,0 +1,275 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/HiresTexturePack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "Common/Align.h"
+#include "Common/Logging/Log.h"
+#include "VideoCommon/AbstractTexture.h"
+
+namespace
+{
+struct PackHeader
+{
+  u32 magic;
+  u32 version;
+  u32 num_textures;
+  u32 num_levels;
+  u64 index_offset;
+  u64 index_size;
+};
+static_assert(sizeof(PackHeader) == 32);
+
+enum PackTextureFlags : u32
+{
+  PACK_TEXTURE_FLAG_ARBITRARY_MIPMAPS = 1 << 0,
+};
+
+struct PackTextureEntry
+{
+  u32 name_offset;
+  u32 name_length;
+  u32 format;
+  u32 flags;
+  u32 first_level;
+  u32 num_levels;
+};
+static_assert(sizeof(PackTextureEntry) == 24);
+
+struct PackLevelEntry
+{
+  u64 offset;
+  u32 size;
+  u32 width;
+  u32 height;
+  u32 row_length;
+};
+static_assert(sizeof(PackLevelEntry) == 24);
+}  // Anonymous namespace
+
+bool HiresTexturePack::IsValidLevel(AbstractTextureFormat format, u32 width, u32 height,
+                                    u32 row_length, u64 size)
+{
+  const u32 block_size = AbstractTexture::GetBlockSizeForFormat(format);
+  if (width == 0 || height == 0 || row_length < width || row_length % block_size != 0)
+    return false;
+
+  const u64 blocks_high = std::max(Common::AlignUp(height, block_size) / block_size, 1u);
+  return size == AbstractTexture::CalculateStrideForFormat(format, row_length) * blocks_high;
+}
+
+bool HiresTexturePack::Open(const std::string& path)
+{
+  m_path = path;
+  m_textures.clear();
+  m_levels.clear();
+
+  if (!m_file.Open(path, "rb"))
+    return false;
+
+  const u64 file_size = m_file.GetSize();
+  PackHeader header;
+  if (!m_file.ReadArray(&header, 1) || header.magic != MAGIC)
+  {
+    ERROR_LOG_FMT(VIDEO, "{} is not a texture pack", path);
+    return false;
+  }
+  if (header.version != VERSION)
+  {
+    ERROR_LOG_FMT(VIDEO, "Texture pack {} has unsupported version {}", path, header.version);
+    return false;
+  }
+
+  const u64 entries_size = static_cast<u64>(header.num_textures) * sizeof(PackTextureEntry) +
+                           static_cast<u64>(header.num_levels) * sizeof(PackLevelEntry);
+  if (header.index_offset < sizeof(PackHeader) || header.index_offset > file_size ||
+      header.index_size > file_size - header.index_offset || header.index_size < entries_size)
+  {
+    ERROR_LOG_FMT(VIDEO, "Texture pack {} has a corrupted index", path);
+    return false;
+  }
+
+  std::vector<u8> index(header.index_size);
+  if (!m_file.Seek(header.index_offset, SEEK_SET) || !m_file.ReadBytes(index.data(), index.size()))
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to read the index of texture pack {}", path);
+    return false;
+  }
+
+  const u8* texture_entries = index.data();
+  const u8* level_entries = texture_entries + header.num_textures * sizeof(PackTextureEntry);
+  const char* names = reinterpret_cast<const char*>(index.data() + entries_size);
+  const u64 names_size = header.index_size - entries_size;
+
+  m_levels.resize(header.num_levels);
+  for (u32 i = 0; i < header.num_levels; i++)
+  {
+    PackLevelEntry entry;
+    std::memcpy(&entry, level_entries + i * sizeof(PackLevelEntry), sizeof(entry));
+    if (entry.offset > header.index_offset || entry.size > header.index_offset - entry.offset)
+    {
+      ERROR_LOG_FMT(VIDEO, "Texture pack {} has a corrupted index", path);
+      return false;
+    }
+
+    m_levels[i] = {entry.offset, entry.size, entry.width, entry.height, entry.row_length};
+  }
+
+  m_textures.resize(header.num_textures);
+  for (u32 i = 0; i < header.num_textures; i++)
+  {
+    PackTextureEntry entry;
+    std::memcpy(&entry, texture_entries + i * sizeof(PackTextureEntry), sizeof(entry));
+    if (static_cast<u64>(entry.name_offset) + entry.name_length > names_size ||
+        static_cast<u64>(entry.first_level) + entry.num_levels > header.num_levels ||
+        entry.num_levels == 0 ||
+        entry.format >= static_cast<u32>(AbstractTextureFormat::Undefined))
+    {
+      ERROR_LOG_FMT(VIDEO, "Texture pack {} has a corrupted index", path);
+      return false;
+    }
+
+    // Uploading a level reads as many bytes as its dimensions need, so the data has to be exactly
+    // that large.
+    const auto format = static_cast<AbstractTextureFormat>(entry.format);
+    for (u32 level = entry.first_level; level < entry.first_level + entry.num_levels; level++)
+    {
+      const LevelInfo& info = m_levels[level];
+      if (!IsValidLevel(format, info.width, info.height, info.row_length, info.size))
+      {
+        ERROR_LOG_FMT(VIDEO, "Texture pack {} has a corrupted index", path);
+        return false;
+      }
+    }
+
+    Texture& texture = m_textures[i];
+    texture.name.assign(names + entry.name_offset, entry.name_length);
+    texture.format = format;
+    texture.has_arbitrary_mipmaps = (entry.flags & PACK_TEXTURE_FLAG_ARBITRARY_MIPMAPS) != 0;
+    texture.first_level = entry.first_level;
+    texture.num_levels = entry.num_levels;
+  }
+
+  return true;
+}
+
+bool HiresTexturePack::ReadLevels(const Texture& texture, std::vector<HiresTexture::Level>* levels)
+{
+  std::lock_guard<std::mutex> lk(m_file_mutex);
+
+  for (u32 i = 0; i < texture.num_levels; i++)
+  {
+    const LevelInfo& info = m_levels[texture.first_level + i];
+
+    HiresTexture::Level level;
+    level.format = texture.format;
+    level.width = info.width;
+    level.height = info.height;
+    level.row_length = info.row_length;
+    level.data.resize(info.size);
+    if (!m_file.Seek(info.offset, SEEK_SET) || !m_file.ReadBytes(level.data.data(), info.size))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to read custom texture {} from texture pack {}", texture.name,
+                    m_path);
+      return false;
+    }
+
+    levels->push_back(std::move(level));
+  }
+
+  return true;
+}
+
+bool HiresTexturePackWriter::Open(const std::string& path)
+{
+  m_textures.clear();
+  m_levels.clear();
+  m_data_size = 0;
+
+  // The header is written last, once the index offset is known.
+  const PackHeader header{};
+  return m_file.Open(path, "wb") && m_file.WriteArray(&header, 1);
+}
+
+bool HiresTexturePackWriter::AddTexture(const std::string& name, bool has_arbitrary_mipmaps,
+                                        const std::vector<HiresTexture::Level>& levels)
+{
+  if (levels.empty())
+    return false;
+
+  HiresTexturePack::Texture texture;
+  texture.name = name;
+  texture.format = levels[0].format;
+  texture.has_arbitrary_mipmaps = has_arbitrary_mipmaps;
+  texture.first_level = static_cast<u32>(m_levels.size());
+  texture.num_levels = static_cast<u32>(levels.size());
+
+  for (const HiresTexture::Level& level : levels)
+  {
+    static constexpr u8 padding[HiresTexturePack::DATA_ALIGNMENT] = {};
+    const u64 position = sizeof(PackHeader) + m_data_size;
+    const u64 aligned_position = Common::AlignUp(position, HiresTexturePack::DATA_ALIGNMENT);
+    if (!m_file.WriteBytes(padding, aligned_position - position) ||
+        !m_file.WriteBytes(level.data.data(), level.data.size()))
+    {
+      return false;
+    }
+
+    m_levels.push_back({aligned_position, static_cast<u32>(level.data.size()), level.width,
+                        level.height, level.row_length});
+    m_data_size = aligned_position + level.data.size() - sizeof(PackHeader);
+  }
+
+  m_textures.push_back(std::move(texture));
+  return true;
+}
+
+bool HiresTexturePackWriter::Finish()
+{
+  std::sort(m_textures.begin(), m_textures.end(),
+            [](const auto& a, const auto& b) { return a.name < b.name; });
+
+  std::vector<PackTextureEntry> texture_entries;
+  texture_entries.reserve(m_textures.size());
+  std::string names;
+  for (const HiresTexturePack::Texture& texture : m_textures)
+  {
+    PackTextureEntry entry{};
+    entry.name_offset = static_cast<u32>(names.size());
+    entry.name_length = static_cast<u32>(texture.name.size());
+    entry.format = static_cast<u32>(texture.format);
+    entry.flags = texture.has_arbitrary_mipmaps ? PACK_TEXTURE_FLAG_ARBITRARY_MIPMAPS : 0;
+    entry.first_level = texture.first_level;
+    entry.num_levels = texture.num_levels;
+    texture_entries.push_back(entry);
+    names += texture.name;
+  }
+
+  std::vector<PackLevelEntry> level_entries;
+  level_entries.reserve(m_levels.size());
+  for (const HiresTexturePack::LevelInfo& level : m_levels)
+  {
+    level_entries.push_back(
+        {level.offset, level.size, level.width, level.height, level.row_length});
+  }
+
+  PackHeader header;
+  header.magic = HiresTexturePack::MAGIC;
+  header.version = HiresTexturePack::VERSION;
+  header.num_textures = static_cast<u32>(texture_entries.size());
+  header.num_levels = static_cast<u32>(level_entries.size());
+  header.index_offset = sizeof(PackHeader) + m_data_size;
+  header.index_size = texture_entries.size() * sizeof(PackTextureEntry) +
+                      level_entries.size() * sizeof(PackLevelEntry) + names.size();
+
+  const bool success = m_file.WriteArray(texture_entries.data(), texture_entries.size()) &&
+                       m_file.WriteArray(level_entries.data(), level_entries.size()) &&
+                       m_file.WriteBytes(names.data(), names.size()) &&
+                       m_file.Seek(0, SEEK_SET) && m_file.WriteArray(&header, 1);
+  return m_file.Close() && success;
+}
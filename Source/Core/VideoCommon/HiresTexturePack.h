@@ -0,0 +1,91 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "VideoCommon/HiresTextures.h"
+#include "VideoCommon/TextureConfig.h"
+
+// A texture pack stores every custom texture of a texture directory in a single file.
+// The index (texture names, formats and level sizes) lives at the end of the file and is the only
+// thing read when the pack is opened. Level data is stored exactly as it is uploaded to the GPU
+// (decoded RGBA8 for PNG textures, the original block-compressed data for DDS textures), so
+// loading a texture is just a seek and read per mip level, without any decoding.
+//
+// File layout:
+//   Header
+//   Level data, each level aligned to DATA_ALIGNMENT
+//   TextureEntry[num_textures], sorted by name
+//   LevelEntry[num_levels]
+//   Name table
+class HiresTexturePack
+{
+public:
+  static constexpr u32 MAGIC = 0x50544844;  // "DHTP"
+  static constexpr u32 VERSION = 1;
+  static constexpr u32 DATA_ALIGNMENT = 16;
+
+  // File name of the pack inside a texture directory.
+  static constexpr const char* FILENAME = "textures.dtp";
+
+  struct Texture
+  {
+    std::string name;
+    AbstractTextureFormat format = AbstractTextureFormat::RGBA8;
+    bool has_arbitrary_mipmaps = false;
+    u32 first_level = 0;
+    u32 num_levels = 0;
+  };
+
+  struct LevelInfo
+  {
+    u64 offset = 0;
+    u32 size = 0;
+    u32 width = 0;
+    u32 height = 0;
+    u32 row_length = 0;
+  };
+
+  // Whether size is the number of bytes a level with these dimensions takes up when uploaded,
+  // using the same layout as the DDS loader: rows of row_length texels, padded to whole blocks.
+  static bool IsValidLevel(AbstractTextureFormat format, u32 width, u32 height, u32 row_length,
+                           u64 size);
+
+  bool Open(const std::string& path);
+  const std::string& GetPath() const { return m_path; }
+  const std::vector<Texture>& GetTextures() const { return m_textures; }
+
+  // Safe to call from multiple threads.
+  bool ReadLevels(const Texture& texture, std::vector<HiresTexture::Level>* levels);
+
+private:
+  std::string m_path;
+  std::vector<Texture> m_textures;
+  std::vector<LevelInfo> m_levels;
+
+  std::mutex m_file_mutex;
+  File::IOFile m_file;
+};
+
+class HiresTexturePackWriter
+{
+public:
+  bool Open(const std::string& path);
+  bool AddTexture(const std::string& name, bool has_arbitrary_mipmaps,
+                  const std::vector<HiresTexture::Level>& levels);
+  bool Finish();
+
+  u64 GetDataSize() const { return m_data_size; }
+
+private:
+  File::IOFile m_file;
+  std::vector<HiresTexturePack::Texture> m_textures;
+  std::vector<HiresTexturePack::LevelInfo> m_levels;
+  u64 m_data_size = 0;
+};
@@ -30,6 +30,7 @@
 #include "Common/Timer.h"
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
+#include "VideoCommon/HiresTexturePack.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -37,17 +38,75 @@ struct DiskTexture
 {
   std::string path;
   bool has_arbitrary_mipmaps;
+
+  // Set if the texture is stored in a texture pack rather than as a loose file.
+  HiresTexturePack* pack = nullptr;
+  const HiresTexturePack::Texture* pack_texture = nullptr;
 };
 
 constexpr std::string_view s_format_prefix{"tex1_"};
 
 static std::unordered_map<std::string, DiskTexture> s_textureMap;
+static std::vector<std::unique_ptr<HiresTexturePack>> s_texturePacks;
 static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
 static std::mutex s_textureCacheMutex;
 static Common::Flag s_textureCacheAbortLoading;
 
 static std::thread s_prefetcher;
 
+// Returns false if any texture in the directory was already in the map.
+static bool ScanTextureDirectory(const std::string& texture_directory,
+                                 std::unordered_map<std::string, DiskTexture>* texture_map)
+{
+  const std::vector<std::string> extensions{".png", ".dds"};
+  const auto texture_paths =
+      Common::DoFileSearch({texture_directory}, extensions, /*recursive*/ true);
+
+  bool failed_insert = false;
+  for (auto& path : texture_paths)
+  {
+    std::string filename;
+    SplitPath(path, nullptr, &filename, nullptr);
+
+    if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
+    {
+      const size_t arb_index = filename.rfind("_arb");
+      const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
+      if (has_arbitrary_mipmaps)
+        filename.erase(arb_index, 4);
+
+      const auto [it, inserted] =
+          texture_map->try_emplace(filename, DiskTexture{path, has_arbitrary_mipmaps});
+      if (!inserted)
+      {
+        failed_insert = true;
+      }
+    }
+  }
+
+  return !failed_insert;
+}
+
+// Returns false if any texture in the pack was already in the map.
+static bool AddTexturePack(std::unique_ptr<HiresTexturePack> pack,
+                           std::unordered_map<std::string, DiskTexture>* texture_map)
+{
+  bool failed_insert = false;
+  for (const HiresTexturePack::Texture& texture : pack->GetTextures())
+  {
+    const auto [it, inserted] = texture_map->try_emplace(
+        texture.name,
+        DiskTexture{pack->GetPath(), texture.has_arbitrary_mipmaps, pack.get(), &texture});
+    if (!inserted)
+    {
+      failed_insert = true;
+    }
+  }
+
+  s_texturePacks.push_back(std::move(pack));
+  return !failed_insert;
+}
+
 void HiresTexture::Init()
 {
   // Note: Update is not called here so that we handle dynamic textures on startup more gracefully
@@ -80,36 +139,17 @@ void HiresTexture::Update()
   const std::string& game_id = SConfig::GetInstance().GetGameID();
   const std::set<std::string> texture_directories =
       GetTextureDirectoriesWithGameId(File::GetUserPath(D_HIRESTEXTURES_IDX), game_id);
-  const std::vector<std::string> extensions{".png", ".dds"};
 
   for (const auto& texture_directory : texture_directories)
   {
-    const auto texture_paths =
-        Common::DoFileSearch({texture_directory}, extensions, /*recursive*/ true);
-
-    bool failed_insert = false;
-    for (auto& path : texture_paths)
-    {
-      std::string filename;
-      SplitPath(path, nullptr, &filename, nullptr);
-
-      if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
-      {
-        const size_t arb_index = filename.rfind("_arb");
-        const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
-        if (has_arbitrary_mipmaps)
-          filename.erase(arb_index, 4);
-
-        const auto [it, inserted] =
-            s_textureMap.try_emplace(filename, DiskTexture{path, has_arbitrary_mipmaps});
-        if (!inserted)
-        {
-          failed_insert = true;
-        }
-      }
-    }
-
-    if (failed_insert)
+    // A texture pack replaces the loose files of its directory, which then don't need scanning.
+    const std::string pack_path = texture_directory + DIR_SEP + HiresTexturePack::FILENAME;
+    auto pack = std::make_unique<HiresTexturePack>();
+    const bool success = File::Exists(pack_path) && pack->Open(pack_path) ?
+                             AddTexturePack(std::move(pack), &s_textureMap) :
+                             ScanTextureDirectory(texture_directory, &s_textureMap);
+
+    if (!success)
     {
       ERROR_LOG_FMT(VIDEO, "One or more textures at path '{}' were already inserted",
                     texture_directory);
@@ -146,6 +186,7 @@ void HiresTexture::Clear()
   }
   s_textureMap.clear();
   s_textureCache.clear();
+  s_texturePacks.clear();
 }
 
 void HiresTexture::Prefetch()
@@ -159,6 +200,7 @@ void HiresTexture::Prefetch()
   const size_t max_mem =
       (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
 
+  const CompressedFormats formats = GetBackendCompressedFormats();
   const u32 start_time = Common::Timer::GetTimeMs();
   for (const auto& entry : s_textureMap)
   {
@@ -174,7 +216,8 @@ void HiresTexture::Prefetch()
         // unlock while loading a texture. This may result in a race condition where
         // we'll load a texture twice, but it reduces the stuttering a lot.
         lk.unlock();
-        std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0);
+        std::unique_ptr<HiresTexture> texture =
+            Load(s_textureMap, base_filename, 0, 0, formats);
         lk.lock();
         if (texture)
         {
@@ -273,8 +316,9 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(TextureInfo& texture_info)
     return iter->second;
   }
 
-  std::shared_ptr<HiresTexture> ptr(
-      Load(base_filename, texture_info.GetRawWidth(), texture_info.GetRawHeight()));
+  std::shared_ptr<HiresTexture> ptr(Load(s_textureMap, base_filename, texture_info.GetRawWidth(),
+                                        texture_info.GetRawHeight(),
+                                        GetBackendCompressedFormats()));
 
   if (ptr && g_ActiveConfig.bCacheHiresTextures)
   {
@@ -284,51 +328,139 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(TextureInfo& texture_info)
   return ptr;
 }
 
-std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
-                                                 u32 height)
+HiresTexture::CompressedFormats HiresTexture::GetBackendCompressedFormats()
+{
+  return {g_ActiveConfig.backend_info.bSupportsST3CTextures,
+          g_ActiveConfig.backend_info.bSupportsBPTCTextures};
+}
+
+bool HiresTexture::CreateTexturePack(const std::string& texture_directory,
+                                     const std::string& pack_path, const CompressedFormats& formats)
+{
+  std::unordered_map<std::string, DiskTexture> texture_map;
+  if (!ScanTextureDirectory(texture_directory, &texture_map))
+  {
+    ERROR_LOG_FMT(VIDEO, "One or more textures at path '{}' were already inserted",
+                  texture_directory);
+  }
+
+  HiresTexturePackWriter writer;
+  if (!writer.Open(pack_path))
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to create texture pack {}", pack_path);
+    return false;
+  }
+
+  for (const auto& entry : texture_map)
+  {
+    const std::string& base_filename = entry.first;
+    if (base_filename.find("_mip") != std::string::npos)
+      continue;
+
+    // Textures which fail to load are left out, the game would not be able to use them either.
+    const std::unique_ptr<HiresTexture> texture = Load(texture_map, base_filename, 0, 0, formats);
+    if (!texture)
+      continue;
+
+    // Neither are textures whose levels are smaller than their dimensions need, since the pack
+    // would be rejected when it's opened.
+    const auto is_valid_level = [](const Level& level) {
+      return HiresTexturePack::IsValidLevel(level.format, level.width, level.height,
+                                            level.row_length, level.data.size());
+    };
+    if (!std::all_of(texture->m_levels.begin(), texture->m_levels.end(), is_valid_level))
+    {
+      WARN_LOG_FMT(VIDEO, "Leaving custom texture {} out of texture pack {}: invalid level size",
+                   base_filename, pack_path);
+      continue;
+    }
+
+    if (!writer.AddTexture(base_filename, texture->m_has_arbitrary_mipmaps, texture->m_levels))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to write custom texture {} to texture pack {}", base_filename,
+                    pack_path);
+      return false;
+    }
+  }
+
+  if (!writer.Finish())
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to write the index of texture pack {}", pack_path);
+    return false;
+  }
+
+  return true;
+}
+
+std::unique_ptr<HiresTexture>
+HiresTexture::Load(const std::unordered_map<std::string, DiskTexture>& texture_map,
+                   const std::string& base_filename, u32 width, u32 height,
+                   const CompressedFormats& formats)
 {
   // We need to have a level 0 custom texture to even consider loading.
-  auto filename_iter = s_textureMap.find(base_filename);
-  if (filename_iter == s_textureMap.end())
+  auto filename_iter = texture_map.find(base_filename);
+  if (filename_iter == texture_map.end())
     return nullptr;
 
-  // Try to load level 0 (and any mipmaps) from a DDS file.
-  // If this fails, it's fine, we'll just load level0 again using SOIL.
   // Can't use make_unique due to private constructor.
   std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
   const DiskTexture& first_mip_file = filename_iter->second;
   ret->m_has_arbitrary_mipmaps = first_mip_file.has_arbitrary_mipmaps;
-  LoadDDSTexture(ret.get(), first_mip_file.path);
 
-  // Load remaining mip levels, or from the start if it's not a DDS texture.
-  for (u32 mip_level = static_cast<u32>(ret->m_levels.size());; mip_level++)
+  if (first_mip_file.pack)
   {
-    std::string filename = base_filename;
-    if (mip_level != 0)
-      filename += fmt::format("_mip{}", mip_level);
-
-    filename_iter = s_textureMap.find(filename);
-    if (filename_iter == s_textureMap.end())
-      break;
-
-    // Try loading DDS textures first, that way we maintain compression of DXT formats.
-    // TODO: Reduce the number of open() calls here. We could use one fd.
-    Level level;
-    if (!LoadDDSTexture(level, filename_iter->second.path, mip_level))
+    // Packed textures already contain every mip level in their final format.
+    const AbstractTextureFormat format = first_mip_file.pack_texture->format;
+    const bool is_s3tc = format == AbstractTextureFormat::DXT1 ||
+                         format == AbstractTextureFormat::DXT3 ||
+                         format == AbstractTextureFormat::DXT5;
+    const bool is_bptc = format == AbstractTextureFormat::BPTC;
+    if ((is_s3tc && !formats.s3tc) || (is_bptc && !formats.bptc))
     {
-      File::IOFile file;
-      file.Open(filename_iter->second.path, "rb");
-      std::vector<u8> buffer(file.GetSize());
-      file.ReadBytes(buffer.data(), file.GetSize());
+      ERROR_LOG_FMT(VIDEO, "Custom texture {} uses a format not supported by the backend",
+                    base_filename);
+      return nullptr;
+    }
 
-      if (!LoadTexture(level, buffer))
-      {
-        ERROR_LOG_FMT(VIDEO, "Custom texture {} failed to load", filename);
+    if (!first_mip_file.pack->ReadLevels(*first_mip_file.pack_texture, &ret->m_levels))
+      return nullptr;
+  }
+  else
+  {
+    // Try to load level 0 (and any mipmaps) from a DDS file.
+    // If this fails, it's fine, we'll just load level0 again using SOIL.
+    LoadDDSTexture(ret.get(), first_mip_file.path, formats);
+
+    // Load remaining mip levels, or from the start if it's not a DDS texture.
+    for (u32 mip_level = static_cast<u32>(ret->m_levels.size());; mip_level++)
+    {
+      std::string filename = base_filename;
+      if (mip_level != 0)
+        filename += fmt::format("_mip{}", mip_level);
+
+      filename_iter = texture_map.find(filename);
+      if (filename_iter == texture_map.end())
         break;
+
+      // Try loading DDS textures first, that way we maintain compression of DXT formats.
+      // TODO: Reduce the number of open() calls here. We could use one fd.
+      Level level;
+      if (!LoadDDSTexture(level, filename_iter->second.path, mip_level, formats))
+      {
+        File::IOFile file;
+        file.Open(filename_iter->second.path, "rb");
+        std::vector<u8> buffer(file.GetSize());
+        file.ReadBytes(buffer.data(), file.GetSize());
+
+        if (!LoadTexture(level, buffer))
+        {
+          ERROR_LOG_FMT(VIDEO, "Custom texture {} failed to load", filename);
+          break;
+        }
       }
-    }
 
-    ret->m_levels.push_back(std::move(level));
+      ret->m_levels.push_back(std::move(level));
+    }
   }
 
   // If we failed to load any mip levels, we can't use this texture at all.
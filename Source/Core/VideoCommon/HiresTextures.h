@@ -6,6 +6,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -13,6 +14,7 @@
 #include "VideoCommon/TextureInfo.h"
 
 enum class TextureFormat;
+struct DiskTexture;
 
 std::set<std::string> GetTextureDirectoriesWithGameId(const std::string& root_directory,
                                                       const std::string& game_id);
@@ -31,6 +33,19 @@ public:
 
   static u32 CalculateMipCount(u32 width, u32 height);
 
+  // Block-compressed formats which custom textures can be kept in. Textures in formats which are
+  // not supported are decoded to RGBA8 instead, or skipped if they come from a texture pack.
+  struct CompressedFormats
+  {
+    bool s3tc = false;
+    bool bptc = false;
+  };
+  static CompressedFormats GetBackendCompressedFormats();
+
+  // Packs every custom texture found in texture_directory into a single texture pack file.
+  static bool CreateTexturePack(const std::string& texture_directory, const std::string& pack_path,
+                                const CompressedFormats& formats);
+
   ~HiresTexture();
 
   AbstractTextureFormat GetFormat() const;
@@ -47,10 +62,13 @@ public:
   std::vector<Level> m_levels;
 
 private:
-  static std::unique_ptr<HiresTexture> Load(const std::string& base_filename, u32 width,
-                                            u32 height);
-  static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
-  static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level);
+  static std::unique_ptr<HiresTexture>
+  Load(const std::unordered_map<std::string, DiskTexture>& texture_map,
+       const std::string& base_filename, u32 width, u32 height, const CompressedFormats& formats);
+  static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename,
+                             const CompressedFormats& formats);
+  static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level,
+                             const CompressedFormats& formats);
   static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
   static void Prefetch();
 
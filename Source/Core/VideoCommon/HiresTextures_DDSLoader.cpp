@@ -13,7 +13,6 @@
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
-#include "VideoCommon/VideoConfig.h"
 
 namespace
 {
@@ -227,7 +226,8 @@ void ConvertTexture_R8G8B8(HiresTexture::Level* level)
   level->data = std::move(new_data);
 }
 
-bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info)
+bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info,
+                    const HiresTexture::CompressedFormats& formats)
 {
   // Exit as early as possible for non-DDS textures, since all extensions are currently
   // passed through this function.
@@ -317,7 +317,7 @@ bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info)
       info->format = AbstractTextureFormat::BPTC;
       info->block_size = 4;
       info->bytes_per_block = 16;
-      if (!g_ActiveConfig.backend_info.bSupportsBPTCTextures)
+      if (!formats.bptc)
         return false;
     }
     else
@@ -361,7 +361,7 @@ bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info)
 
   // We also need to ensure the backend supports these formats natively before loading them,
   // otherwise, fallback to SOIL, which will decompress them to RGBA.
-  if (needs_s3tc && !g_ActiveConfig.backend_info.bSupportsST3CTextures)
+  if (needs_s3tc && !formats.s3tc)
     return false;
 
   // Mip levels smaller than the block size are padded to multiples of the block size.
@@ -434,7 +434,8 @@ bool ReadMipLevel(HiresTexture::Level* level, File::IOFile& file, const std::str
 
 }  // namespace
 
-bool HiresTexture::LoadDDSTexture(HiresTexture* tex, const std::string& filename)
+bool HiresTexture::LoadDDSTexture(HiresTexture* tex, const std::string& filename,
+                                  const CompressedFormats& formats)
 {
   File::IOFile file;
   file.Open(filename, "rb");
@@ -442,7 +443,7 @@ bool HiresTexture::LoadDDSTexture(HiresTexture* tex, const std::string& filename
     return false;
 
   DDSLoadInfo info;
-  if (!ParseDDSHeader(file, &info))
+  if (!ParseDDSHeader(file, &info, formats))
     return false;
 
   // Read first mip level, as it may have a custom pitch.
@@ -481,7 +482,8 @@ bool HiresTexture::LoadDDSTexture(HiresTexture* tex, const std::string& filename
   return true;
 }
 
-bool HiresTexture::LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level)
+bool HiresTexture::LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level,
+                                  const CompressedFormats& formats)
 {
   // Only loading a single mip level.
   File::IOFile file;
@@ -490,7 +492,7 @@ bool HiresTexture::LoadDDSTexture(Level& level, const std::string& filename, u32
     return false;
 
   DDSLoadInfo info;
-  if (!ParseDDSHeader(file, &info))
+  if (!ParseDDSHeader(file, &info, formats))
     return false;
 
   return ReadMipLevel(&level, file, filename, mip_level, info, info.width, info.height,
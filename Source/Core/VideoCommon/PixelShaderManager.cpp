@@ -185,6 +185,9 @@ void PixelShaderManager::SetConstants()
 void PixelShaderManager::SetTevColor(int index, int component, s32 value)
 {
   auto& c = constants.colors[index];
+  if (c[component] == value)
+    return;
+
   c[component] = value;
   dirty = true;
 
@@ -194,6 +197,9 @@ void PixelShaderManager::SetTevColor(int index, int component, s32 value)
 void PixelShaderManager::SetTevKonstColor(int index, int component, s32 value)
 {
   auto& c = constants.kcolors[index];
+  if (c[component] == value)
+    return;
+
   c[component] = value;
   dirty = true;
 
@@ -245,9 +251,15 @@ void PixelShaderManager::SetTevIndirectChanged()
 
 void PixelShaderManager::SetAlpha()
 {
-  constants.alpha[0] = bpmem.alpha_test.ref0;
-  constants.alpha[1] = bpmem.alpha_test.ref1;
-  constants.alpha[3] = static_cast<s32>(bpmem.dstalpha.alpha);
+  const s32 ref0 = bpmem.alpha_test.ref0;
+  const s32 ref1 = bpmem.alpha_test.ref1;
+  const s32 dst_alpha = static_cast<s32>(bpmem.dstalpha.alpha);
+  if (constants.alpha[0] == ref0 && constants.alpha[1] == ref1 && constants.alpha[3] == dst_alpha)
+    return;
+
+  constants.alpha[0] = ref0;
+  constants.alpha[1] = ref1;
+  constants.alpha[3] = dst_alpha;
   dirty = true;
 }
 
@@ -293,6 +305,9 @@ void PixelShaderManager::SetSamplerState(int texmapid, u32 tm0, u32 tm1)
 
 void PixelShaderManager::SetZTextureBias()
 {
+  if (constants.zbias[1][3] == static_cast<s32>(bpmem.ztex1.bias))
+    return;
+
   constants.zbias[1][3] = bpmem.ztex1.bias;
   dirty = true;
 }
@@ -313,6 +328,10 @@ void PixelShaderManager::SetEfbScaleChanged(float scalex, float scaley)
 
 void PixelShaderManager::SetZSlope(float dfdx, float dfdy, float f0)
 {
+  // Called for every flush while zfreeze is enabled, usually with the same slope.
+  if (constants.zslope[0] == dfdx && constants.zslope[1] == dfdy && constants.zslope[2] == f0)
+    return;
+
   constants.zslope[0] = dfdx;
   constants.zslope[1] = dfdy;
   constants.zslope[2] = f0;
@@ -388,8 +407,13 @@ void PixelShaderManager::SetZTextureOpChanged()
 void PixelShaderManager::SetTexCoordChanged(u8 texmapid)
 {
   TCoordInfo& tc = bpmem.texcoords[texmapid];
-  constants.texdims[texmapid][2] = tc.s.scale_minus_1 + 1;
-  constants.texdims[texmapid][3] = tc.t.scale_minus_1 + 1;
+  const u32 s_scale = tc.s.scale_minus_1 + 1;
+  const u32 t_scale = tc.t.scale_minus_1 + 1;
+  if (constants.texdims[texmapid][2] == s_scale && constants.texdims[texmapid][3] == t_scale)
+    return;
+
+  constants.texdims[texmapid][2] = s_scale;
+  constants.texdims[texmapid][3] = t_scale;
   dirty = true;
 }
 
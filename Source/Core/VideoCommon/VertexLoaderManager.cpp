@@ -30,6 +30,7 @@
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace VertexLoaderManager
 {
@@ -253,6 +254,11 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
+  // When fast-forwarding, nothing that is drawn can be observed, so the vertices only need to be
+  // skipped. With nothing queued for drawing, flushes will not load any textures either.
+  if (g_ActiveConfig.UseFastForward())
+    return size;
+
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
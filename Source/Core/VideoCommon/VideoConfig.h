@@ -158,6 +158,9 @@ struct VideoConfig final
   bool bDumpTevStages = false;
   bool bDumpTevTextureFetches = false;
 
+  // Null backend: only emulate the parts of the GPU the CPU can observe
+  bool bNullFastForward = false;
+
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer = false;
 
@@ -233,6 +236,7 @@ struct VideoConfig final
     bool bSupportsPipelineCacheData = false;
     bool bSupportsCoarseDerivatives = false;
     bool bSupportsTextureQueryLevels = false;
+    bool bSupportsFastForward = false;  // Backend never displays anything it draws
   } backend_info;
 
   // Utility
@@ -246,6 +250,7 @@ struct VideoConfig final
     return backend_info.bSupportsGPUTextureDecoding && bEnableGPUTextureDecoding;
   }
   bool UseVertexRounding() const { return bVertexRounding && iEFBScale != 1; }
+  bool UseFastForward() const { return backend_info.bSupportsFastForward && bNullFastForward; }
   bool ManualTextureSamplingWithHiResTextures() const
   {
     // Hi-res textures (including hi-res EFB copies, but not native-resolution EFB copies at higher
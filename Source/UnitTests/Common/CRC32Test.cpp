@@ -0,0 +1,59 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "Common/CRC32.h"
+
+static u32 ZlibCRC32(u32 crc, const u8* data, size_t size)
+{
+  return static_cast<u32>(crc32(crc, data, static_cast<uInt>(size)));
+}
+
+TEST(CRC32, TestVectors)
+{
+  EXPECT_EQ(Common::ComputeCRC32(""), 0x00000000u);
+  EXPECT_EQ(Common::ComputeCRC32("123456789"), 0xcbf43926u);
+  EXPECT_EQ(Common::ComputeCRC32("The quick brown fox jumps over the lazy dog"), 0x414fa339u);
+}
+
+// The SIMD paths handle the data in blocks, so check many sizes and alignments against zlib
+TEST(CRC32, MatchesZlib)
+{
+  std::mt19937 rng(0x12345678);
+  std::vector<u8> data(0x3000);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+
+  for (size_t offset = 0; offset < 16; ++offset)
+  {
+    for (size_t size = 0; offset + size <= data.size(); size += 13)
+    {
+      EXPECT_EQ(Common::UpdateCRC32(0x89abcdef, data.data() + offset, size),
+                ZlibCRC32(0x89abcdef, data.data() + offset, size))
+          << "offset " << offset << ", size " << size;
+    }
+  }
+}
+
+TEST(CRC32, Incremental)
+{
+  std::vector<u8> data(0x10000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<u8>(i * 7 + (i >> 8));
+
+  const u32 expected = ZlibCRC32(0, data.data(), data.size());
+
+  for (size_t part_size : {1, 15, 64, 100, 4096})
+  {
+    u32 crc = 0;
+    for (size_t i = 0; i < data.size(); i += part_size)
+      crc = Common::UpdateCRC32(crc, data.data() + i, std::min(part_size, data.size() - i));
+    EXPECT_EQ(crc, expected) << "part size " << part_size;
+  }
+}
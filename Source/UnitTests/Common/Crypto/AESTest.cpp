@@ -0,0 +1,130 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mbedtls/aes.h>
+
+#include "Common/Crypto/AES.h"
+
+// CBC-AES128 test vectors from NIST SP 800-38A, F.2.1 and F.2.2.
+constexpr std::array<u8, 16> KEY{{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15,
+                                  0x88, 0x09, 0xcf, 0x4f, 0x3c}};
+constexpr std::array<u8, 16> IV{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+                                 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr std::array<u8, 64> PLAINTEXT{
+    {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73,
+     0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7,
+     0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4,
+     0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 0xf6, 0x9f, 0x24, 0x45,
+     0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}};
+constexpr std::array<u8, 64> CIPHERTEXT{
+    {0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12,
+     0xe9, 0x19, 0x7d, 0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb,
+     0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2, 0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74,
+     0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16, 0x3f, 0xf1, 0xca, 0xa1,
+     0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7}};
+
+static std::vector<u8> RandomData(size_t size)
+{
+  std::mt19937 rng(size);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+  return data;
+}
+
+TEST(AES, EncryptTestVector)
+{
+  std::array<u8, 64> out;
+  std::array<u8, 16> iv_out;
+  EXPECT_TRUE(Common::AES::CreateContextEncrypt(KEY.data())
+                  ->Crypt(IV.data(), iv_out.data(), PLAINTEXT.data(), out.data(), out.size()));
+  EXPECT_EQ(out, CIPHERTEXT);
+  EXPECT_TRUE(std::equal(iv_out.begin(), iv_out.end(), CIPHERTEXT.end() - 16));
+}
+
+TEST(AES, DecryptTestVector)
+{
+  std::array<u8, 64> out;
+  std::array<u8, 16> iv_out;
+  EXPECT_TRUE(Common::AES::CreateContextDecrypt(KEY.data())
+                  ->Crypt(IV.data(), iv_out.data(), CIPHERTEXT.data(), out.data(), out.size()));
+  EXPECT_EQ(out, PLAINTEXT);
+  EXPECT_TRUE(std::equal(iv_out.begin(), iv_out.end(), CIPHERTEXT.end() - 16));
+}
+
+TEST(AES, RejectsPartialBlocks)
+{
+  std::array<u8, 64> out;
+  EXPECT_FALSE(
+      Common::AES::CreateContextDecrypt(KEY.data())->CryptIvZero(CIPHERTEXT.data(), out.data(), 15));
+}
+
+// Wii disc clusters are decrypted in place in 0x7c00-byte chunks, which is not a multiple of the
+// number of blocks the hardware implementations decrypt at once.
+TEST(AES, MatchesMbedtlsInPlace)
+{
+  const std::vector<u8> plaintext = RandomData(0x7c00 + 16 * 3);
+
+  mbedtls_aes_context ctx;
+  mbedtls_aes_init(&ctx);
+  mbedtls_aes_setkey_enc(&ctx, KEY.data(), 128);
+  std::array<u8, 16> iv = IV;
+  std::vector<u8> expected(plaintext.size());
+  mbedtls_aes_crypt_cbc(&ctx, MBEDTLS_AES_ENCRYPT, plaintext.size(), iv.data(), plaintext.data(),
+                        expected.data());
+  mbedtls_aes_free(&ctx);
+
+  std::vector<u8> data = plaintext;
+  EXPECT_TRUE(Common::AES::CreateContextEncrypt(KEY.data())
+                  ->Crypt(IV.data(), data.data(), data.data(), data.size()));
+  EXPECT_EQ(data, expected);
+
+  EXPECT_TRUE(Common::AES::CreateContextDecrypt(KEY.data())
+                  ->Crypt(IV.data(), data.data(), data.data(), data.size()));
+  EXPECT_EQ(data, plaintext);
+}
+
+TEST(AES, ChainsAcrossCalls)
+{
+  const std::unique_ptr<Common::AES::Context> context =
+      Common::AES::CreateContextDecrypt(KEY.data());
+  std::array<u8, 64> out;
+  std::array<u8, 16> iv = IV;
+  for (size_t i = 0; i < out.size(); i += 16)
+    EXPECT_TRUE(context->Crypt(iv.data(), iv.data(), CIPHERTEXT.data() + i, out.data() + i, 16));
+  EXPECT_EQ(out, PLAINTEXT);
+}
+
+TEST(AES, Throughput)
+{
+  constexpr size_t SIZE = 16 * 1024 * 1024;
+  std::vector<u8> data = RandomData(SIZE);
+
+  const auto measure = [&](const char* name, auto function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.1f MB/s\n", name, SIZE / seconds / (1024 * 1024));
+  };
+
+  const std::unique_ptr<Common::AES::Context> context =
+      Common::AES::CreateContextDecrypt(KEY.data());
+  measure("Context decrypt", [&] { context->CryptIvZero(data.data(), data.data(), SIZE); });
+
+  mbedtls_aes_context ctx;
+  mbedtls_aes_init(&ctx);
+  mbedtls_aes_setkey_dec(&ctx, KEY.data(), 128);
+  std::array<u8, 16> iv{};
+  measure("mbedtls decrypt", [&] {
+    mbedtls_aes_crypt_cbc(&ctx, MBEDTLS_AES_DECRYPT, SIZE, iv.data(), data.data(), data.data());
+  });
+  mbedtls_aes_free(&ctx);
+}
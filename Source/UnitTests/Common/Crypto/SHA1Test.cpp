@@ -0,0 +1,85 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mbedtls/sha1.h>
+
+#include "Common/Crypto/SHA1.h"
+
+static Common::SHA1::Digest MbedtlsDigest(const std::vector<u8>& data)
+{
+  Common::SHA1::Digest digest;
+  mbedtls_sha1_ret(data.data(), data.size(), digest.data());
+  return digest;
+}
+
+static std::string ToHex(const Common::SHA1::Digest& digest)
+{
+  std::string result;
+  for (u8 byte : digest)
+  {
+    static constexpr char HEX[] = "0123456789abcdef";
+    result += HEX[byte >> 4];
+    result += HEX[byte & 0xf];
+  }
+  return result;
+}
+
+TEST(SHA1, TestVectors)
+{
+  EXPECT_EQ(ToHex(Common::SHA1::CalculateDigest("")), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+  EXPECT_EQ(ToHex(Common::SHA1::CalculateDigest("abc")),
+            "a9993e364706816aba3e25717850c26c9cd0d89d");
+  EXPECT_EQ(ToHex(Common::SHA1::CalculateDigest(
+                "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+            "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+  EXPECT_EQ(ToHex(Common::SHA1::CalculateDigest(std::string(1000000, 'a'))),
+            "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+}
+
+// Covers every padding case, and messages fed in pieces which don't line up with blocks.
+TEST(SHA1, MatchesMbedtls)
+{
+  std::mt19937 rng(0);
+  for (size_t size = 0; size < 300; size++)
+  {
+    std::vector<u8> data(size);
+    for (u8& byte : data)
+      byte = static_cast<u8>(rng());
+
+    const Common::SHA1::Digest expected = MbedtlsDigest(data);
+    EXPECT_EQ(Common::SHA1::CalculateDigest(data), expected);
+
+    const std::unique_ptr<Common::SHA1::Context> context = Common::SHA1::CreateContext();
+    for (size_t offset = 0; offset < size;)
+    {
+      const size_t piece = std::min<size_t>(size - offset, rng() % 100);
+      context->Update(data.data() + offset, piece);
+      offset += piece;
+    }
+    EXPECT_EQ(context->Finish(), expected);
+  }
+}
+
+TEST(SHA1, Throughput)
+{
+  constexpr size_t SIZE = 16 * 1024 * 1024;
+  const std::vector<u8> data(SIZE, 0x5a);
+
+  const auto measure = [&](const char* name, auto function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.1f MB/s\n", name, SIZE / seconds / (1024 * 1024));
+  };
+
+  measure("Context", [&] { Common::SHA1::CalculateDigest(data); });
+  measure("mbedtls", [&] { MbedtlsDigest(data); });
+}
@@ -0,0 +1,272 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+#include "Core/HW/DSPHLE/UCodes/AXSamples.h"
+#include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+
+namespace AX = DSP::HLE::AX;
+using DSP::HLE::SRCTYPE_LINEAR;
+using DSP::HLE::SRCTYPE_NEAREST;
+using DSP::HLE::SRCTYPE_POLYPHASE;
+
+namespace
+{
+// The per-sample versions of the sample processing functions, which read every input sample
+// through a callback and keep the history in a circular buffer, to check the batched ones against.
+u32 ReferenceResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count,
+                           s16* last_samples, u32 curr_pos, u32 ratio, int srctype,
+                           const s16* coeffs)
+{
+  int read_samples_count = 0;
+
+  if (coeffs && srctype == SRCTYPE_POLYPHASE)
+  {
+    s16 temp[4];
+    u32 idx = 0;
+
+    temp[idx++ & 3] = last_samples[0];
+    temp[idx++ & 3] = last_samples[1];
+    temp[idx++ & 3] = last_samples[2];
+    temp[idx++ & 3] = last_samples[3];
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      curr_pos += ratio;
+      while (curr_pos >= 0x10000)
+      {
+        temp[idx++ & 3] = input_callback(read_samples_count++);
+        curr_pos -= 0x10000;
+      }
+
+      u16 curr_pos_frac = ((curr_pos & 0xFFFF) >> 9) << 2;
+      const s16* c = &coeffs[curr_pos_frac];
+
+      s64 t0 = temp[idx++ & 3];
+      s64 t1 = temp[idx++ & 3];
+      s64 t2 = temp[idx++ & 3];
+      s64 t3 = temp[idx++ & 3];
+
+      s64 samp = (t0 * c[0] + t1 * c[1] + t2 * c[2] + t3 * c[3]) >> 15;
+
+      output[i] = MathUtil::SaturatingCast<s16>(samp);
+    }
+
+    last_samples[3] = temp[--idx & 3];
+    last_samples[2] = temp[--idx & 3];
+    last_samples[1] = temp[--idx & 3];
+    last_samples[0] = temp[--idx & 3];
+  }
+  else if (srctype == SRCTYPE_LINEAR || srctype == SRCTYPE_POLYPHASE)
+  {
+    s16 temp[4];
+    u32 idx = 0;
+
+    temp[idx++ & 3] = last_samples[0];
+    temp[idx++ & 3] = last_samples[1];
+    temp[idx++ & 3] = last_samples[2];
+    temp[idx++ & 3] = last_samples[3];
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      curr_pos += ratio;
+      while (curr_pos >= 0x10000)
+      {
+        temp[idx++ & 3] = input_callback(read_samples_count++);
+        curr_pos -= 0x10000;
+      }
+
+      u16 curr_frac = curr_pos & 0xFFFF;
+      u16 inv_curr_frac = -curr_frac;
+
+      s16 sample;
+      if (curr_frac)
+      {
+        s32 s0 = temp[idx++ & 3];
+        s32 s1 = temp[idx++ & 3];
+
+        sample = ((s0 * inv_curr_frac) + (s1 * curr_frac)) >> 16;
+        idx += 2;
+      }
+      else
+      {
+        sample = temp[idx++ & 3];
+        idx += 3;
+      }
+
+      output[i] = sample;
+    }
+
+    last_samples[3] = temp[--idx & 3];
+    last_samples[2] = temp[--idx & 3];
+    last_samples[1] = temp[--idx & 3];
+    last_samples[0] = temp[--idx & 3];
+  }
+  else  // SRCTYPE_NEAREST
+  {
+    for (u32 i = 0; i < count; ++i)
+      output[i] = input_callback(i);
+
+    std::memcpy(last_samples, output + count - 4, 4 * sizeof(u16));
+  }
+
+  return curr_pos;
+}
+
+u16 ReferenceApplyVolumeRamp(const s16* input, s16* output, u32 count, u16 volume,
+                             u16 volume_delta)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    output[i] = std::clamp((s32)input[i] * volume >> 15, -32767, 32767);
+    volume += volume_delta;
+  }
+  return volume;
+}
+
+// Random samples, with runs of the extreme values mixed in since they are where the filters could
+// overflow.
+class SampleGenerator
+{
+public:
+  explicit SampleGenerator(u32 seed) : m_rng(seed) {}
+
+  s16 Sample()
+  {
+    switch (m_rng() % 4)
+    {
+    case 0:
+      return -0x8000;
+    case 1:
+      return 0x7FFF;
+    default:
+      return static_cast<s16>(m_rng());
+    }
+  }
+
+  s16 Next(bool extreme) { return extreme ? Sample() : static_cast<s16>(m_rng()); }
+
+  u32 Random() { return m_rng(); }
+
+private:
+  std::mt19937 m_rng;
+};
+
+// The frame sizes of AX GC and AX Wii, and counts which aren't a multiple of the vector width
+constexpr std::array<u32, 7> COUNTS = {4, 7, 8, 18, 32, 0x53, 96};
+
+u32 RandomRatio(SampleGenerator& generator, int i)
+{
+  switch (i % 8)
+  {
+  case 0:
+    // Ratios whose input doesn't fit in one batch, including ones which overflow the position
+    return i % 16 == 0 ? 0xFFFFFFFF : 0x1000000 + generator.Random() % 0x1000000;
+  case 1:
+    return 0x10000;
+  default:
+    // Games mostly resample by less than 4:1
+    return generator.Random() % 0x40000;
+  }
+}
+}  // namespace
+
+TEST(AXSamples, ResampleAudioMatchesReference)
+{
+  SampleGenerator generator(1);
+  for (int srctype : {SRCTYPE_POLYPHASE, SRCTYPE_LINEAR, SRCTYPE_NEAREST})
+  {
+    for (u32 count : COUNTS)
+    {
+      for (int i = 0; i < 64; ++i)
+      {
+        const bool extreme = i % 2 != 0;
+        std::array<s16, 0x200> coeffs;
+        for (s16& coeff : coeffs)
+          coeff = generator.Next(extreme);
+
+        std::array<s16, 4> expected_last_samples;
+        for (s16& sample : expected_last_samples)
+          sample = generator.Next(extreme);
+        std::array<s16, 4> actual_last_samples = expected_last_samples;
+
+        const u32 ratio = RandomRatio(generator, i);
+        const u32 pos = generator.Random() % 0x10000;
+
+        // Both read the same stream of input samples
+        const u32 seed = generator.Random();
+        SampleGenerator expected_input(seed);
+        SampleGenerator actual_input(seed);
+        u32 expected_read_count = 0;
+        u32 actual_read_count = 0;
+
+        std::vector<s16> expected(count);
+        std::vector<s16> actual(count);
+        const u32 expected_pos = ReferenceResampleAudio(
+            [&](u32) {
+              ++expected_read_count;
+              return expected_input.Next(extreme);
+            },
+            expected.data(), count, expected_last_samples.data(), pos, ratio, srctype,
+            coeffs.data());
+        const u32 actual_pos = AX::ResampleAudio(
+            [&](s16* samples, u32 n) {
+              actual_read_count += n;
+              for (u32 j = 0; j < n; ++j)
+                samples[j] = actual_input.Next(extreme);
+            },
+            actual.data(), count, actual_last_samples.data(), pos, ratio, srctype, coeffs.data());
+
+        ASSERT_EQ(expected, actual) << "srctype " << srctype << " count " << count << " ratio "
+                                    << ratio << " test " << i;
+        ASSERT_EQ(expected_pos & 0xFFFF, actual_pos);
+        ASSERT_EQ(expected_last_samples, actual_last_samples);
+        ASSERT_EQ(expected_read_count, actual_read_count);
+      }
+    }
+  }
+}
+
+TEST(AXSamples, ApplyVolumeRampMatchesReference)
+{
+  SampleGenerator generator(2);
+  for (u32 count : COUNTS)
+  {
+    for (int i = 0; i < 200; ++i)
+    {
+      const bool extreme = i % 2 != 0;
+      std::vector<s16> input(count);
+      for (s16& sample : input)
+        sample = generator.Next(extreme);
+
+      const u16 volume =
+          i < 2 ? static_cast<u16>(0xFFFF * i) : static_cast<u16>(generator.Random());
+      const u16 volume_delta = i < 4 ? 0 : static_cast<u16>(generator.Random());
+
+      std::vector<s16> expected(count);
+      std::vector<s16> actual(count);
+      const u16 expected_volume =
+          ReferenceApplyVolumeRamp(input.data(), expected.data(), count, volume, volume_delta);
+      const u16 actual_volume =
+          AX::ApplyVolumeRamp(input.data(), actual.data(), count, volume, volume_delta);
+      ASSERT_EQ(expected, actual) << "count " << count << " volume " << volume << " delta "
+                                  << volume_delta;
+      ASSERT_EQ(expected_volume, actual_volume);
+
+      // In place, as used for the envelope
+      std::vector<s16> in_place = input;
+      AX::ApplyVolumeRamp(in_place.data(), in_place.data(), count, volume, volume_delta);
+      ASSERT_EQ(expected, in_place);
+    }
+  }
+}
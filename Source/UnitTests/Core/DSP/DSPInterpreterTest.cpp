@@ -0,0 +1,60 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+
+#include "DSPTestHelpers.h"
+
+static std::vector<u16> AssembleOrFail(const char* text)
+{
+  std::vector<u16> code;
+  EXPECT_TRUE(DSP::Assemble(text, code));
+  return code;
+}
+
+class DSPInterpreterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    InitDSPTest();
+
+    DSP::DSPInitOptions opts;
+    opts.core_type = DSP::DSPInitOptions::CoreType::Interpreter;
+    ASSERT_TRUE(m_core.Initialize(opts));
+  }
+
+  void TearDown() override { m_core.Shutdown(); }
+
+  DSP::DSPCore m_core;
+};
+
+TEST_F(DSPInterpreterTest, NewCodeRunsAfterClearingIRAM)
+{
+  LoadIRAM(m_core, AssembleOrFail(R"(
+  LRI $AC0.M, #0x1111
+  SR @0x0100, $AC0.M
+  HALT
+)"));
+  m_core.Reset();
+  StartAtZero(m_core);
+  RunUntilHalted(m_core, 1000);
+  EXPECT_EQ(m_core.DSPState().dram[0x0100], 0x1111);
+
+  // What a DMA to IRAM does, minus the host side.
+  LoadIRAM(m_core, AssembleOrFail(R"(
+  LRI $AC0.M, #0x2222
+  SR @0x0100, $AC0.M
+  HALT
+)"));
+  m_core.ClearIRAM();
+  StartAtZero(m_core);
+  RunUntilHalted(m_core, 1000);
+  EXPECT_EQ(m_core.DSPState().dram[0x0100], 0x2222);
+}
@@ -0,0 +1,103 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+
+#include "DSPTestHelpers.h"
+
+// Loops which the JIT links back to the start of their block instead of going through the
+// dispatcher: a BLOOPI with a nested LOOPI, and a loop made of a conditional exit and a JMP.
+static const char* s_loop_code = R"(
+  LRI $AR0, #0x0100
+  LRI $AX0.L, #3
+  LRI $AX1.L, #0x10
+  CLR $ACC0
+  CLR $ACC1
+
+  BLOOPI #100, bloop_end
+    ADDIS $AC0.M, #1
+    LOOPI #4
+      ADDAX $ACC1, $AX0
+bloop_end:
+    SRRI @$AR0, $AC0.M
+
+  CLR $ACC0
+  LRI $AC0.M, #40
+jmp_loop:
+  DECM $AC0.M
+  JZ jmp_done
+  ADDAX $ACC1, $AX1
+  SRRI @$AR0, $AC1.L
+  JMP jmp_loop
+jmp_done:
+  HALT
+)";
+
+static void RunProgram(DSP::DSPCore& core, DSP::DSPInitOptions::CoreType core_type,
+                       const std::vector<u16>& code, int cycles_per_slice)
+{
+  DSP::DSPInitOptions opts;
+  opts.core_type = core_type;
+  ASSERT_TRUE(core.Initialize(opts));
+
+  LoadIRAM(core, code);
+  core.Reset();
+  StartAtZero(core);
+  RunUntilHalted(core, cycles_per_slice);
+}
+
+static void ExpectSameResults(int cycles_per_slice)
+{
+  std::vector<u16> code;
+  ASSERT_TRUE(DSP::Assemble(s_loop_code, code));
+
+  InitDSPTest();
+
+  DSP::DSPCore interpreter;
+  DSP::DSPCore jit;
+  RunProgram(interpreter, DSP::DSPInitOptions::CoreType::Interpreter, code, cycles_per_slice);
+  RunProgram(jit, DSP::DSPInitOptions::CoreType::JIT64, code, cycles_per_slice);
+
+  const auto& expected = interpreter.DSPState();
+  const auto& actual = jit.DSPState();
+
+  // The interpreter and the JIT don't leave HALT the same way, so the PC and the stacks aren't
+  // compared.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(expected.r.ar[i], actual.r.ar[i]);
+    EXPECT_EQ(expected.r.ix[i], actual.r.ix[i]);
+  }
+  for (size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(expected.r.ax[i].val, actual.r.ax[i].val);
+    EXPECT_EQ(expected.r.ac[i].val, actual.r.ac[i].val);
+  }
+  EXPECT_EQ(expected.r.sr, actual.r.sr);
+  EXPECT_TRUE(std::equal(expected.dram, expected.dram + DSP::DSP_DRAM_SIZE, actual.dram));
+
+  // Sanity check that the program ran all the loops.
+  EXPECT_EQ(expected.r.ar[0], 0x0100 + 100 + 39);
+  EXPECT_EQ(expected.dram[0x0100 + 99], 100);
+
+  interpreter.Shutdown();
+  jit.Shutdown();
+}
+
+TEST(DSPJit, LoopsMatchInterpreter)
+{
+  ExpectSameResults(1000);
+}
+
+TEST(DSPJit, LoopsMatchInterpreterWithShortTimeslices)
+{
+  // Makes linked blocks run out of cycles in the middle of the loops.
+  ExpectSameResults(7);
+}
@@ -0,0 +1,48 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DSPTestHelpers.h"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "Common/MemoryUtil.h"
+#include "Common/MsgHandler.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPTables.h"
+
+static bool DeclineQuestions(const char*, const char*, bool, Common::MsgType)
+{
+  return false;
+}
+
+void InitDSPTest()
+{
+  Common::RegisterMsgAlertHandler(DeclineQuestions);
+  DSP::InitInstructionTable();
+}
+
+void LoadIRAM(DSP::DSPCore& core, const std::vector<u16>& code)
+{
+  auto& state = core.DSPState();
+  Common::UnWriteProtectMemory(state.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  std::fill(state.iram, state.iram + DSP::DSP_IRAM_SIZE, 0x0021);
+  std::copy(code.begin(), code.end(), state.iram);
+  Common::WriteProtectMemory(state.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+}
+
+void StartAtZero(DSP::DSPCore& core)
+{
+  auto& state = core.DSPState();
+  state.pc = 0;
+  state.cr &= ~DSP::CR_HALT;
+}
+
+void RunUntilHalted(DSP::DSPCore& core, int cycles_per_slice)
+{
+  auto& state = core.DSPState();
+  for (int i = 0; i < 100000 && (state.cr & DSP::CR_HALT) == 0; ++i)
+    core.RunCycles(cycles_per_slice);
+  EXPECT_NE(state.cr & DSP::CR_HALT, 0);
+}
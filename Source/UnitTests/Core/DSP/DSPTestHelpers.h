@@ -0,0 +1,26 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DSP
+{
+class DSPCore;
+}
+
+// Sets up what running DSP code needs in a test: the instruction tables, and a message handler
+// which carries on without real DSP ROMs rather than stopping.
+void InitDSPTest();
+
+// Replaces IRAM with the given code, filling the rest of it with HALT.
+void LoadIRAM(DSP::DSPCore& core, const std::vector<u16>& code);
+
+// Starts running IRAM from its first instruction.
+void StartAtZero(DSP::DSPCore& core);
+
+// Runs the core in slices of the given number of cycles until it halts, and expects it to.
+void RunUntilHalted(DSP::DSPCore& core, int cycles_per_slice);
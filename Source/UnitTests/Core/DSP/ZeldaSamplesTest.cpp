@@ -0,0 +1,308 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/DSPHLE/UCodes/ZeldaSamples.h"
+
+namespace Zelda = DSP::HLE::Zelda;
+
+namespace
+{
+// Straightforward per-sample versions of the sample processing functions, to check the vectorized
+// ones against.
+void ReferenceApplyVolumeInPlace(s16* buf, size_t count, u16 vol, int shift)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    s32 tmp = (u32)buf[i] * (u32)vol;
+    tmp >>= shift;
+
+    buf[i] = (s16)std::clamp(tmp, -0x8000, 0x7FFF);
+  }
+}
+
+s32 ReferenceAddBuffersWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol, s32 step)
+{
+  if (!vol && !step)
+    return vol;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    dst[i] += ((vol >> 16) * src[i]) >> 16;
+    vol += step;
+  }
+  return vol;
+}
+
+void ReferenceAddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    s32 vol_src = ((s32)src[i] * (s32)vol) >> 15;
+    dst[i] += std::clamp(vol_src, -0x8000, 0x7FFF);
+  }
+}
+
+u32 ReferenceResampleInterpolated(s16* dst, size_t count, const s16* src, u32 pos, u32 ratio,
+                                  const std::array<s16, 0x100>& coeffs)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const s16* sample_coeffs = &coeffs[((pos & 0xFFF) >> 6) * 4];
+    const s16* input = &src[pos >> 12];
+
+    s64 dst_sample_unclamped = 0;
+    for (size_t j = 0; j < 4; ++j)
+      dst_sample_unclamped += (s64)2 * sample_coeffs[j] * input[j];
+    dst_sample_unclamped >>= 16;
+
+    dst[i] = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
+
+    pos += ratio;
+  }
+  return pos;
+}
+
+void ReferenceDecodeAFCBlock(s16* dst, const u8* src, bool hq,
+                             const std::array<s16, 0x20>& coeffs, s16* yn1_ptr, s16* yn2_ptr)
+{
+  const s16 delta = 1 << ((*src >> 4) & 0xF);
+  const s16 idx = (*src & 0xF);
+  src++;
+
+  s16 nibbles[16];
+  if (hq)
+  {
+    for (size_t i = 0; i < 16; i += 2)
+    {
+      nibbles[i + 0] = *src >> 4;
+      nibbles[i + 1] = *src & 0xF;
+      src++;
+    }
+    for (auto& nibble : nibbles)
+    {
+      if (nibble >= 8)
+        nibble -= 16;
+      nibble <<= 11;
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < 16; i += 4)
+    {
+      nibbles[i + 0] = (*src >> 6) & 3;
+      nibbles[i + 1] = (*src >> 4) & 3;
+      nibbles[i + 2] = (*src >> 2) & 3;
+      nibbles[i + 3] = (*src >> 0) & 3;
+      src++;
+    }
+    for (auto& nibble : nibbles)
+    {
+      if (nibble >= 2)
+        nibble -= 4;
+      nibble <<= 13;
+    }
+  }
+
+  const s32 coef1 = coeffs[idx * 2];
+  const s32 coef2 = coeffs[idx * 2 + 1];
+  s32 yn1 = *yn1_ptr, yn2 = *yn2_ptr;
+  for (s16 nibble : nibbles)
+  {
+    s32 sample = delta * nibble + yn1 * coef1 + yn2 * coef2;
+    sample >>= 11;
+    sample = std::clamp(sample, -0x8000, 0x7fff);
+    *dst++ = (s16)sample;
+    yn2 = yn1;
+    yn1 = sample;
+  }
+  *yn2_ptr = yn2;
+  *yn1_ptr = yn1;
+}
+
+// Random samples, with runs of the extreme values mixed in since they are where the vectorized
+// code could overflow.
+class SampleGenerator
+{
+public:
+  explicit SampleGenerator(u32 seed) : m_rng(seed) {}
+
+  s16 Sample()
+  {
+    switch (m_rng() % 4)
+    {
+    case 0:
+      return -0x8000;
+    case 1:
+      return 0x7FFF;
+    default:
+      return static_cast<s16>(m_rng());
+    }
+  }
+
+  template <typename T>
+  void Fill(T* values, size_t count, bool extreme)
+  {
+    for (size_t i = 0; i < count; ++i)
+      values[i] = extreme ? static_cast<T>(Sample()) : static_cast<T>(m_rng());
+  }
+
+  u32 Random() { return m_rng(); }
+
+private:
+  std::mt19937 m_rng;
+};
+
+// Counts which aren't a multiple of the vector width, to cover the scalar tails
+constexpr std::array<size_t, 6> COUNTS = {0, 1, 7, 8, 0x50, 0x53};
+}  // namespace
+
+TEST(ZeldaSamples, ApplyVolumeInPlaceMatchesReference)
+{
+  SampleGenerator generator(1);
+  for (size_t count : COUNTS)
+  {
+    for (int i = 0; i < 200; ++i)
+    {
+      const bool extreme = i % 2 != 0;
+      std::vector<s16> expected(count);
+      generator.Fill(expected.data(), count, extreme);
+      std::vector<s16> actual = expected;
+
+      const u16 vol = i < 2 ? static_cast<u16>(0xFFFF * i) : static_cast<u16>(generator.Random());
+      const int shift = i % 2 == 0 ? 15 : 12;
+      ReferenceApplyVolumeInPlace(expected.data(), count, vol, shift);
+      Zelda::ApplyVolumeInPlace(actual.data(), count, vol, shift);
+      ASSERT_EQ(expected, actual) << "count " << count << " volume " << vol;
+    }
+  }
+}
+
+TEST(ZeldaSamples, AddBuffersWithVolumeMatchesReference)
+{
+  SampleGenerator generator(2);
+  for (size_t count : COUNTS)
+  {
+    for (int i = 0; i < 200; ++i)
+    {
+      const bool extreme = i % 2 != 0;
+      std::vector<s16> src(count);
+      std::vector<s16> expected(count);
+      generator.Fill(src.data(), count, extreme);
+      generator.Fill(expected.data(), count, extreme);
+      std::vector<s16> actual = expected;
+
+      const u16 vol = i < 2 ? static_cast<u16>(0xFFFF * i) : static_cast<u16>(generator.Random());
+      ReferenceAddBuffersWithVolume(expected.data(), src.data(), count, vol);
+      Zelda::AddBuffersWithVolume(actual.data(), src.data(), count, vol);
+      ASSERT_EQ(expected, actual) << "count " << count << " volume " << vol;
+    }
+  }
+}
+
+TEST(ZeldaSamples, AddBuffersWithVolumeRampMatchesReference)
+{
+  SampleGenerator generator(3);
+  for (size_t count : COUNTS)
+  {
+    for (int i = 0; i < 200; ++i)
+    {
+      const bool extreme = i % 2 != 0;
+      std::vector<s16> src(count);
+      std::vector<s16> expected(count);
+      generator.Fill(src.data(), count, extreme);
+      generator.Fill(expected.data(), count, extreme);
+      std::vector<s16> actual = expected;
+
+      // The renderer ramps from one 16-bit volume to another over a buffer
+      const s32 vol = static_cast<s16>(extreme ? generator.Sample() : generator.Random()) << 16;
+      const s32 target = static_cast<s16>(extreme ? generator.Sample() : generator.Random()) << 16;
+      const s32 step = count ? static_cast<s32>((s64{target} - vol) / s64(count)) : 0;
+
+      const s32 expected_vol =
+          ReferenceAddBuffersWithVolumeRamp(expected.data(), src.data(), count, vol, step);
+      const s32 actual_vol =
+          Zelda::AddBuffersWithVolumeRamp(actual.data(), src.data(), count, vol, step);
+      ASSERT_EQ(expected, actual) << "count " << count << " volume " << vol << " step " << step;
+      ASSERT_EQ(expected_vol, actual_vol);
+    }
+  }
+}
+
+TEST(ZeldaSamples, ResampleInterpolatedMatchesReference)
+{
+  SampleGenerator generator(4);
+  for (size_t count : COUNTS)
+  {
+    for (int i = 0; i < 400; ++i)
+    {
+      const bool extreme = i % 2 != 0;
+      std::array<s16, 0x100> coeffs;
+      generator.Fill(coeffs.data(), coeffs.size(), extreme);
+
+      // Interpolation is used for ratios below 4:1
+      const u32 ratio = i < 2 ? 0x3FFF : generator.Random() % 0x4000;
+      const u32 pos = generator.Random() % 0x1000;
+      std::vector<s16> src(((pos + count * ratio) >> 12) + 4);
+      if (i == 2)
+        std::fill(src.begin(), src.end(), -0x8000);
+      else
+        generator.Fill(src.data(), src.size(), extreme);
+      if (i == 2)
+        std::fill(coeffs.begin(), coeffs.end(), -0x8000);
+
+      std::vector<s16> expected(count);
+      std::vector<s16> actual(count);
+      const u32 expected_pos = ReferenceResampleInterpolated(expected.data(), count, src.data(),
+                                                             pos, ratio, coeffs);
+      const u32 actual_pos =
+          Zelda::ResampleInterpolated(actual.data(), count, src.data(), pos, ratio, coeffs);
+      ASSERT_EQ(expected, actual) << "count " << count << " ratio " << ratio << " test " << i;
+      ASSERT_EQ(expected_pos, actual_pos);
+    }
+  }
+}
+
+TEST(ZeldaSamples, DecodeAFCBlockMatchesReference)
+{
+  SampleGenerator generator(5);
+  for (bool hq : {false, true})
+  {
+    const size_t block_size = hq ? 9 : 5;
+    for (int i = 0; i < 4; ++i)
+    {
+      const bool extreme = i % 2 != 0;
+      std::array<s16, 0x20> coeffs;
+      generator.Fill(coeffs.data(), coeffs.size(), extreme);
+
+      // Cover every scale and coefficient index
+      constexpr size_t NUM_BLOCKS = 0x400;
+      std::vector<u8> blocks(NUM_BLOCKS * block_size);
+      generator.Fill(blocks.data(), blocks.size(), false);
+      for (size_t b = 0; b < NUM_BLOCKS; ++b)
+        blocks[b * block_size] = static_cast<u8>(b);
+
+      s16 expected_yn1 = 0, expected_yn2 = 0;
+      s16 actual_yn1 = 0, actual_yn2 = 0;
+      for (size_t b = 0; b < NUM_BLOCKS; ++b)
+      {
+        std::array<s16, 16> expected;
+        std::array<s16, 16> actual;
+        ReferenceDecodeAFCBlock(expected.data(), &blocks[b * block_size], hq, coeffs,
+                                &expected_yn1, &expected_yn2);
+        Zelda::DecodeAFCBlock(actual.data(), &blocks[b * block_size], hq, coeffs, &actual_yn1,
+                              &actual_yn2);
+        ASSERT_EQ(expected, actual) << (hq ? "HQ" : "LQ") << " block " << b;
+        ASSERT_EQ(expected_yn1, actual_yn1);
+        ASSERT_EQ(expected_yn2, actual_yn2);
+      }
+    }
+  }
+}
@@ -0,0 +1,122 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/StreamADPCM.h"
+
+namespace
+{
+// A straightforward per-sample decoder, to check the block decoder against.
+class ReferenceDecoder
+{
+public:
+  void DecodeBlock(s16* pcm, const u8* adpcm)
+  {
+    const u8* data = adpcm + (StreamADPCM::ONE_BLOCK_SIZE - StreamADPCM::SAMPLES_PER_BLOCK);
+    for (size_t i = 0; i < StreamADPCM::SAMPLES_PER_BLOCK; i++)
+    {
+      pcm[i * 2] = DecodeSample(data[i] & 0xf, adpcm[0], m_histl1, m_histl2);
+      pcm[i * 2 + 1] = DecodeSample(data[i] >> 4, adpcm[1], m_histr1, m_histr2);
+    }
+  }
+
+private:
+  static s16 DecodeSample(s32 bits, s32 q, s32& hist1, s32& hist2)
+  {
+    s32 hist = 0;
+    switch (q >> 4)
+    {
+    case 1:
+      hist = hist1 * 0x3c;
+      break;
+    case 2:
+      hist = hist1 * 0x73 - hist2 * 0x34;
+      break;
+    case 3:
+      hist = hist1 * 0x62 - hist2 * 0x37;
+      break;
+    }
+    hist = std::clamp((hist + 0x20) >> 6, -0x200000, 0x1fffff);
+
+    const s32 cur = ((static_cast<s16>(bits << 12) >> (q & 0xf)) << 6) + hist;
+
+    hist2 = hist1;
+    hist1 = cur;
+
+    return static_cast<s16>(std::clamp(cur >> 6, -0x8000, 0x7fff));
+  }
+
+  s32 m_histl1 = 0;
+  s32 m_histl2 = 0;
+  s32 m_histr1 = 0;
+  s32 m_histr2 = 0;
+};
+
+std::vector<u8> GenerateBlocks(size_t num_blocks, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> byte(0, 0xff);
+
+  std::vector<u8> adpcm(num_blocks * StreamADPCM::ONE_BLOCK_SIZE);
+  for (size_t i = 0; i < num_blocks; i++)
+  {
+    u8* block = &adpcm[i * StreamADPCM::ONE_BLOCK_SIZE];
+    // Cover every combination of filter and shift, including the unused filters
+    block[0] = static_cast<u8>(i);
+    block[1] = static_cast<u8>(~i);
+    block[2] = block[0];
+    block[3] = block[1];
+    for (size_t j = 4; j < StreamADPCM::ONE_BLOCK_SIZE; j++)
+      block[j] = static_cast<u8>(byte(rng));
+  }
+  return adpcm;
+}
+}  // namespace
+
+TEST(StreamADPCM, DecodeBlockMatchesReference)
+{
+  constexpr size_t NUM_BLOCKS = 0x400;
+  const std::vector<u8> adpcm = GenerateBlocks(NUM_BLOCKS, 1);
+
+  ReferenceDecoder reference;
+  StreamADPCM::ADPCMDecoder decoder;
+  std::array<s16, StreamADPCM::SAMPLES_PER_BLOCK * 2> expected;
+  std::array<s16, StreamADPCM::SAMPLES_PER_BLOCK * 2> actual;
+  for (size_t i = 0; i < NUM_BLOCKS; i++)
+  {
+    const u8* block = &adpcm[i * StreamADPCM::ONE_BLOCK_SIZE];
+    reference.DecodeBlock(expected.data(), block);
+    decoder.DecodeBlock(actual.data(), block);
+    ASSERT_EQ(expected, actual) << "block " << i;
+  }
+}
+
+TEST(StreamADPCM, DecodeBlocksMatchesDecodeBlock)
+{
+  constexpr size_t NUM_BLOCKS = 0x100;
+  const std::vector<u8> adpcm = GenerateBlocks(NUM_BLOCKS, 2);
+
+  StreamADPCM::ADPCMDecoder single;
+  std::vector<s16> expected(NUM_BLOCKS * StreamADPCM::SAMPLES_PER_BLOCK * 2);
+  for (size_t i = 0; i < NUM_BLOCKS; i++)
+  {
+    single.DecodeBlock(&expected[i * StreamADPCM::SAMPLES_PER_BLOCK * 2],
+                       &adpcm[i * StreamADPCM::ONE_BLOCK_SIZE]);
+  }
+
+  StreamADPCM::ADPCMDecoder batched;
+  std::vector<s16> actual(expected.size());
+  // Split the stream unevenly to check that the filter state carries over between calls
+  batched.DecodeBlocks(actual.data(), adpcm.data(), 3);
+  batched.DecodeBlocks(&actual[3 * StreamADPCM::SAMPLES_PER_BLOCK * 2],
+                       &adpcm[3 * StreamADPCM::ONE_BLOCK_SIZE], NUM_BLOCKS - 3);
+
+  EXPECT_EQ(expected, actual);
+}
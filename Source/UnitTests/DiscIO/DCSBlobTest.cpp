@@ -0,0 +1,249 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/DCSBlob.h"
+
+namespace
+{
+constexpr int CHUNK_SIZE = 0x8000;
+
+u32 s_next_seed = 0;
+
+class DCSBlobTest : public testing::Test
+{
+protected:
+  DCSBlobTest()
+      : m_directory(File::CreateTempDir()), m_store_path(m_directory + "/store"),
+        m_index_path(m_store_path + "/index.bin"), m_chunks_path(m_store_path + "/chunks.bin")
+  {
+  }
+
+  ~DCSBlobTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void SetUp() override
+  {
+    if (m_directory.empty())
+      FAIL();
+  }
+
+  // Decoded chunks are cached for the whole process by hash, so every test uses its own data (and
+  // seed) to make sure that the chunks are really read from the store.
+  std::vector<u8> RandomChunk()
+  {
+    std::vector<u8> chunk(CHUNK_SIZE);
+    for (u8& byte : chunk)
+      byte = static_cast<u8>(m_rng());
+    return chunk;
+  }
+
+  static void Append(std::vector<u8>* data, const std::vector<u8>& chunk)
+  {
+    data->insert(data->end(), chunk.begin(), chunk.end());
+  }
+
+  // Writes data as a plain image and converts it into the store
+  std::string Convert(const std::string& name, const std::vector<u8>& data)
+  {
+    const std::string plain_path = m_directory + '/' + name + ".iso";
+    const std::string dcs_path = m_directory + '/' + name + ".dcs";
+    EXPECT_TRUE(File::IOFile(plain_path, "wb").WriteBytes(data.data(), data.size()));
+
+    const std::unique_ptr<DiscIO::BlobReader> plain = DiscIO::CreateBlobReader(plain_path);
+    EXPECT_NE(plain, nullptr);
+    if (!plain)
+      return dcs_path;
+
+    const auto callback = [](const std::string&, float) { return true; };
+    EXPECT_TRUE(DiscIO::ConvertToDCS(plain.get(), plain_path, dcs_path, m_store_path, CHUNK_SIZE,
+                                     5, callback, 2));
+    return dcs_path;
+  }
+
+  static std::vector<u8> ReadAll(DiscIO::BlobReader* reader)
+  {
+    std::vector<u8> data(reader->GetDataSize());
+    EXPECT_TRUE(reader->Read(0, data.size(), data.data()));
+    return data;
+  }
+
+  u64 GetNumberOfStoredChunks() const
+  {
+    return (File::GetSize(m_index_path) - sizeof(DiscIO::DCSIndexHeader)) /
+           sizeof(DiscIO::DCSIndexEntry);
+  }
+
+  std::mt19937 m_rng{s_next_seed++};
+  const std::string m_directory;
+  const std::string m_store_path;
+  const std::string m_index_path;
+  const std::string m_chunks_path;
+};
+}  // namespace
+
+TEST_F(DCSBlobTest, RoundTripStoresDuplicateChunksOnce)
+{
+  const std::vector<u8> a = RandomChunk();
+  const std::vector<u8> b = RandomChunk();
+  const std::vector<u8> zero(CHUNK_SIZE);
+
+  std::vector<u8> data;
+  Append(&data, a);
+  Append(&data, b);
+  Append(&data, a);
+  Append(&data, zero);
+  Append(&data, a);
+  // A partial last chunk
+  data.insert(data.end(), b.begin(), b.begin() + 0x1234);
+
+  const std::string dcs_path = Convert("first", data);
+  {
+    const std::unique_ptr<DiscIO::BlobReader> reader = DiscIO::CreateBlobReader(dcs_path);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->GetBlobType(), DiscIO::BlobType::DCS);
+    EXPECT_EQ(reader->GetDataSize(), data.size());
+    EXPECT_EQ(ReadAll(reader.get()), data);
+
+    // A read which spans chunks
+    std::vector<u8> middle(CHUNK_SIZE);
+    ASSERT_TRUE(reader->Read(CHUNK_SIZE / 2, middle.size(), middle.data()));
+    EXPECT_TRUE(std::equal(middle.begin(), middle.end(), data.begin() + CHUNK_SIZE / 2));
+  }
+
+  // a, b, zero and the padded last chunk
+  EXPECT_EQ(GetNumberOfStoredChunks(), 4U);
+
+  // A second image only adds the chunks that the store doesn't have yet
+  const std::vector<u8> c = RandomChunk();
+  std::vector<u8> second_data;
+  Append(&second_data, b);
+  Append(&second_data, c);
+  Append(&second_data, a);
+  const std::string second_path = Convert("second", second_data);
+  EXPECT_EQ(GetNumberOfStoredChunks(), 5U);
+
+  const std::unique_ptr<DiscIO::BlobReader> first = DiscIO::CreateBlobReader(dcs_path);
+  const std::unique_ptr<DiscIO::BlobReader> second = DiscIO::CreateBlobReader(second_path);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(ReadAll(first.get()), data);
+  EXPECT_EQ(ReadAll(second.get()), second_data);
+}
+
+TEST_F(DCSBlobTest, PartialIndexEntryIsIgnored)
+{
+  std::vector<u8> data = RandomChunk();
+  Append(&data, RandomChunk());
+  const std::string dcs_path = Convert("image", data);
+
+  // What an interrupted conversion leaves behind
+  {
+    File::IOFile index(m_index_path, "ab");
+    const u8 partial_entry[sizeof(DiscIO::DCSIndexEntry) / 2] = {0xff};
+    ASSERT_TRUE(index.WriteArray(partial_entry, sizeof(partial_entry)));
+  }
+
+  {
+    const std::unique_ptr<DiscIO::BlobReader> reader = DiscIO::CreateBlobReader(dcs_path);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(ReadAll(reader.get()), data);
+  }
+
+  // Converting into the store again drops the partial entry before appending
+  std::vector<u8> second_data = RandomChunk();
+  const std::string second_path = Convert("second", second_data);
+  EXPECT_EQ(File::GetSize(m_index_path),
+            sizeof(DiscIO::DCSIndexHeader) + 3 * sizeof(DiscIO::DCSIndexEntry));
+
+  const std::unique_ptr<DiscIO::BlobReader> reader = DiscIO::CreateBlobReader(second_path);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(ReadAll(reader.get()), second_data);
+}
+
+TEST_F(DCSBlobTest, CorruptIndexHeaderIsRejected)
+{
+  const std::string dcs_path = Convert("image", RandomChunk());
+
+  {
+    File::IOFile index(m_index_path, "r+b");
+    const u32 bad_magic = 0;
+    ASSERT_TRUE(index.WriteArray(&bad_magic, 1));
+  }
+
+  EXPECT_EQ(DiscIO::CreateBlobReader(dcs_path), nullptr);
+}
+
+TEST_F(DCSBlobTest, CorruptChunkFailsToRead)
+{
+  const std::vector<u8> data = RandomChunk();
+  const std::string dcs_path = Convert("image", data);
+
+  // Random data doesn't compress, so the chunk is stored as it is
+  ASSERT_EQ(File::GetSize(m_chunks_path), data.size());
+  {
+    File::IOFile chunks(m_chunks_path, "r+b");
+    const u8 byte = data[0x100] ^ 1;
+    ASSERT_TRUE(chunks.Seek(0x100, SEEK_SET));
+    ASSERT_TRUE(chunks.WriteArray(&byte, 1));
+  }
+
+  const std::unique_ptr<DiscIO::BlobReader> reader = DiscIO::CreateBlobReader(dcs_path);
+  ASSERT_NE(reader, nullptr);
+  std::vector<u8> buffer(data.size());
+  EXPECT_FALSE(reader->Read(0, buffer.size(), buffer.data()));
+}
+
+TEST_F(DCSBlobTest, CorruptImageHeaderIsRejected)
+{
+  std::vector<u8> data = RandomChunk();
+  Append(&data, RandomChunk());
+  const std::string dcs_path = Convert("image", data);
+  const u64 image_size = File::GetSize(dcs_path);
+
+  // The list of hashes is cut short
+  {
+    File::IOFile image(dcs_path, "r+b");
+    ASSERT_TRUE(image.Resize(image_size - 1));
+  }
+  EXPECT_EQ(DiscIO::CreateBlobReader(dcs_path), nullptr);
+
+  // The data size claims more chunks than the file has hashes for
+  {
+    File::IOFile image(dcs_path, "r+b");
+    ASSERT_TRUE(image.Resize(image_size));
+    DiscIO::DCSHeader header;
+    ASSERT_TRUE(image.ReadArray(&header, 1));
+    header.data_size = u64(1) << 60;
+    ASSERT_TRUE(image.Seek(0, SEEK_SET));
+    ASSERT_TRUE(image.WriteArray(&header, 1));
+  }
+  EXPECT_EQ(DiscIO::CreateBlobReader(dcs_path), nullptr);
+
+  // The store path runs past the end of the file
+  {
+    File::IOFile image(dcs_path, "r+b");
+    DiscIO::DCSHeader header;
+    ASSERT_TRUE(image.ReadArray(&header, 1));
+    header.data_size = data.size();
+    header.store_path_size = 0xffffffff;
+    ASSERT_TRUE(image.Seek(0, SEEK_SET));
+    ASSERT_TRUE(image.WriteArray(&header, 1));
+  }
+  EXPECT_EQ(DiscIO::CreateBlobReader(dcs_path), nullptr);
+}
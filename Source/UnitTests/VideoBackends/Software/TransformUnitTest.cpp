@@ -0,0 +1,173 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/TransformUnit.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+// Enough vertices for the four-wide paths and a scalar tail
+constexpr size_t NUM_VERTICES = 1023;
+
+class SWTransformUnitTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::memset(static_cast<void*>(&xfmem), 0, sizeof(xfmem));
+
+    for (float& value : xfmem.posMatrices)
+      value = RandomFloat();
+    for (float& value : xfmem.normalMatrices)
+      value = RandomFloat();
+    for (float& value : xfmem.projection.rawProjection)
+      value = RandomFloat();
+
+    for (Light& light : xfmem.lights)
+    {
+      for (u8& component : light.color)
+        component = RandomByte();
+      for (int i = 0; i < 3; i++)
+      {
+        light.cosatt[i] = RandomFloat();
+        light.distatt[i] = RandomFloat();
+        light.dpos[i] = RandomFloat();
+        light.ddir[i] = RandomFloat();
+      }
+    }
+    // Attenuation which divides by zero
+    for (float& value : xfmem.lights[1].distatt)
+      value = 0.0f;
+
+    for (u32 chan = 0; chan < NUM_XF_COLOR_CHANNELS; chan++)
+    {
+      xfmem.ambColor[chan] = m_rng();
+      xfmem.matColor[chan] = m_rng();
+    }
+
+    m_input.resize(NUM_VERTICES);
+    for (size_t i = 0; i < NUM_VERTICES; i++)
+    {
+      InputVertexData& vertex = m_input[i];
+      // Long runs of vertices sharing a matrix, with the occasional odd one out
+      vertex.posMtx = (i / 64 % 20) * 3;
+      if (i % 37 == 0)
+        vertex.posMtx = RandomByte() % 20 * 3;
+
+      vertex.position = RandomVec3();
+      for (Vec3& normal : vertex.normal)
+        normal = RandomVec3();
+      for (auto& color : vertex.color)
+      {
+        for (u8& component : color)
+          component = RandomByte();
+      }
+    }
+
+    // Vertices which end up in the special cases: zero normals, huge positions and a vertex at
+    // the position of the light (giving a zero light direction).
+    m_input[5].normal[0] = Vec3(0.0f);
+    m_input[6].position = Vec3(std::numeric_limits<float>::max());
+    m_input[7].posMtx = 0;
+    m_input[7].position = Vec3(0.0f);
+    for (int i = 0; i < 12; i++)
+      xfmem.posMatrices[i] = 0.0f;
+    xfmem.posMatrices[3] = xfmem.lights[0].dpos[0];
+    xfmem.posMatrices[7] = xfmem.lights[0].dpos[1];
+    xfmem.posMatrices[11] = xfmem.lights[0].dpos[2];
+  }
+
+  float RandomFloat() { return std::uniform_real_distribution<float>(-4.0f, 4.0f)(m_rng); }
+  Vec3 RandomVec3() { return Vec3(RandomFloat(), RandomFloat(), RandomFloat()); }
+  u8 RandomByte() { return static_cast<u8>(m_rng()); }
+
+  // The scalar per-vertex functions are the reference for the batched ones
+  std::vector<OutputVertexData> TransformScalar(bool nbt, bool color)
+  {
+    std::vector<OutputVertexData> output(NUM_VERTICES);
+    for (size_t i = 0; i < NUM_VERTICES; i++)
+    {
+      TransformUnit::TransformPosition(&m_input[i], &output[i]);
+      TransformUnit::TransformNormal(&m_input[i], nbt, &output[i]);
+      if (color)
+        TransformUnit::TransformColor(&m_input[i], &output[i]);
+    }
+    return output;
+  }
+
+  std::vector<OutputVertexData> TransformBatched(bool nbt, bool color)
+  {
+    std::vector<OutputVertexData> output(NUM_VERTICES);
+    TransformUnit::TransformPositions(m_input.data(), output.data(), NUM_VERTICES);
+    TransformUnit::TransformNormals(m_input.data(), nbt, output.data(), NUM_VERTICES);
+    if (color)
+      TransformUnit::TransformColors(m_input.data(), output.data(), NUM_VERTICES);
+    return output;
+  }
+
+  static void ExpectBitIdentical(const std::vector<OutputVertexData>& expected,
+                                 const std::vector<OutputVertexData>& actual)
+  {
+    const auto same = [](const auto& a, const auto& b) {
+      return std::memcmp(&a, &b, sizeof(a)) == 0;
+    };
+
+    for (size_t i = 0; i < NUM_VERTICES; i++)
+    {
+      ASSERT_TRUE(same(expected[i].mvPosition, actual[i].mvPosition)) << "vertex " << i;
+      ASSERT_TRUE(same(expected[i].projectedPosition, actual[i].projectedPosition))
+          << "vertex " << i;
+      ASSERT_TRUE(same(expected[i].normal, actual[i].normal)) << "vertex " << i;
+      ASSERT_TRUE(same(expected[i].color, actual[i].color)) << "vertex " << i;
+    }
+  }
+
+  std::mt19937 m_rng{1};
+  std::vector<InputVertexData> m_input;
+};
+}  // namespace
+
+TEST_F(SWTransformUnitTest, PositionsAndNormalsMatchScalar)
+{
+  for (ProjectionType type : {ProjectionType::Perspective, ProjectionType::Orthographic})
+  {
+    xfmem.projection.type = type;
+    for (bool nbt : {false, true})
+      ExpectBitIdentical(TransformScalar(nbt, false), TransformBatched(nbt, false));
+  }
+}
+
+TEST_F(SWTransformUnitTest, LightingMatchesScalar)
+{
+  xfmem.projection.type = ProjectionType::Perspective;
+
+  for (u32 attnfunc = 0; attnfunc < 4; attnfunc++)
+  {
+    for (u32 diffusefunc = 0; diffusefunc < 3; diffusefunc++)
+    {
+      for (u32 chan = 0; chan < NUM_XF_COLOR_CHANNELS; chan++)
+      {
+        for (LitChannel* lit_channel : {&xfmem.color[chan], &xfmem.alpha[chan]})
+        {
+          lit_channel->hex = m_rng();
+          lit_channel->enablelighting = true;
+          lit_channel->attnfunc = static_cast<AttenuationFunc>(attnfunc);
+          lit_channel->diffusefunc = static_cast<DiffuseFunc>(diffusefunc);
+        }
+      }
+      // Channel 1 covers disabled lighting for the color part
+      xfmem.color[1].enablelighting = attnfunc != 0;
+
+      ExpectBitIdentical(TransformScalar(false, true), TransformBatched(false, true));
+    }
+  }
+}